@@ -2,55 +2,262 @@
 // Bridge between Web Interface and Sensor/Tracker Modules
 
 #include "api.h"
+#include "cmd_pipeline.h"
+#include "cmd_scheduler.h"
+#include "cloud_voxel.h"
+#include "point_cluster.h"
+#include "kalman_tracker.h"
+#include "trajectory_store.h"
+#include "occupancy_map.h"
+#include "zone_engine.h"
+#include "tripwire.h"
+#include "presence_fsm.h"
+#include "frame_ring.h"
+#include "event_bus.h"
+#include "device_state.h"
+#include "config_store.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <string.h>
 
 static const char *TAG = "API";
 
-// ========== INITIALIZATION ==========
+// Point cloud consumers - the sensor streams 0x0A08 while either is active
+static bool g_cloud_streaming = false;  // Web viewer requested the raw cloud
 
-esp_err_t api_init(void) {
-    ESP_LOGI(TAG, "API layer initialized");
-    return ESP_OK;
-}
+// Raw frames vs. messages actually broadcast
+static uint32_t g_target_frames = 0;
+static uint32_t g_target_messages = 0;
+static bool g_targets_idle = false;      // Last broadcast was an empty target list
+static uint32_t g_presence_frames = 0;
+static uint32_t g_presence_messages = 0;
 
-// ========== SENSOR CALLBACKS ==========
+// Web commands drained from the web server queue
+static uint32_t g_web_commands = 0;
+static uint32_t g_web_queue_max = 0;     // Deepest the queue was when drained
 
-void api_on_target_detected(const hlk_target_t* targets, int32_t count) {
+// Task draining the frame ring (set on its first api_process_frames() call)
+static TaskHandle_t g_publish_task = NULL;
+
+// Cloud viewer queue: two full clouds plus ring buffer item headers
+#define API_CLOUD_VIEW_QUEUE_BYTES (2 * (sizeof(hlk_point_cloud_t) + sizeof(event_t) + 8))
+
+// Packed point cloud record: cluster index plus x, y, z, speed per point
+#define CLOUD_RECORD_POINT_BYTES (sizeof(int32_t) + 4 * sizeof(hlk_coord_t))
+
+// ========== SUBSCRIBERS (publish task / worker tasks) ==========
+// Every consumer of decoded frames is an event bus subscriber
+
+// Live view: debounced "anyone there", arrival/departure logging and SSE targets
+static void on_targets_live(const event_t* event, void* ctx) {
+    const hlk_target_t *targets = event->data;
+    int32_t count = event->count;
+    
+    // Debounced "anyone there" - arrivals and departures follow this, not single frames
+    presence_fsm_update(PRESENCE_FSM_PERSON, count > 0, xTaskGetTickCount() * portTICK_PERIOD_MS);
+    
     // Update target tracker (handles logging and state management)
     target_tracker_update(targets, count);
     
-    // Broadcast to web clients
-    web_server_send_targets(targets, count);
+    // Broadcast to web clients; a run of empty frames is sent once
+    g_target_frames++;
+    if (count > 0 || !g_targets_idle) {
+        web_server_send_targets(targets, count);
+        g_target_messages++;
+    }
+    g_targets_idle = (count == 0);
 }
 
-void api_on_presence_detected(uint32_t zone0, uint32_t zone1, uint32_t zone2, uint32_t zone3) {
+// People counting on the virtual tripwires (needs stable track IDs)
+static void on_targets_tripwire(const event_t* event, void* ctx) {
+    if (!event->aux) return;
+    
+    tripwire_event_t events[TRIPWIRE_MAX_LINES];
+    int crossings = tripwire_update(event->data, event->count, events, TRIPWIRE_MAX_LINES);
+    if (crossings == 0) return;
+    
+    // Events carry the line name, so a concurrent tripwire_set_lines() cannot
+    // leave them pointing at a line that is gone
+    for (int i = 0; i < crossings && i < TRIPWIRE_MAX_LINES; i++) {
+        const tripwire_event_t *e = &events[i];
+        ESP_LOGI(TAG, "🚪 Track %u crossed '%s' %s (in %lu, out %lu)", e->track_id,
+                 e->name, e->in ? "in" : "out", e->in_count, e->out_count);
+        web_server_send_tripwire(e);
+    }
+}
+
+// Per-zone person counts for the user-defined polygon zones
+static void on_targets_zones(const event_t* event, void* ctx) {
+    if (zone_engine_evaluate(event->data, event->count)) {
+        uint16_t counts[ZONE_ENGINE_MAX_ZONES];
+        int zones = zone_engine_get_counts(counts, ZONE_ENGINE_MAX_ZONES);
+        web_server_send_zone_counts(counts, zones);
+    }
+}
+
+// Keep recent trails on the device for GET /trajectories
+static void on_targets_trajectory(const event_t* event, void* ctx) {
+    if (event->aux) {
+        trajectory_store_update(event->data, event->count);
+    }
+}
+
+// Accumulate where people spend time (GET /heatmap)
+static void on_targets_heatmap(const event_t* event, void* ctx) {
+    occupancy_map_update(event->data, event->count);
+}
+
+static void on_presence(const event_t* event, void* ctx) {
+    const uint32_t *raw = event->data;
+    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    
+    // Debounce every zone; only transitions go out
+    bool changed = false;
+    uint32_t zones[HLK_ZONE_COUNT];
+    for (int i = 0; i < HLK_ZONE_COUNT; i++) {
+        changed |= presence_fsm_update(i, raw[i] != 0, now);
+        zones[i] = presence_fsm_is_present(i);
+    }
+    
     // Update zone tracker (handles logging and state management)
-    zone_tracker_update(zone0, zone1, zone2, zone3);
+    zone_tracker_update(zones[0], zones[1], zones[2], zones[3]);
     
     // Broadcast to web clients
-    web_server_send_presence(zone0, zone1, zone2, zone3);
+    g_presence_frames++;
+    if (changed) {
+        web_server_send_presence(zones[0], zones[1], zones[2], zones[3]);
+        g_presence_messages++;
+    }
 }
 
-void api_on_zones_received(const hlk_zone_t* zones, bool is_interference) {
-    // Convert sensor format to web format
-    zone_bounds_t web_zones[4];
-    for (int i = 0; i < 4; i++) {
-        web_zones[i].x_min = zones[i].x_min;
-        web_zones[i].x_max = zones[i].x_max;
-        web_zones[i].y_min = zones[i].y_min;
-        web_zones[i].y_max = zones[i].y_max;
-        web_zones[i].z_min = zones[i].z_min;
-        web_zones[i].z_max = zones[i].z_max;
+static void on_zones(const event_t* event, void* ctx) {
+    const hlk_zone_t *zones = event->data;
+    
+    // Convert into web format
+    zone_bounds_t web_zones[HLK_ZONE_COUNT];
+    for (int i = 0; i < HLK_ZONE_COUNT; i++) {
+        web_zones[i].x_min = HLK_COORD_TO_M(zones[i].x_min);
+        web_zones[i].x_max = HLK_COORD_TO_M(zones[i].x_max);
+        web_zones[i].y_min = HLK_COORD_TO_M(zones[i].y_min);
+        web_zones[i].y_max = HLK_COORD_TO_M(zones[i].y_max);
+        web_zones[i].z_min = HLK_COORD_TO_M(zones[i].z_min);
+        web_zones[i].z_max = HLK_COORD_TO_M(zones[i].z_max);
     }
     
     // Broadcast to web clients
-    web_server_send_zones(web_zones, is_interference);
+    web_server_send_zones(web_zones, event->aux != 0);
 }
 
-void api_on_config_received(uint16_t msg_type, const uint8_t* data, uint16_t len) {
-    if (len < 1) return;
+// Settings and zone reports into the state cache - ahead of every other
+// subscriber, so the config SSE and GET /state already see the new value
+static void on_state(const event_t* event, void* ctx) {
+    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    if (event->type == EVENT_ZONES) {
+        device_state_set_zones(event->data, event->aux != 0, now);
+    } else {
+        device_state_on_report(event->aux, event->data, event->len, now);
+    }
+}
+
+// Cloud viewer - voxel reduction and JSON run on its own task
+static void on_cloud_view(const event_t* event, void* ctx) {
+    // Nobody watching - skip the reduction work
+    if (!g_cloud_streaming || web_server_get_client_count() == 0) return;
+    
+    // Downsample and quantize before serializing
+    web_server_send_point_cloud(cloud_voxel_process(event->data));
+}
+
+static void on_config(const event_t* event, void* ctx);
+
+static const event_subscriber_t g_subscribers[] = {
+    // name          events                        priority  queue   handler  ctx
+    { "state",       EVENT_MASK(EVENT_CONFIG) | EVENT_MASK(EVENT_ZONES), 110, 0, on_state, NULL },
+    { "live",        EVENT_MASK(EVENT_TARGETS),      100,     0,    on_targets_live, NULL },
+    { "presence",    EVENT_MASK(EVENT_PRESENCE),     100,     0,    on_presence, NULL },
+    { "config",      EVENT_MASK(EVENT_CONFIG),       100,     0,    on_config, NULL },
+    { "zones",       EVENT_MASK(EVENT_ZONES),         90,     0,    on_zones, NULL },
+    { "tripwire",    EVENT_MASK(EVENT_TARGETS),       80,     0,    on_targets_tripwire, NULL },
+    { "zone_engine", EVENT_MASK(EVENT_TARGETS),       70,     0,    on_targets_zones, NULL },
+    { "trajectory",  EVENT_MASK(EVENT_TARGETS),       50,     0,    on_targets_trajectory, NULL },
+    { "heatmap",     EVENT_MASK(EVENT_TARGETS),       40,     0,    on_targets_heatmap, NULL },
+    { "cloud_view",  EVENT_MASK(EVENT_POINT_CLOUD),   10,  API_CLOUD_VIEW_QUEUE_BYTES, on_cloud_view, NULL },
+};
+static const size_t g_subscriber_count = sizeof(g_subscribers) / sizeof(g_subscribers[0]);
+
+// ========== INITIALIZATION ==========
+
+esp_err_t api_init(void) {
+    frame_ring_init();
+    
+    // Consumers of decoded frames
+    event_bus_init();
+    for (size_t i = 0; i < g_subscriber_count; i++) {
+        esp_err_t err = event_bus_subscribe(&g_subscribers[i]);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    
+    ESP_LOGI(TAG, "API layer initialized (%d byte frame ring, %d subscribers)",
+             FRAME_RING_SIZE, (int)g_subscriber_count);
+    return ESP_OK;
+}
+
+// ========== PUBLISHING (publish task) ==========
+
+static void publish_targets(const hlk_target_t* targets, int32_t count) {
+    static hlk_target_t tracked[KALMAN_MAX_TRACKS];
+    bool is_tracked = kalman_tracker_is_enabled();
+    
+    // Replace raw detections with smoothed, stably-numbered tracks
+    if (is_tracked) {
+        count = kalman_tracker_update(targets, count, tracked);
+        targets = tracked;
+    }
+    
+    event_t event = {
+        .type = EVENT_TARGETS,
+        .aux = is_tracked,
+        .count = count,
+        .len = count * sizeof(hlk_target_t),
+        .data = targets
+    };
+    event_bus_publish(&event);
+}
+
+static void publish_point_cloud(const hlk_point_cloud_t* cloud) {
+    // Clustered targets replace the sensor's list while clustering is on
+    if (point_cluster_is_enabled()) {
+        hlk_target_t targets[POINT_CLUSTER_MAX_TARGETS];
+        int32_t count = point_cluster_process(cloud, targets);
+        publish_targets(targets, count);
+    }
+    
+    event_t event = {
+        .type = EVENT_POINT_CLOUD,
+        .count = cloud->count,
+        .len = sizeof(*cloud),
+        .data = cloud
+    };
+    event_bus_publish(&event);
+}
+
+// Push the cached radar settings to web clients (255 = not reported yet)
+static void send_config_state(void) {
+    device_state_t state;
+    device_state_get(&state);
+    web_server_send_config(
+        state.meta[DEVICE_STATE_SENSITIVITY].known ? state.sensitivity : 255,
+        state.meta[DEVICE_STATE_TRIGGER_SPEED].known ? state.trigger_speed : 255,
+        state.meta[DEVICE_STATE_INSTALL_METHOD].known ? state.install_method : 255);
+}
+
+static void on_config(const event_t* event, void* ctx) {
+    uint16_t msg_type = event->aux;
+    const uint8_t *data = event->data;
+    uint16_t len = event->len;
     
     switch (msg_type) {
         case MSG_IND_HUMAN_DETECTION_3D_PWM_DELAY:
@@ -63,13 +270,13 @@ void api_on_config_received(uint16_t msg_type, const uint8_t* data, uint16_t len
         case MSG_IND_HUMAN_DETECTION_3D_DETECT_SENSITIVITY:
             ESP_LOGI(TAG, "🎚️  Sensitivity: %s (%d)",
                      hlk_sensitivity_to_string(data[0]), data[0]);
-            web_server_send_config(data[0], 255, 255);  // 255 = unchanged
+            send_config_state();
             break;
             
         case MSG_IND_HUMAN_DETECTION_3D_DETECT_TRIGGER:
             ESP_LOGI(TAG, "⚡ Trigger Speed: %s (%d)",
                      hlk_trigger_speed_to_string(data[0]), data[0]);
-            web_server_send_config(255, data[0], 255);  // 255 = unchanged
+            send_config_state();
             break;
             
         case MSG_IND_HUMAN_DETECTION_3D_Z_RANGE:
@@ -85,7 +292,7 @@ void api_on_config_received(uint16_t msg_type, const uint8_t* data, uint16_t len
         case MSG_IND_HUMAN_DETECTION_3D_INSTALL_SITE:
             ESP_LOGI(TAG, "🔧 Installation: %s (%d)",
                      hlk_install_method_to_string(data[0]), data[0]);
-            web_server_send_config(255, 255, data[0]);  // 255 = unchanged
+            send_config_state();
             break;
             
         case MSG_IND_HUMAN_DETECTION_3D_LOW_POWER_MODE:
@@ -114,67 +321,228 @@ void api_on_config_received(uint16_t msg_type, const uint8_t* data, uint16_t len
     }
 }
 
-// ========== COMMAND PROCESSING ==========
-
-void api_process_web_commands(void) {
-    QueueHandle_t cmd_queue = web_server_get_cmd_queue();
-    if (!cmd_queue) return;
-    
-    radar_cmd_t cmd;
-    if (xQueueReceive(cmd_queue, &cmd, 0) == pdTRUE) {
-        ESP_LOGI(TAG, "Processing web command: type=%d param=%d", cmd.type, cmd.param);
-        
-        switch (cmd.type) {
-            case RADAR_CMD_SET_SENSITIVITY:
-                if (cmd.param == 0) {
-                    hlk_ld6002_send_command(CMD_SET_SENSITIVITY_LOW);
-                } else if (cmd.param == 1) {
-                    hlk_ld6002_send_command(CMD_SET_SENSITIVITY_MEDIUM);
-                } else if (cmd.param == 2) {
-                    hlk_ld6002_send_command(CMD_SET_SENSITIVITY_HIGH);
-                }
-                vTaskDelay(pdMS_TO_TICKS(200));
-                hlk_ld6002_send_command(CMD_GET_SENSITIVITY);
-                break;
-                
-            case RADAR_CMD_SET_TRIGGER_SPEED:
-                if (cmd.param == 0) {
-                    hlk_ld6002_send_command(CMD_SET_TRIGGER_SPEED_SLOW);
-                } else if (cmd.param == 1) {
-                    hlk_ld6002_send_command(CMD_SET_TRIGGER_SPEED_MEDIUM);
-                } else if (cmd.param == 2) {
-                    hlk_ld6002_send_command(CMD_SET_TRIGGER_SPEED_FAST);
+void api_process_frames(uint32_t timeout_ms) {
+    static hlk_point_cloud_t cloud;  // Unpacked cloud record (kept off the task stack)
+    
+    g_publish_task = xTaskGetCurrentTaskHandle();
+    
+    const frame_record_t *record;
+    while ((record = frame_ring_peek()) != NULL) {
+        switch (record->type) {
+            case FRAME_RECORD_TARGETS:
+                // Clustered targets replace the sensor's list while clustering is on
+                if (!point_cluster_is_enabled()) {
+                    publish_targets((const hlk_target_t *)record->payload,
+                                    record->len / sizeof(hlk_target_t));
                 }
-                vTaskDelay(pdMS_TO_TICKS(200));
-                hlk_ld6002_send_command(CMD_GET_TRIGGER_SPEED);
                 break;
                 
-            case RADAR_CMD_CLEAR_INTERFERENCE_ZONE:
-                hlk_ld6002_send_command(CMD_CLEAR_INTERFERENCE_ZONE);
-                vTaskDelay(pdMS_TO_TICKS(200));
-                hlk_ld6002_send_command(CMD_GET_ZONES);
-                break;
-                
-            case RADAR_CMD_RESET_DETECTION_ZONE:
-                hlk_ld6002_send_command(CMD_RESET_DETECTION_ZONE);
-                vTaskDelay(pdMS_TO_TICKS(200));
-                hlk_ld6002_send_command(CMD_GET_ZONES);
-                break;
-                
-            case RADAR_CMD_AUTO_GEN_INTERFERENCE_ZONE:
-                hlk_ld6002_send_command(CMD_AUTO_GEN_INTERFERENCE_ZONE);
-                ESP_LOGI(TAG, "Auto-generating interference zones (30-60s)...");
+            case FRAME_RECORD_PRESENCE:
+            case FRAME_RECORD_ZONES:
+            case FRAME_RECORD_CONFIG: {
+                // Payload is already in event form
+                event_t event = {
+                    .type = record->type == FRAME_RECORD_PRESENCE ? EVENT_PRESENCE :
+                            record->type == FRAME_RECORD_ZONES ? EVENT_ZONES : EVENT_CONFIG,
+                    .aux = record->aux,
+                    .count = record->type == FRAME_RECORD_CONFIG ? record->len : HLK_ZONE_COUNT,
+                    .len = record->len,
+                    .data = record->payload
+                };
+                event_bus_publish(&event);
                 break;
+            }
                 
-            case RADAR_CMD_GET_ZONES:
-                hlk_ld6002_send_command(CMD_GET_ZONES);
+            case FRAME_RECORD_CLOUD: {
+                int32_t n = record->len / CLOUD_RECORD_POINT_BYTES;
+                const int32_t *cluster = (const int32_t *)record->payload;
+                const hlk_coord_t *coords = (const hlk_coord_t *)&cluster[n];
+                cloud.count = n;
+                memcpy(cloud.cluster, cluster, n * sizeof(int32_t));
+                memcpy(cloud.x, &coords[0], n * sizeof(hlk_coord_t));
+                memcpy(cloud.y, &coords[n], n * sizeof(hlk_coord_t));
+                memcpy(cloud.z, &coords[2 * n], n * sizeof(hlk_coord_t));
+                memcpy(cloud.speed, &coords[3 * n], n * sizeof(hlk_coord_t));
+                publish_point_cloud(&cloud);
                 break;
+            }
                 
             default:
-                ESP_LOGW(TAG, "Unknown command type: %d", cmd.type);
                 break;
         }
+        frame_ring_release();
+    }
+    
+    // Sleep until the sensor task queues more
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms));
+}
+
+// ========== SENSOR CALLBACKS (sensor task) ==========
+// Copy the frame into the ring and return - no JSON, logging or locks here
+
+static void frame_ready(frame_record_type_t type, uint16_t aux) {
+    frame_ring_commit(type, aux);
+    TaskHandle_t publisher = g_publish_task;
+    if (publisher) xTaskNotifyGive(publisher);
+}
+
+void api_on_target_detected(const hlk_target_t* targets, int32_t count) {
+    // Clustered targets replace the sensor's list while clustering is on
+    if (point_cluster_is_enabled()) return;
+    
+    uint32_t len = count * sizeof(hlk_target_t);
+    void *dst = frame_ring_reserve(len);
+    if (!dst) return;
+    if (len) memcpy(dst, targets, len);
+    frame_ready(FRAME_RECORD_TARGETS, 0);
+}
+
+void api_on_presence_detected(uint32_t zone0, uint32_t zone1, uint32_t zone2, uint32_t zone3) {
+    uint32_t *dst = frame_ring_reserve(HLK_ZONE_COUNT * sizeof(uint32_t));
+    if (!dst) return;
+    dst[0] = zone0;
+    dst[1] = zone1;
+    dst[2] = zone2;
+    dst[3] = zone3;
+    frame_ready(FRAME_RECORD_PRESENCE, 0);
+}
+
+void api_on_zones_received(const hlk_zone_t* zones, bool is_interference) {
+    void *dst = frame_ring_reserve(HLK_ZONE_COUNT * sizeof(hlk_zone_t));
+    if (!dst) return;
+    memcpy(dst, zones, HLK_ZONE_COUNT * sizeof(hlk_zone_t));
+    frame_ready(FRAME_RECORD_ZONES, is_interference);
+}
+
+void api_on_point_cloud(const hlk_point_cloud_t* cloud) {
+    // Neither clustering nor a viewer needs it
+    if (!point_cluster_is_enabled() && (!g_cloud_streaming || web_server_get_client_count() == 0)) return;
+    
+    // Pack only the decoded points: cluster[n], x[n], y[n], z[n], speed[n]
+    int32_t n = cloud->count;
+    uint8_t *dst = frame_ring_reserve(n * CLOUD_RECORD_POINT_BYTES);
+    if (!dst) return;
+    int32_t *cluster = (int32_t *)dst;
+    hlk_coord_t *coords = (hlk_coord_t *)&cluster[n];
+    memcpy(cluster, cloud->cluster, n * sizeof(int32_t));
+    memcpy(&coords[0], cloud->x, n * sizeof(hlk_coord_t));
+    memcpy(&coords[n], cloud->y, n * sizeof(hlk_coord_t));
+    memcpy(&coords[2 * n], cloud->z, n * sizeof(hlk_coord_t));
+    memcpy(&coords[3 * n], cloud->speed, n * sizeof(hlk_coord_t));
+    frame_ready(FRAME_RECORD_CLOUD, 0);
+}
+
+void api_on_config_received(uint16_t msg_type, const uint8_t* data, uint16_t len) {
+    if (len < 1) return;
+    
+    void *dst = frame_ring_reserve(len);
+    if (!dst) return;
+    memcpy(dst, data, len);
+    frame_ready(FRAME_RECORD_CONFIG, msg_type);
+}
+
+// ========== COMMAND PROCESSING ==========
+
+// Keep the sensor's point cloud output on while anything consumes it
+static void update_point_cloud_output(void) {
+    bool enable = g_cloud_streaming || point_cluster_is_enabled();
+    cmd_scheduler_post(enable ? CMD_ENABLE_POINT_CLOUD : CMD_DISABLE_POINT_CLOUD,
+                       CMD_SCHEDULER_COALESCE_MS);
+}
+
+// Radar setting change: held briefly so a burst collapses to its last value,
+// then read back once the radar has applied it
+static void schedule_set(uint32_t set_cmd, uint32_t get_cmd) {
+    cmd_scheduler_post(set_cmd, CMD_SCHEDULER_COALESCE_MS);
+    cmd_scheduler_post(get_cmd, CMD_SCHEDULER_COALESCE_MS + CMD_SCHEDULER_SETTLE_MS);
+}
+
+static void handle_web_command(const radar_cmd_t* cmd) {
+    static const uint32_t sensitivity[] = {
+        CMD_SET_SENSITIVITY_LOW, CMD_SET_SENSITIVITY_MEDIUM, CMD_SET_SENSITIVITY_HIGH
+    };
+    static const uint32_t trigger_speed[] = {
+        CMD_SET_TRIGGER_SPEED_SLOW, CMD_SET_TRIGGER_SPEED_MEDIUM, CMD_SET_TRIGGER_SPEED_FAST
+    };
+    
+    ESP_LOGI(TAG, "Processing web command: type=%d param=%d", cmd->type, cmd->param);
+    
+    switch (cmd->type) {
+        case RADAR_CMD_SET_SENSITIVITY:
+            if (cmd->param <= 2) {
+                schedule_set(sensitivity[cmd->param], CMD_GET_SENSITIVITY);
+            }
+            break;
+            
+        case RADAR_CMD_SET_TRIGGER_SPEED:
+            if (cmd->param <= 2) {
+                schedule_set(trigger_speed[cmd->param], CMD_GET_TRIGGER_SPEED);
+            }
+            break;
+            
+        case RADAR_CMD_CLEAR_INTERFERENCE_ZONE:
+            cmd_scheduler_post(CMD_CLEAR_INTERFERENCE_ZONE, 0);
+            cmd_scheduler_post(CMD_GET_ZONES, CMD_SCHEDULER_SETTLE_MS);
+            break;
+            
+        case RADAR_CMD_RESET_DETECTION_ZONE:
+            cmd_scheduler_post(CMD_RESET_DETECTION_ZONE, 0);
+            cmd_scheduler_post(CMD_GET_ZONES, CMD_SCHEDULER_SETTLE_MS);
+            break;
+            
+        case RADAR_CMD_AUTO_GEN_INTERFERENCE_ZONE:
+            cmd_scheduler_post(CMD_AUTO_GEN_INTERFERENCE_ZONE, 0);
+            ESP_LOGI(TAG, "Auto-generating interference zones (30-60s)...");
+            break;
+            
+        case RADAR_CMD_GET_ZONES:
+            cmd_scheduler_post(CMD_GET_ZONES, 0);
+            break;
+            
+        case RADAR_CMD_SET_VOXEL_SIZE:
+            cloud_voxel_set_size(cmd->param * 10);  // cm → mm
+            break;
+            
+        case RADAR_CMD_SET_POINT_CLOUD:
+            g_cloud_streaming = cmd->param;
+            update_point_cloud_output();
+            ESP_LOGI(TAG, "☁️  Point cloud streaming %s", cmd->param ? "enabled" : "disabled");
+            break;
+            
+        case RADAR_CMD_SET_CLUSTERING:
+            point_cluster_set_enabled(cmd->param);
+            update_point_cloud_output();
+            break;
+            
+        case RADAR_CMD_SET_TRACKING:
+            kalman_tracker_set_enabled(cmd->param);
+            break;
+            
+        default:
+            ESP_LOGW(TAG, "Unknown command type: %d", cmd->type);
+            break;
+    }
+}
+
+void api_process_web_commands(void) {
+    QueueHandle_t cmd_queue = web_server_get_cmd_queue();
+    
+    // Drain everything queued - radar commands only go to the scheduler, so
+    // this never waits and the UART is read again straight after
+    if (cmd_queue) {
+        UBaseType_t waiting = uxQueueMessagesWaiting(cmd_queue);
+        if (waiting > g_web_queue_max) {
+            g_web_queue_max = waiting;
+        }
+        
+        radar_cmd_t cmd;
+        while (xQueueReceive(cmd_queue, &cmd, 0) == pdTRUE) {
+            g_web_commands++;
+            handle_web_command(&cmd);
+        }
     }
+    
+    cmd_scheduler_poll();
 }
 
 // ========== STATISTICS ==========
@@ -190,6 +558,139 @@ void api_log_stats(void) {
         ESP_LOGI(TAG, "📊 Sensor: %lu frames (%lu target, %lu presence)",
                  total, target, presence);
         
+        frame_ring_stats_t ring;
+        frame_ring_get_stats(&ring);
+        ESP_LOGI(TAG, "📊 Frame ring: %lu queued, %lu published, %lu dropped (%lu bytes), peak %lu/%lu bytes",
+                 ring.pushed, ring.popped, ring.dropped, ring.dropped_bytes, ring.high_water, ring.size);
+        
+        hlk_parser_stats_t parser;
+        hlk_ld6002_get_parser_stats(&parser);
+        ESP_LOGI(TAG, "📊 Parser: %lu bytes in %lu reads (max %lu/call), %lu rejected",
+                 parser.rx_bytes, parser.rx_reads, parser.max_bytes_per_call,
+                 parser.rejected_frames);
+        ESP_LOGI(TAG, "📊 Parser errors: %lu header cksum, %lu data cksum, %lu oversize, %lu resynced",
+                 parser.header_cksum_errors, parser.data_cksum_errors,
+                 parser.oversize_frames, parser.resyncs);
+        ESP_LOGI(TAG, "📊 UART: %lu wakeups for %lu frames, %lu idle timeouts, %lu overflows",
+                 parser.wakeups, parser.frames, parser.wait_timeouts, parser.rx_overflows);
+        ESP_LOGI(TAG, "📊 Targets: %lu reports truncated (%lu targets over %d), %lu malformed",
+                 parser.truncated_frames, parser.truncated_targets, HLK_MAX_TARGETS,
+                 parser.malformed_targets);
+        ESP_LOGI(TAG, "📊 Parser CPU: %lu cycles/frame (%s coordinates)",
+                 parser.frames ? (uint32_t)(parser.dispatch_cycles / parser.frames) : 0,
+                 HLK_FIXED_POINT ? "fixed-point" : "float");
+        
+        event_bus_stats_t subs[EVENT_BUS_MAX_SUBSCRIBERS];
+        int sub_count = event_bus_get_stats(subs, EVENT_BUS_MAX_SUBSCRIBERS);
+        for (int i = 0; i < sub_count; i++) {
+            const event_bus_stats_t *sub = &subs[i];
+            if (sub->delivered == 0) continue;
+            ESP_LOGI(TAG, "📊 Subscriber %-11s (%s) %lu events, avg %lu us, max %lu us, %lu us total",
+                     sub->name, sub->queued ? "queued" : "inline", sub->handled,
+                     sub->handled ? sub->total_us / sub->handled : 0, sub->max_us, sub->total_us);
+            if (sub->dropped > 0) {
+                ESP_LOGW(TAG, "⚠️  Subscriber %s dropped %lu of %lu events (queue full)",
+                         sub->name, sub->dropped, sub->delivered);
+            }
+        }
+        
+        cmd_pipeline_stats_t pipe;
+        cmd_pipeline_get_stats(&pipe);
+        ESP_LOGI(TAG, "📊 Commands: %lu/%lu answered (%lu-%lu ms, avg %lu ms), %lu retries, %lu failed, %lu unmatched / %lu stale ACKs",
+                 pipe.completed, pipe.submitted, pipe.min_latency_ms, pipe.max_latency_ms,
+                 pipe.completed ? pipe.total_latency_ms / pipe.completed : 0,
+                 pipe.retries, pipe.failed, pipe.unmatched_acks, pipe.stale_acks);
+        
+        cmd_scheduler_stats_t sched;
+        cmd_scheduler_get_stats(&sched);
+        ESP_LOGI(TAG, "📊 Scheduler: %lu web commands (queue peak %lu), %lu posted, %lu coalesced, %lu sent, %lu rejected, depth %lu (peak %lu)",
+                 g_web_commands, g_web_queue_max, sched.posted, sched.coalesced, sched.submitted,
+                 sched.rejected, sched.depth, sched.max_depth);
+        ESP_LOGI(TAG, "📊 UART: longest gap between reads %lu ms", parser.max_read_gap_ms);
+        
+        config_store_stats_t store;
+        config_store_get_stats(&store);
+        ESP_LOGI(TAG, "📊 Config store: %lu changes, %lu NVS writes, %lu unchanged, %lu errors - ready %lu ms after boot (%lu restored)",
+                 store.changes, store.writes, store.skipped, store.errors, store.ready_ms, store.restored);
+        
+        cloud_voxel_stats_t voxel;
+        cloud_voxel_get_stats(&voxel);
+        if (voxel.frames > 0) {
+            ESP_LOGI(TAG, "📊 Cloud: %lu frames, %lu → %lu points (%lu mm voxels), %lu bytes saved (%lu%%)",
+                     voxel.frames, voxel.points_in, voxel.points_out, (uint32_t)cloud_voxel_get_size(),
+                     voxel.bytes_in - voxel.bytes_out,
+                     voxel.bytes_in ? 100 * (voxel.bytes_in - voxel.bytes_out) / voxel.bytes_in : 0);
+        }
+        
+        point_cluster_stats_t cluster;
+        point_cluster_get_stats(&cluster);
+        if (cluster.cycles > 0) {
+            ESP_LOGI(TAG, "📊 Clustering: %lu cycles, %lu points → %lu targets (%lu noise, %lu dropped)",
+                     cluster.cycles, cluster.points_in, cluster.targets_out,
+                     cluster.noise_points, cluster.dropped);
+            ESP_LOGI(TAG, "📊 Clustering time: last %lu us, avg %lu us, max %lu us (frame period %lu ms)",
+                     cluster.last_us, cluster.total_us / cluster.cycles, cluster.max_us,
+                     cluster.frame_period_ms);
+        }
+        
+        kalman_tracker_stats_t kalman;
+        kalman_tracker_get_stats(&kalman);
+        if (kalman.cycles > 0) {
+            ESP_LOGI(TAG, "📊 Tracks: %lu active, %lu born, %lu confirmed, %lu died, %lu detections over limit, %lu births refused",
+                     kalman.active_tracks, kalman.births, kalman.confirmations, kalman.deaths,
+                     kalman.dropped_detections, kalman.full_rejections);
+            ESP_LOGI(TAG, "📊 Tracking time: last %lu us, avg %lu us, max %lu us",
+                     kalman.last_us, kalman.total_us / kalman.cycles, kalman.max_us);
+        }
+        
+        trajectory_store_stats_t traj;
+        trajectory_store_get_stats(&traj);
+        if (traj.samples_total > 0) {
+            ESP_LOGI(TAG, "📊 Trajectories: %lu tracks, %lu samples stored (%lu bytes reserved), %lu recorded, %lu evicted, %lu refused",
+                     traj.tracks, traj.samples, traj.memory_bytes, traj.samples_total,
+                     traj.evictions, traj.refused);
+        }
+        
+        occupancy_map_stats_t occupancy;
+        occupancy_map_get_stats(&occupancy);
+        if (occupancy.frames > 0) {
+            ESP_LOGI(TAG, "📊 Heatmap: %lu frames, %lu hits, %lu outside grid, %lu saturated (%lu bytes)",
+                     occupancy.frames, occupancy.hits, occupancy.outside, occupancy.saturated,
+                     occupancy.memory_bytes);
+        }
+        
+        zone_engine_stats_t zone_engine;
+        zone_engine_get_stats(&zone_engine);
+        if (zone_engine.frames > 0) {
+            ESP_LOGI(TAG, "📊 Polygon zones: %lu targets, %lu index hits, %lu exact tests, %lu outside grid",
+                     zone_engine.targets, zone_engine.index_hits, zone_engine.exact_tests,
+                     zone_engine.outside_grid);
+            ESP_LOGI(TAG, "📊 Polygon zone time: last %lu us, avg %lu us, max %lu us",
+                     zone_engine.last_us, zone_engine.total_us / zone_engine.frames, zone_engine.max_us);
+        }
+        
+        tripwire_stats_t tripwire;
+        tripwire_get_stats(&tripwire);
+        if (tripwire.tests > 0) {
+            ESP_LOGI(TAG, "📊 Tripwires: %lu crossings, %lu tests, %lu jumps ignored",
+                     tripwire.crossings, tripwire.tests, tripwire.jumps_ignored);
+        }
+        
+        if (g_presence_frames > 0 || g_target_frames > 0) {
+            uint32_t raw_changes = 0, transitions = 0, suppressed = 0;
+            for (int i = 0; i < PRESENCE_FSM_CHANNELS; i++) {
+                presence_fsm_channel_t channel;
+                presence_fsm_get_channel(i, &channel);
+                raw_changes += channel.raw_changes;
+                transitions += channel.transitions;
+                suppressed += channel.suppressed;
+            }
+            ESP_LOGI(TAG, "📊 Presence: %lu raw flips → %lu transitions (%lu flaps suppressed)",
+                     raw_changes, transitions, suppressed);
+            ESP_LOGI(TAG, "📊 Events sent: presence %lu of %lu frames, targets %lu of %lu frames",
+                     g_presence_messages, g_presence_frames, g_target_messages, g_target_frames);
+        }
+        
         // Tracker statistics
         if (target_tracker_person_present()) {
             uint32_t duration = target_tracker_get_duration();
@@ -24,11 +24,11 @@ extern "C" {
 esp_err_t api_init(void);
 
 // ========== SENSOR CALLBACKS ==========
-// These are called by the sensor module when data arrives
+// Called by the sensor module (sensor task) when data arrives. They only copy
+// the frame into the frame ring for api_process_frames(); a full ring drops it.
 
 /**
  * Handle target detection data from sensor
- * Called by sensor when target position data arrives
  * @param targets Array of detected targets
  * @param count Number of targets
  */
@@ -36,7 +36,6 @@ void api_on_target_detected(const hlk_target_t* targets, int32_t count);
 
 /**
  * Handle presence detection data from sensor
- * Called by sensor when zone presence data arrives
  * @param zone0 Zone 0 occupancy
  * @param zone1 Zone 1 occupancy
  * @param zone2 Zone 2 occupancy
@@ -46,12 +45,18 @@ void api_on_presence_detected(uint32_t zone0, uint32_t zone1, uint32_t zone2, ui
 
 /**
  * Handle zone configuration data from sensor
- * Called by sensor when zone boundary data arrives
- * @param zones Array of 4 zone boundaries
+ * @param zones The 4 decoded zone boundaries
  * @param is_interference true for interference zones, false for detection zones
  */
 void api_on_zones_received(const hlk_zone_t* zones, bool is_interference);
 
+/**
+ * Handle point cloud data from sensor
+ * Only queued while clustering or a web viewer uses it
+ * @param cloud Decoded point cloud (valid only during the call)
+ */
+void api_on_point_cloud(const hlk_point_cloud_t* cloud);
+
 /**
  * Handle configuration data from sensor
  * Called by sensor for sensitivity, trigger speed, etc.
@@ -61,12 +66,23 @@ void api_on_zones_received(const hlk_zone_t* zones, bool is_interference);
  */
 void api_on_config_received(uint16_t msg_type, const uint8_t* data, uint16_t len);
 
+// ========== PUBLISHING ==========
+
+/**
+ * Publish every queued frame (tracking, analytics, logging, SSE), then wait
+ * for the sensor task to queue more
+ * Call in a loop from the publish task - the only consumer of the frame ring
+ * @param timeout_ms Longest wait for new frames
+ */
+void api_process_frames(uint32_t timeout_ms);
+
 // ========== COMMAND PROCESSING ==========
 
 /**
  * Process web commands from command queue
  * Should be called regularly from sensor task
- * Converts web commands to sensor commands
+ * Drains the queue, schedules the sensor commands and submits those that are due;
+ * never blocks
  */
 void api_process_web_commands(void);
 
@@ -74,7 +90,7 @@ void api_process_web_commands(void);
 
 /**
  * Log periodic statistics
- * Should be called from main loop
+ * Should be called from the publish task loop
  */
 void api_log_stats(void);
 
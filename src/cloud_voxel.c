@@ -0,0 +1,141 @@
+// Point Cloud Voxel Implementation
+//
+// Points are quantized to int16 mm, bucketed by voxel index in a small
+// open-addressed hash table, and each occupied voxel is emitted as the
+// centroid of its points. Everything is integer after the initial
+// float → mm conversion, and the table is invalidated per frame with a
+// generation stamp instead of being cleared.
+
+#include "cloud_voxel.h"
+#include "spatial_grid.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "Voxel";
+
+typedef struct {
+    uint16_t stamp;     // Entry valid when equal to g_stamp
+    int16_t vx, vy, vz; // Voxel index
+    uint8_t out;        // Output slot
+} voxel_entry_t;
+
+// ========== GLOBAL STATE ==========
+
+static voxel_entry_t g_table[CLOUD_VOXEL_HASH_SLOTS];
+static uint16_t g_stamp = 0;
+static volatile uint16_t g_size_mm = CLOUD_VOXEL_DEFAULT_SIZE_MM;  // Set by cloud_voxel_set_size() from the sensor task
+
+// Per-voxel accumulators (mm, mm/s)
+static int32_t g_sum_x[HLK_MAX_CLOUD_POINTS];
+static int32_t g_sum_y[HLK_MAX_CLOUD_POINTS];
+static int32_t g_sum_z[HLK_MAX_CLOUD_POINTS];
+static int32_t g_sum_speed[HLK_MAX_CLOUD_POINTS];
+
+static cloud_voxel_cloud_t g_out;
+static cloud_voxel_stats_t g_voxel_stats = {0};
+
+// ========== API IMPLEMENTATION ==========
+
+void cloud_voxel_init(void) {
+    memset(g_table, 0, sizeof(g_table));
+    memset(&g_voxel_stats, 0, sizeof(g_voxel_stats));
+    g_stamp = 0;
+    g_size_mm = CLOUD_VOXEL_DEFAULT_SIZE_MM;
+    ESP_LOGI(TAG, "Voxel stage initialized (%d mm voxels)", g_size_mm);
+}
+
+void cloud_voxel_set_size(uint16_t size_mm) {
+    if (size_mm != 0 && size_mm < CLOUD_VOXEL_MIN_SIZE_MM) size_mm = CLOUD_VOXEL_MIN_SIZE_MM;
+    if (size_mm > CLOUD_VOXEL_MAX_SIZE_MM) size_mm = CLOUD_VOXEL_MAX_SIZE_MM;
+    g_size_mm = size_mm;
+    ESP_LOGI(TAG, "Voxel size set to %d mm%s", size_mm, size_mm ? "" : " (quantize only)");
+}
+
+uint16_t cloud_voxel_get_size(void) {
+    return g_size_mm;
+}
+
+const cloud_voxel_cloud_t* cloud_voxel_process(const hlk_point_cloud_t* cloud) {
+    int32_t n = cloud->count;
+    int32_t out = 0;
+    uint16_t size_mm = g_size_mm;  // One size for the whole frame, even if it changes mid-way
+    
+    // New generation - stale entries become invisible; clear on wrap
+    if (++g_stamp == 0) {
+        memset(g_table, 0, sizeof(g_table));
+        g_stamp = 1;
+    }
+    
+    for (int32_t i = 0; i < n; i++) {
+        int16_t x = spatial_grid_to_mm(cloud->x[i]);
+        int16_t y = spatial_grid_to_mm(cloud->y[i]);
+        int16_t z = spatial_grid_to_mm(cloud->z[i]);
+        int16_t speed = spatial_grid_to_mm(cloud->speed[i]);
+        int32_t slot_out;
+        
+        if (size_mm == 0) {
+            slot_out = out++;
+        } else {
+            int16_t vx = spatial_grid_cell_index(x, size_mm);
+            int16_t vy = spatial_grid_cell_index(y, size_mm);
+            int16_t vz = spatial_grid_cell_index(z, size_mm);
+            
+            // Linear probe; the table is over twice the max point count so it never fills
+            uint32_t h = spatial_grid_cell_hash(vx, vy, vz) & (CLOUD_VOXEL_HASH_SLOTS - 1);
+            voxel_entry_t *e = &g_table[h];
+            while (e->stamp == g_stamp && (e->vx != vx || e->vy != vy || e->vz != vz)) {
+                h = (h + 1) & (CLOUD_VOXEL_HASH_SLOTS - 1);
+                e = &g_table[h];
+            }
+            
+            if (e->stamp != g_stamp) {
+                e->stamp = g_stamp;
+                e->vx = vx;
+                e->vy = vy;
+                e->vz = vz;
+                e->out = out++;
+                slot_out = e->out;
+            } else {
+                slot_out = e->out;
+                g_sum_x[slot_out] += x;
+                g_sum_y[slot_out] += y;
+                g_sum_z[slot_out] += z;
+                g_sum_speed[slot_out] += speed;
+                g_out.weight[slot_out]++;
+                continue;
+            }
+        }
+        
+        // First point in this voxel
+        g_sum_x[slot_out] = x;
+        g_sum_y[slot_out] = y;
+        g_sum_z[slot_out] = z;
+        g_sum_speed[slot_out] = speed;
+        g_out.weight[slot_out] = 1;
+        g_out.cluster[slot_out] = (int16_t)cloud->cluster[i];
+    }
+    
+    // Centroids
+    for (int32_t v = 0; v < out; v++) {
+        int32_t w = g_out.weight[v];
+        g_out.x[v] = (int16_t)(g_sum_x[v] / w);
+        g_out.y[v] = (int16_t)(g_sum_y[v] / w);
+        g_out.z[v] = (int16_t)(g_sum_z[v] / w);
+        g_out.speed[v] = (int16_t)(g_sum_speed[v] / w);
+    }
+    g_out.count = out;
+    
+    g_voxel_stats.frames++;
+    g_voxel_stats.points_in += n;
+    g_voxel_stats.points_out += out;
+    g_voxel_stats.bytes_in += n * HLK_CLOUD_RECORD_SIZE;
+    g_voxel_stats.bytes_out += out * CLOUD_VOXEL_RECORD_SIZE;
+    
+    return &g_out;
+}
+
+void cloud_voxel_get_stats(cloud_voxel_stats_t* stats) {
+    if (stats) {
+        *stats = g_voxel_stats;
+    }
+}
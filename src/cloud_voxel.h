@@ -0,0 +1,82 @@
+// Point Cloud Voxel Module
+// Voxel-grid downsampling and 16-bit millimetre quantization of 0x0A08 point clouds
+
+#ifndef CLOUD_VOXEL_H
+#define CLOUD_VOXEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hlk_ld6002.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== CONFIGURATION ==========
+
+#define CLOUD_VOXEL_DEFAULT_SIZE_MM 100  // Voxel edge length (0 = quantize only)
+#define CLOUD_VOXEL_MIN_SIZE_MM 20
+#define CLOUD_VOXEL_MAX_SIZE_MM 1000
+#define CLOUD_VOXEL_HASH_SLOTS 128       // Open-addressed voxel table (power of two, > 2x max points)
+#define CLOUD_VOXEL_RECORD_SIZE 10       // Bytes per output point: cluster, x, y, z, speed (int16)
+
+// ========== DATA STRUCTURES ==========
+
+// Reduced point cloud - one centroid per occupied voxel, millimetres.
+// Overwritten by the next cloud_voxel_process() call.
+typedef struct {
+    int32_t count;                          // Voxels (output points)
+    int16_t cluster[HLK_MAX_CLOUD_POINTS];  // Cluster index of the voxel's first point
+    int16_t x[HLK_MAX_CLOUD_POINTS];        // Centroid X (mm)
+    int16_t y[HLK_MAX_CLOUD_POINTS];        // Centroid Y (mm)
+    int16_t z[HLK_MAX_CLOUD_POINTS];        // Centroid Z (mm)
+    int16_t speed[HLK_MAX_CLOUD_POINTS];    // Mean radial speed (mm/s)
+    uint8_t weight[HLK_MAX_CLOUD_POINTS];   // Points merged into the voxel
+} cloud_voxel_cloud_t;
+
+// Reduction statistics
+typedef struct {
+    uint32_t frames;      // Clouds processed
+    uint32_t points_in;   // Raw points received
+    uint32_t points_out;  // Voxel centroids emitted
+    uint32_t bytes_in;    // Raw record bytes (HLK_CLOUD_RECORD_SIZE per point)
+    uint32_t bytes_out;   // Quantized record bytes (CLOUD_VOXEL_RECORD_SIZE per voxel)
+} cloud_voxel_stats_t;
+
+// ========== API FUNCTIONS ==========
+
+/**
+ * Initialize voxel stage with the default voxel size
+ */
+void cloud_voxel_init(void);
+
+/**
+ * Set voxel edge length
+ * @param size_mm Edge length in mm, clamped to CLOUD_VOXEL_MIN/MAX_SIZE_MM (0 = quantize only)
+ */
+void cloud_voxel_set_size(uint16_t size_mm);
+
+/**
+ * Get voxel edge length
+ * @return Edge length in mm (0 = quantize only)
+ */
+uint16_t cloud_voxel_get_size(void);
+
+/**
+ * Downsample and quantize a point cloud
+ * @param cloud Decoded point cloud from the sensor
+ * @return Reduced cloud (valid until the next call)
+ */
+const cloud_voxel_cloud_t* cloud_voxel_process(const hlk_point_cloud_t* cloud);
+
+/**
+ * Get reduction statistics
+ * @param stats Output statistics
+ */
+void cloud_voxel_get_stats(cloud_voxel_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CLOUD_VOXEL_H
@@ -0,0 +1,328 @@
+// Command Pipeline Implementation
+//
+// The radar answers every command with an empty frame of the command's TYPE
+// (0x0201) before acting on it, and GET commands additionally with a report
+// (0x0A0E, 0x0A0F, ...). Frame IDs are not echoed, so correlation works on
+// ordering: every transmission (retries included) is logged in send order
+// and owes one ACK, and each ACK pays off the oldest entry. An ACK whose
+// entry belongs to a command already acknowledged, completed by its report
+// or failed is dropped, so it cannot complete the next command. Reports go
+// to the in-flight command expecting that type; two commands expecting the
+// same report type are never in flight together.
+
+#include "cmd_pipeline.h"
+#include "hlk_port.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "CmdPipe";
+
+#define CMD_MAX_REPORTS 2  // GET_ZONES answers with 0x0A0B and 0x0A0C
+#define CMD_SEND_LOG 32    // Transmissions still owed an ACK (depth x attempts, plus slack)
+#define CMD_ACK_LOST_FACTOR 2  // An ACK this many timeouts late is taken as lost
+
+typedef enum {
+    SLOT_FREE,
+    SLOT_QUEUED,
+    SLOT_IN_FLIGHT
+} slot_state_t;
+
+typedef struct {
+    slot_state_t state;
+    uint32_t cmd;
+    uint32_t order;          // Submission order (queued) / send order (in flight)
+    uint32_t timeout_ms;
+    uint32_t sent_at;        // hlk_port_millis() of the current attempt
+    uint32_t first_sent_at;  // hlk_port_millis() of the first attempt
+    uint32_t first_send_id;  // Send log ID of the first attempt (older entries are a previous command)
+    uint8_t retries_left;
+    uint8_t attempts;
+    bool acked;
+    uint8_t report_count;                    // Reports still outstanding
+    uint16_t reports[CMD_MAX_REPORTS];       // Outstanding report types (0 = received)
+} cmd_slot_t;
+
+// One transmission waiting for its ACK
+typedef struct {
+    uint8_t slot;
+    uint32_t id;             // g_next_send_id at the time of sending
+    uint32_t sent_at;
+    uint32_t timeout_ms;
+} cmd_send_t;
+
+// ========== GLOBAL STATE ==========
+
+static cmd_slot_t g_slots[CMD_PIPELINE_SLOTS];
+static uint32_t g_next_order = 0;
+static cmd_send_t g_sends[CMD_SEND_LOG];   // FIFO in send order
+static uint32_t g_send_head = 0;           // Oldest entry
+static uint32_t g_send_count = 0;
+static uint32_t g_next_send_id = 0;
+static cmd_pipeline_stats_t g_pipe_stats = {0};
+
+// ========== HELPERS ==========
+
+// Report types a command is answered with (beyond the ACK)
+static uint8_t expected_reports(uint32_t cmd, uint16_t reports[CMD_MAX_REPORTS]) {
+    switch (cmd) {
+        case CMD_GET_ZONES:
+            reports[0] = MSG_IND_HUMAN_DETECTION_3D_INTERFERENCE_ZONES;
+            reports[1] = MSG_IND_HUMAN_DETECTION_3D_DETECTION_ZONES;
+            return 2;
+        case CMD_GET_HOLD_DELAY:
+            reports[0] = MSG_IND_HUMAN_DETECTION_3D_PWM_DELAY;
+            return 1;
+        case CMD_GET_SENSITIVITY:
+            reports[0] = MSG_IND_HUMAN_DETECTION_3D_DETECT_SENSITIVITY;
+            return 1;
+        case CMD_GET_TRIGGER_SPEED:
+            reports[0] = MSG_IND_HUMAN_DETECTION_3D_DETECT_TRIGGER;
+            return 1;
+        case CMD_GET_Z_AXIS_RANGE:
+            reports[0] = MSG_IND_HUMAN_DETECTION_3D_Z_RANGE;
+            return 1;
+        case CMD_GET_INSTALL_METHOD:
+            reports[0] = MSG_IND_HUMAN_DETECTION_3D_INSTALL_SITE;
+            return 1;
+        case CMD_GET_LOW_POWER_MODE:
+            reports[0] = MSG_IND_HUMAN_DETECTION_3D_LOW_POWER_MODE;
+            return 1;
+        case CMD_GET_LOW_POWER_SLEEP_TIME:
+            reports[0] = MSG_IND_HUMAN_DETECTION_3D_LOW_POWER_TIME;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static bool slot_expects(const cmd_slot_t *slot, uint16_t msg_type) {
+    for (int i = 0; i < CMD_MAX_REPORTS; i++) {
+        if (slot->reports[i] == msg_type) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Would sending this command make a report type ambiguous?
+static bool conflicts_in_flight(const cmd_slot_t *candidate) {
+    for (int i = 0; i < CMD_PIPELINE_SLOTS; i++) {
+        if (g_slots[i].state != SLOT_IN_FLIGHT) continue;
+        for (int r = 0; r < CMD_MAX_REPORTS; r++) {
+            if (candidate->reports[r] && slot_expects(&g_slots[i], candidate->reports[r])) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void send_log_push(cmd_slot_t *slot, uint32_t now) {
+    if (g_send_count == CMD_SEND_LOG) {
+        // Full of ACKs that never came - forget the oldest
+        g_send_head = (g_send_head + 1) % CMD_SEND_LOG;
+        g_send_count--;
+    }
+    cmd_send_t *send = &g_sends[(g_send_head + g_send_count) % CMD_SEND_LOG];
+    send->slot = slot - g_slots;
+    send->id = g_next_send_id++;
+    send->sent_at = now;
+    send->timeout_ms = slot->timeout_ms;
+    g_send_count++;
+}
+
+// Oldest transmission the next ACK can belong to (skipping ones long since lost)
+static bool send_log_pop(cmd_send_t *out, uint32_t now) {
+    while (g_send_count > 0) {
+        *out = g_sends[g_send_head];
+        g_send_head = (g_send_head + 1) % CMD_SEND_LOG;
+        g_send_count--;
+        if (now - out->sent_at <= out->timeout_ms * CMD_ACK_LOST_FACTOR) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void slot_send(cmd_slot_t *slot, uint32_t now) {
+    slot->state = SLOT_IN_FLIGHT;
+    slot->order = g_next_order++;
+    slot->sent_at = now;
+    if (slot->attempts == 0) {
+        slot->first_sent_at = now;
+        slot->first_send_id = g_next_send_id;
+    }
+    send_log_push(slot, now);
+    slot->attempts++;
+    slot->acked = false;
+    hlk_ld6002_send_command(slot->cmd);
+}
+
+static void slot_complete(cmd_slot_t *slot) {
+    uint32_t now = hlk_port_millis();
+    uint32_t latency = now - slot->sent_at;
+    
+    g_pipe_stats.completed++;
+    g_pipe_stats.total_latency_ms += latency;
+    if (g_pipe_stats.completed == 1 || latency < g_pipe_stats.min_latency_ms) {
+        g_pipe_stats.min_latency_ms = latency;
+    }
+    if (latency > g_pipe_stats.max_latency_ms) {
+        g_pipe_stats.max_latency_ms = latency;
+    }
+    
+    if (slot->attempts > 1) {
+        ESP_LOGI(TAG, "⏱️  Command 0x%02lX answered in %lu ms (attempt %d, %lu ms since first send)",
+                 slot->cmd, latency, slot->attempts, now - slot->first_sent_at);
+    } else {
+        ESP_LOGI(TAG, "⏱️  Command 0x%02lX answered in %lu ms", slot->cmd, latency);
+    }
+    
+    slot->state = SLOT_FREE;
+}
+
+// ========== API IMPLEMENTATION ==========
+
+void cmd_pipeline_init(void) {
+    memset(g_slots, 0, sizeof(g_slots));
+    memset(&g_pipe_stats, 0, sizeof(g_pipe_stats));
+    g_next_order = 0;
+    g_send_head = 0;
+    g_send_count = 0;
+    g_next_send_id = 0;
+}
+
+esp_err_t cmd_pipeline_submit(uint32_t cmd, uint32_t timeout_ms, uint8_t retries) {
+    for (int i = 0; i < CMD_PIPELINE_SLOTS; i++) {
+        cmd_slot_t *slot = &g_slots[i];
+        if (slot->state != SLOT_FREE) continue;
+        
+        memset(slot, 0, sizeof(*slot));
+        slot->state = SLOT_QUEUED;
+        slot->cmd = cmd;
+        slot->order = g_next_order++;
+        slot->timeout_ms = timeout_ms;
+        slot->retries_left = retries;
+        slot->report_count = expected_reports(cmd, slot->reports);
+        g_pipe_stats.submitted++;
+        
+        // Get it on the wire now if there is room
+        cmd_pipeline_poll();
+        return ESP_OK;
+    }
+    
+    g_pipe_stats.rejected++;
+    ESP_LOGW(TAG, "Pipeline full, dropping command 0x%02lX", cmd);
+    return ESP_ERR_NO_MEM;
+}
+
+void cmd_pipeline_on_frame(uint16_t msg_type, const uint8_t* data, uint16_t len) {
+    (void)data;
+    
+    // ACK: empty frame echoing the command TYPE
+    if (msg_type == MSG_CFG_HUMAN_DETECTION_3D && len == 0) {
+        cmd_send_t send;
+        if (!send_log_pop(&send, hlk_port_millis())) {
+            g_pipe_stats.unmatched_acks++;
+            return;
+        }
+        
+        // Owed by a command that no longer needs it (completed, failed,
+        // already acknowledged by an earlier attempt) - swallow it here
+        cmd_slot_t *slot = &g_slots[send.slot];
+        if (slot->state != SLOT_IN_FLIGHT || slot->acked ||
+            (int32_t)(send.id - slot->first_send_id) < 0) {
+            g_pipe_stats.stale_acks++;
+            return;
+        }
+        slot->acked = true;
+        if (slot->report_count == 0) {
+            slot_complete(slot);
+        }
+        return;
+    }
+    
+    // Report answering a GET
+    for (int i = 0; i < CMD_PIPELINE_SLOTS; i++) {
+        cmd_slot_t *slot = &g_slots[i];
+        if (slot->state != SLOT_IN_FLIGHT) continue;
+        
+        for (int r = 0; r < CMD_MAX_REPORTS; r++) {
+            if (slot->reports[r] == msg_type) {
+                slot->reports[r] = 0;
+                // The report proves receipt even if the ACK was lost
+                if (--slot->report_count == 0) {
+                    slot_complete(slot);
+                }
+                return;
+            }
+        }
+    }
+}
+
+void cmd_pipeline_poll(void) {
+    uint32_t now = hlk_port_millis();
+    int in_flight = 0;
+    
+    // Timeouts: resend or give up
+    for (int i = 0; i < CMD_PIPELINE_SLOTS; i++) {
+        cmd_slot_t *slot = &g_slots[i];
+        if (slot->state != SLOT_IN_FLIGHT) continue;
+        
+        if (now - slot->sent_at < slot->timeout_ms) {
+            in_flight++;
+            continue;
+        }
+        
+        if (slot->retries_left > 0) {
+            slot->retries_left--;
+            g_pipe_stats.retries++;
+            ESP_LOGW(TAG, "Command 0x%02lX timed out after %lu ms, resending (%d left)",
+                     slot->cmd, slot->timeout_ms, slot->retries_left);
+            // Outstanding reports are kept: a late answer still completes it
+            slot_send(slot, now);
+            in_flight++;
+        } else {
+            g_pipe_stats.failed++;
+            ESP_LOGE(TAG, "❌ Command 0x%02lX failed: no response after %d attempts",
+                     slot->cmd, slot->attempts);
+            slot->state = SLOT_FREE;
+        }
+    }
+    
+    // Issue queued commands in submission order while there is room
+    while (in_flight < CMD_PIPELINE_DEPTH) {
+        cmd_slot_t *next = NULL;
+        for (int i = 0; i < CMD_PIPELINE_SLOTS; i++) {
+            cmd_slot_t *slot = &g_slots[i];
+            if (slot->state == SLOT_QUEUED &&
+                (!next || (int32_t)(slot->order - next->order) < 0)) {
+                next = slot;
+            }
+        }
+        
+        // Head of queue waits until its report type is free; later commands
+        // are not reordered past it
+        if (!next || conflicts_in_flight(next)) {
+            break;
+        }
+        
+        slot_send(next, now);
+        in_flight++;
+    }
+}
+
+bool cmd_pipeline_idle(void) {
+    for (int i = 0; i < CMD_PIPELINE_SLOTS; i++) {
+        if (g_slots[i].state != SLOT_FREE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void cmd_pipeline_get_stats(cmd_pipeline_stats_t* stats) {
+    if (stats) {
+        *stats = g_pipe_stats;
+    }
+}
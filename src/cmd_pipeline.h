@@ -0,0 +1,87 @@
+// Command Pipeline Module
+// Asynchronous sensor commands with response correlation, timeouts and retries
+
+#ifndef CMD_PIPELINE_H
+#define CMD_PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hlk_ld6002.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== CONFIGURATION ==========
+
+#define CMD_PIPELINE_SLOTS 16               // Commands queued or in flight
+#define CMD_PIPELINE_DEPTH 4                // Commands on the wire at once
+#define CMD_PIPELINE_DEFAULT_TIMEOUT_MS 300 // Per-attempt response timeout
+#define CMD_PIPELINE_DEFAULT_RETRIES 3      // Resends after the first attempt
+
+// ========== DATA STRUCTURES ==========
+
+// Pipeline statistics
+typedef struct {
+    uint32_t submitted;        // Commands accepted by cmd_pipeline_submit()
+    uint32_t completed;        // Commands answered (ACK and/or report)
+    uint32_t failed;           // Commands that exhausted their retries
+    uint32_t retries;          // Resends after a timeout
+    uint32_t rejected;         // Submissions dropped (pipeline full)
+    uint32_t unmatched_acks;   // ACKs with no command waiting for one
+    uint32_t stale_acks;       // ACKs owed by a completed or retried command, dropped
+    uint32_t min_latency_ms;   // Fastest answer (send → complete, last attempt)
+    uint32_t max_latency_ms;   // Slowest answer
+    uint32_t total_latency_ms; // Sum of answer latencies (avg = total / completed)
+} cmd_pipeline_stats_t;
+
+// ========== API FUNCTIONS ==========
+
+/**
+ * Initialize command pipeline
+ */
+void cmd_pipeline_init(void);
+
+/**
+ * Queue a control command (MSG_CFG_HUMAN_DETECTION_3D sub-command)
+ * Commands are sent in submission order, up to CMD_PIPELINE_DEPTH at a time.
+ * A GET completes when its report(s) arrive, anything else on the radar's ACK.
+ * @param cmd Command code (CMD_*)
+ * @param timeout_ms Response timeout per attempt
+ * @param retries Resends after a timeout before the command is failed
+ * @return ESP_OK if queued, ESP_ERR_NO_MEM if all slots are busy
+ */
+esp_err_t cmd_pipeline_submit(uint32_t cmd, uint32_t timeout_ms, uint8_t retries);
+
+/**
+ * Correlate a received frame with in-flight commands
+ * Register as the sensor's on_frame callback
+ * @param msg_type Message type
+ * @param data Payload bytes
+ * @param len Payload length
+ */
+void cmd_pipeline_on_frame(uint16_t msg_type, const uint8_t* data, uint16_t len);
+
+/**
+ * Send queued commands and handle timeouts
+ * Call after every hlk_ld6002_process()
+ */
+void cmd_pipeline_poll(void);
+
+/**
+ * Check whether every submitted command has completed or failed
+ * @return true if nothing is queued or in flight
+ */
+bool cmd_pipeline_idle(void);
+
+/**
+ * Get pipeline statistics
+ * @param stats Output statistics
+ */
+void cmd_pipeline_get_stats(cmd_pipeline_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CMD_PIPELINE_H
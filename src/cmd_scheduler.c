@@ -0,0 +1,166 @@
+// Command Scheduler Implementation
+//
+// Each waiting command sits in a slot with an absolute deadline. Commands
+// that overwrite the same radar setting share a family, and a slot is
+// reused by later posts of its family until the deadline passes, so only the
+// newest value reaches the wire. Due slots are submitted oldest deadline
+// first (ties in post order) and the pipeline keeps that order on the wire.
+
+#include "cmd_scheduler.h"
+#include "cmd_pipeline.h"
+#include "hlk_port.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "CmdSched";
+
+typedef struct {
+    bool used;
+    uint32_t cmd;
+    uint32_t family;
+    uint32_t order;          // Post order, breaks deadline ties
+    uint32_t first_post_ms;  // hlk_port_millis() of the post that took the slot
+    uint32_t deadline_ms;    // hlk_port_millis() at which it is due
+} sched_slot_t;
+
+// ========== GLOBAL STATE ==========
+
+static sched_slot_t g_slots[CMD_SCHEDULER_SLOTS];
+static uint32_t g_next_order = 0;
+static cmd_scheduler_stats_t g_sched_stats = {0};
+
+// ========== HELPERS ==========
+
+// Commands that overwrite the same setting; anything else only coalesces
+// with an identical command
+static uint32_t command_family(uint32_t cmd) {
+    switch (cmd) {
+        case CMD_SET_SENSITIVITY_LOW:
+        case CMD_SET_SENSITIVITY_MEDIUM:
+        case CMD_SET_SENSITIVITY_HIGH:
+            return CMD_SET_SENSITIVITY_LOW;
+        case CMD_SET_TRIGGER_SPEED_SLOW:
+        case CMD_SET_TRIGGER_SPEED_MEDIUM:
+        case CMD_SET_TRIGGER_SPEED_FAST:
+            return CMD_SET_TRIGGER_SPEED_SLOW;
+        case CMD_ENABLE_POINT_CLOUD:
+        case CMD_DISABLE_POINT_CLOUD:
+            return CMD_ENABLE_POINT_CLOUD;
+        case CMD_ENABLE_TARGET_DISPLAY:
+        case CMD_DISABLE_TARGET_DISPLAY:
+            return CMD_ENABLE_TARGET_DISPLAY;
+        case CMD_SET_INSTALL_TOP_MOUNTED:
+        case CMD_SET_INSTALL_SIDE_MOUNTED:
+            return CMD_SET_INSTALL_TOP_MOUNTED;
+        case CMD_ENABLE_LOW_POWER_MODE:
+        case CMD_DISABLE_LOW_POWER_MODE:
+            return CMD_ENABLE_LOW_POWER_MODE;
+        default:
+            return cmd;
+    }
+}
+
+// Signed difference, so deadlines survive the millisecond counter wrapping
+static inline bool due_before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+// ========== API IMPLEMENTATION ==========
+
+void cmd_scheduler_init(void) {
+    memset(g_slots, 0, sizeof(g_slots));
+    memset(&g_sched_stats, 0, sizeof(g_sched_stats));
+    g_next_order = 0;
+}
+
+esp_err_t cmd_scheduler_post(uint32_t cmd, uint32_t delay_ms) {
+    uint32_t now = hlk_port_millis();
+    uint32_t family = command_family(cmd);
+    sched_slot_t *free_slot = NULL;
+
+    for (int i = 0; i < CMD_SCHEDULER_SLOTS; i++) {
+        sched_slot_t *slot = &g_slots[i];
+        if (!slot->used) {
+            if (!free_slot) free_slot = slot;
+            continue;
+        }
+        if (slot->family != family) continue;
+
+        // Still waiting: the newer command replaces it
+        uint32_t deadline = now + delay_ms;
+        uint32_t limit = slot->first_post_ms + CMD_SCHEDULER_MAX_HOLD_MS;
+        if (due_before(slot->deadline_ms, deadline)) {
+            slot->deadline_ms = due_before(limit, deadline) ? limit : deadline;
+        }
+        slot->cmd = cmd;
+        slot->order = g_next_order++;
+        g_sched_stats.posted++;
+        g_sched_stats.coalesced++;
+        ESP_LOGD(TAG, "Command 0x%02lX coalesced, due in %ld ms",
+                 cmd, (int32_t)(slot->deadline_ms - now));
+        return ESP_OK;
+    }
+
+    if (!free_slot) {
+        g_sched_stats.rejected++;
+        ESP_LOGW(TAG, "Scheduler full, dropping command 0x%02lX", cmd);
+        return ESP_ERR_NO_MEM;
+    }
+
+    free_slot->used = true;
+    free_slot->cmd = cmd;
+    free_slot->family = family;
+    free_slot->order = g_next_order++;
+    free_slot->first_post_ms = now;
+    free_slot->deadline_ms = now + delay_ms;
+    g_sched_stats.posted++;
+    if (++g_sched_stats.depth > g_sched_stats.max_depth) {
+        g_sched_stats.max_depth = g_sched_stats.depth;
+    }
+    return ESP_OK;
+}
+
+void cmd_scheduler_poll(void) {
+    uint32_t now = hlk_port_millis();
+
+    while (true) {
+        sched_slot_t *next = NULL;
+        for (int i = 0; i < CMD_SCHEDULER_SLOTS; i++) {
+            sched_slot_t *slot = &g_slots[i];
+            if (!slot->used || due_before(now, slot->deadline_ms)) continue;
+            if (!next || due_before(slot->deadline_ms, next->deadline_ms) ||
+                (slot->deadline_ms == next->deadline_ms && (int32_t)(slot->order - next->order) < 0)) {
+                next = slot;
+            }
+        }
+        if (!next) break;
+
+        next->used = false;
+        g_sched_stats.depth--;
+        if (cmd_pipeline_submit(next->cmd, CMD_PIPELINE_DEFAULT_TIMEOUT_MS,
+                                CMD_PIPELINE_DEFAULT_RETRIES) == ESP_OK) {
+            g_sched_stats.submitted++;
+        } else {
+            g_sched_stats.rejected++;
+        }
+    }
+}
+
+uint32_t cmd_scheduler_next_deadline_ms(uint32_t max_ms) {
+    uint32_t now = hlk_port_millis();
+    uint32_t wait = max_ms;
+
+    for (int i = 0; i < CMD_SCHEDULER_SLOTS; i++) {
+        const sched_slot_t *slot = &g_slots[i];
+        if (!slot->used) continue;
+        if (!due_before(now, slot->deadline_ms)) return 0;
+        if (slot->deadline_ms - now < wait) wait = slot->deadline_ms - now;
+    }
+    return wait;
+}
+
+void cmd_scheduler_get_stats(cmd_scheduler_stats_t* stats) {
+    if (stats) {
+        *stats = g_sched_stats;
+    }
+}
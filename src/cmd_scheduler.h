@@ -0,0 +1,78 @@
+// Command Scheduler Module
+// Deadline-driven front end of the command pipeline. Commands are posted with
+// a delay instead of sleeping in the sensor task; a command still waiting for
+// its deadline is replaced by a later one of the same family (e.g. a burst of
+// sensitivity changes from a slider only sends the last value).
+
+#ifndef CMD_SCHEDULER_H
+#define CMD_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== CONFIGURATION ==========
+
+#define CMD_SCHEDULER_SLOTS 8                // Commands waiting for their deadline
+#define CMD_SCHEDULER_COALESCE_MS 100        // Hold-off for set commands, lets a burst collapse
+#define CMD_SCHEDULER_SETTLE_MS 200          // Set → follow-up GET spacing
+#define CMD_SCHEDULER_MAX_HOLD_MS 500        // Re-posting never defers a command longer than this
+
+// ========== DATA STRUCTURES ==========
+
+// Scheduler statistics
+typedef struct {
+    uint32_t posted;         // Commands accepted by cmd_scheduler_post()
+    uint32_t coalesced;      // Commands replaced before they were sent
+    uint32_t submitted;      // Commands handed to the pipeline
+    uint32_t rejected;       // Posts dropped (no free slot) or refused by the pipeline
+    uint32_t depth;          // Commands currently waiting
+    uint32_t max_depth;      // Most commands ever waiting at once
+} cmd_scheduler_stats_t;
+
+// ========== API FUNCTIONS ==========
+
+/**
+ * Initialize command scheduler
+ */
+void cmd_scheduler_init(void);
+
+/**
+ * Schedule a control command (CMD_*) for the command pipeline
+ * If a command of the same family is still waiting it is replaced and counted
+ * as coalesced; the replacement inherits the later deadline, capped at
+ * CMD_SCHEDULER_MAX_HOLD_MS after the original post.
+ * @param cmd Command code (CMD_*)
+ * @param delay_ms Earliest send time, relative to now
+ * @return ESP_OK if scheduled, ESP_ERR_NO_MEM if all slots are busy
+ */
+esp_err_t cmd_scheduler_post(uint32_t cmd, uint32_t delay_ms);
+
+/**
+ * Hand every command whose deadline has passed to the pipeline, in deadline order
+ * Call from the sensor loop; never blocks
+ */
+void cmd_scheduler_poll(void);
+
+/**
+ * Time until the next deadline, to bound the sensor loop's UART wait
+ * @param max_ms Value returned when nothing is scheduled
+ * @return Milliseconds until the earliest deadline (0 if overdue), at most max_ms
+ */
+uint32_t cmd_scheduler_next_deadline_ms(uint32_t max_ms);
+
+/**
+ * Get scheduler statistics
+ * @param stats Output statistics
+ */
+void cmd_scheduler_get_stats(cmd_scheduler_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CMD_SCHEDULER_H
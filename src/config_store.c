@@ -0,0 +1,416 @@
+// Config Store Implementation
+//
+// The saved blob is the device state cache's settings merged over the
+// previous blob, so a field the radar has not reported this boot keeps its
+// saved value. Saving is gated until boot configuration completes: before
+// that the cache holds whatever the radar came up with, not what it should
+// be set to. A save whose blob matches flash is skipped without a write.
+//
+// The radar ACKs every frame, the payload setters (zones, Z range, hold
+// delay, sleep time; 0x0202-0x0205) included, but the pipeline only
+// correlates 0x0201 commands: the setters go out as one burst and their
+// ACKs (empty frames of their own TYPE) are ignored. An ACK would only
+// confirm receipt anyway - the read-back is what shows the radar applied
+// the value, and it also catches a value the radar clamps or refuses. So
+// restore is repeated until the read-backs match or
+// CONFIG_STORE_RESTORE_ATTEMPTS run out. A field the radar still differs on
+// is pinned: its saved value is kept until the field changes again after
+// boot.
+
+#include "config_store.h"
+#include "device_state.h"
+#include "cmd_pipeline.h"
+#include "hlk_ld6002.h"
+#include "hlk_port.h"
+#include "esp_log.h"
+#include "nvs_flash.h"
+#include "nvs.h"
+#include <string.h>
+
+static const char *TAG = "ConfigStore";
+
+// Bumped when the blob layout changes; coordinates differ between builds
+#define CONFIG_BLOB_FORMAT (0x43530100u | HLK_FIXED_POINT)
+
+// Fields restored at boot (working mode has no set command)
+#define PERSISTED_FIELDS (((1u << DEVICE_STATE_FIELDS) - 1) & ~(1u << DEVICE_STATE_WORKING_MODE))
+
+#define FIELD_BIT(field) (1u << (field))
+
+typedef struct {
+    uint32_t format;         // CONFIG_BLOB_FORMAT
+    uint32_t fields;         // FIELD_BIT() of the fields holding a value
+    uint32_t hold_delay_s;
+    uint32_t low_power_time_ms;
+    float z_min_m;
+    float z_max_m;
+    uint8_t sensitivity;
+    uint8_t trigger_speed;
+    uint8_t install_method;
+    uint8_t low_power_mode;
+    hlk_zone_t detection_zones[HLK_ZONE_COUNT];
+    hlk_zone_t interference_zones[HLK_ZONE_COUNT];
+} config_blob_t;
+
+// ========== GLOBAL STATE ==========
+
+static config_blob_t g_saved;              // Matches flash (fields = 0 when nothing is saved)
+static device_state_t g_state;             // Scratch snapshot (restore on the sensor task, save on app_main)
+static hlk_tx_batch_t g_batch;             // Boot push (sensor task only)
+static bool g_ready = false;               // Boot configuration complete, saving enabled
+static bool g_dirty = false;
+static uint32_t g_seen_version = 0;        // Device state version last looked at
+static uint32_t g_dirty_since = 0;         // First unsaved change
+static uint32_t g_changed_at = 0;          // Latest unsaved change
+static uint32_t g_restore_start = 0;
+static int g_attempts = 0;                 // config_store_restore() passes so far
+static uint32_t g_pinned = 0;              // FIELD_BIT() of saved fields the radar would not take
+static uint32_t g_pin_version[DEVICE_STATE_FIELDS];  // Their cache version at boot complete
+static config_store_stats_t g_store_stats = {0};
+static hlk_port_mutex_t g_mutex = NULL;
+
+// ========== HELPERS ==========
+
+// Should the cache's value of a field go into the blob?
+static bool take(const device_state_t *state, device_state_field_t field) {
+    if (!(PERSISTED_FIELDS & FIELD_BIT(field)) || !state->meta[field].known) return false;
+    // A pinned field only counts once it changed after boot
+    return !(g_pinned & FIELD_BIT(field)) || state->meta[field].version > g_pin_version[field];
+}
+
+// Saved blob with every persisted field of the cache applied
+static void build_blob(config_blob_t *blob, const device_state_t *state) {
+    *blob = g_saved;
+    blob->format = CONFIG_BLOB_FORMAT;
+
+    for (int f = 0; f < DEVICE_STATE_FIELDS; f++) {
+        if (take(state, f)) {
+            blob->fields |= FIELD_BIT(f);
+        }
+    }
+
+    if (take(state, DEVICE_STATE_HOLD_DELAY)) blob->hold_delay_s = state->hold_delay_s;
+    if (take(state, DEVICE_STATE_SENSITIVITY)) blob->sensitivity = state->sensitivity;
+    if (take(state, DEVICE_STATE_TRIGGER_SPEED)) blob->trigger_speed = state->trigger_speed;
+    if (take(state, DEVICE_STATE_Z_RANGE)) {
+        blob->z_min_m = state->z_min_m;
+        blob->z_max_m = state->z_max_m;
+    }
+    if (take(state, DEVICE_STATE_INSTALL_METHOD)) blob->install_method = state->install_method;
+    if (take(state, DEVICE_STATE_LOW_POWER_MODE)) blob->low_power_mode = state->low_power_mode;
+    if (take(state, DEVICE_STATE_LOW_POWER_TIME)) blob->low_power_time_ms = state->low_power_time_ms;
+    if (take(state, DEVICE_STATE_DETECTION_ZONES)) {
+        memcpy(blob->detection_zones, state->detection_zones, sizeof(blob->detection_zones));
+    }
+    if (take(state, DEVICE_STATE_INTERFERENCE_ZONES)) {
+        memcpy(blob->interference_zones, state->interference_zones, sizeof(blob->interference_zones));
+    }
+}
+
+static esp_err_t write_blob(const config_blob_t *blob) {
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(CONFIG_STORE_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) return err;
+
+    err = nvs_set_blob(handle, CONFIG_STORE_KEY, blob, sizeof(*blob));
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return err;
+}
+
+// Does the saved field need pushing? (unreported counts as different)
+static bool differs(const config_blob_t *saved, const device_state_t *state, device_state_field_t field,
+                    bool equal) {
+    return (saved->fields & FIELD_BIT(field)) && (!state->meta[field].known || !equal);
+}
+
+// Saved fields the radar's reported state does not match
+static uint32_t differing_fields(const config_blob_t *saved, const device_state_t *state) {
+    uint32_t mask = 0;
+    if (differs(saved, state, DEVICE_STATE_HOLD_DELAY, state->hold_delay_s == saved->hold_delay_s)) {
+        mask |= FIELD_BIT(DEVICE_STATE_HOLD_DELAY);
+    }
+    if (differs(saved, state, DEVICE_STATE_SENSITIVITY, state->sensitivity == saved->sensitivity)) {
+        mask |= FIELD_BIT(DEVICE_STATE_SENSITIVITY);
+    }
+    if (differs(saved, state, DEVICE_STATE_TRIGGER_SPEED, state->trigger_speed == saved->trigger_speed)) {
+        mask |= FIELD_BIT(DEVICE_STATE_TRIGGER_SPEED);
+    }
+    if (differs(saved, state, DEVICE_STATE_Z_RANGE,
+                state->z_min_m == saved->z_min_m && state->z_max_m == saved->z_max_m)) {
+        mask |= FIELD_BIT(DEVICE_STATE_Z_RANGE);
+    }
+    if (differs(saved, state, DEVICE_STATE_INSTALL_METHOD, state->install_method == saved->install_method)) {
+        mask |= FIELD_BIT(DEVICE_STATE_INSTALL_METHOD);
+    }
+    if (differs(saved, state, DEVICE_STATE_LOW_POWER_MODE, state->low_power_mode == (saved->low_power_mode != 0))) {
+        mask |= FIELD_BIT(DEVICE_STATE_LOW_POWER_MODE);
+    }
+    if (differs(saved, state, DEVICE_STATE_LOW_POWER_TIME, state->low_power_time_ms == saved->low_power_time_ms)) {
+        mask |= FIELD_BIT(DEVICE_STATE_LOW_POWER_TIME);
+    }
+    if (differs(saved, state, DEVICE_STATE_DETECTION_ZONES,
+                memcmp(state->detection_zones, saved->detection_zones, sizeof(saved->detection_zones)) == 0)) {
+        mask |= FIELD_BIT(DEVICE_STATE_DETECTION_ZONES);
+    }
+    if (differs(saved, state, DEVICE_STATE_INTERFERENCE_ZONES,
+                memcmp(state->interference_zones, saved->interference_zones, sizeof(saved->interference_zones)) == 0)) {
+        mask |= FIELD_BIT(DEVICE_STATE_INTERFERENCE_ZONES);
+    }
+    return mask;
+}
+
+// Queue area frames for the zones of one set that differ; true if any did
+static bool push_zones(const hlk_zone_t *saved, const hlk_zone_t *current, bool known, uint8_t first_area) {
+    bool pushed = false;
+    for (int i = 0; i < HLK_ZONE_COUNT; i++) {
+        if (known && memcmp(&saved[i], &current[i], sizeof(hlk_zone_t)) == 0) continue;
+        hlk_tx_batch_add_area(&g_batch, first_area + i, &saved[i]);
+        pushed = true;
+    }
+    return pushed;
+}
+
+static void submit(uint32_t cmd) {
+    cmd_pipeline_submit(cmd, CMD_PIPELINE_DEFAULT_TIMEOUT_MS, CMD_PIPELINE_DEFAULT_RETRIES);
+}
+
+// ========== API FUNCTIONS ==========
+
+esp_err_t config_store_init(void) {
+    if (!g_mutex) {
+        g_mutex = hlk_port_mutex_create();
+    }
+    memset(&g_saved, 0, sizeof(g_saved));
+    memset(&g_store_stats, 0, sizeof(g_store_stats));
+    g_ready = false;
+    g_dirty = false;
+    g_attempts = 0;
+    g_pinned = 0;
+
+    // Same recovery as wifi_manager_init(), which runs later and finds NVS ready
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        err = nvs_flash_init();
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "NVS init failed: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    nvs_handle_t handle;
+    if (nvs_open(CONFIG_STORE_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        ESP_LOGI(TAG, "No saved radar configuration (first boot)");
+        return ESP_OK;
+    }
+
+    config_blob_t blob;
+    size_t size = sizeof(blob);
+    err = nvs_get_blob(handle, CONFIG_STORE_KEY, &blob, &size);
+    nvs_close(handle);
+
+    if (err == ESP_OK && size == sizeof(blob) && blob.format == CONFIG_BLOB_FORMAT) {
+        g_saved = blob;
+        g_saved.fields &= PERSISTED_FIELDS;
+        g_store_stats.loaded = true;
+        ESP_LOGI(TAG, "💾 Loaded saved radar configuration (%d settings)", __builtin_popcount(g_saved.fields));
+    } else if (err != ESP_ERR_NVS_NOT_FOUND) {
+        ESP_LOGW(TAG, "Ignoring saved radar configuration (%s, %u bytes)", esp_err_to_name(err), (unsigned)size);
+    }
+    return ESP_OK;
+}
+
+int config_store_restore(void) {
+    if (g_attempts == 0) {
+        g_restore_start = hlk_port_millis();
+    }
+    if (!g_saved.fields || g_attempts >= CONFIG_STORE_RESTORE_ATTEMPTS) return 0;
+
+    static const uint32_t sensitivity[] = {
+        CMD_SET_SENSITIVITY_LOW, CMD_SET_SENSITIVITY_MEDIUM, CMD_SET_SENSITIVITY_HIGH
+    };
+    static const uint32_t trigger_speed[] = {
+        CMD_SET_TRIGGER_SPEED_SLOW, CMD_SET_TRIGGER_SPEED_MEDIUM, CMD_SET_TRIGGER_SPEED_FAST
+    };
+
+    // Sensor task, before streaming starts - the only time it reads the cache
+    const config_blob_t *saved = &g_saved;
+    const device_state_t *state = &g_state;
+    device_state_get(&g_state);
+    uint32_t diff = differing_fields(saved, state);
+    if (!diff) {
+        if (g_attempts == 0) {
+            ESP_LOGI(TAG, "💾 Radar matches saved configuration - nothing to push");
+        }
+        return 0;
+    }
+    g_attempts++;
+    hlk_tx_batch_init(&g_batch);
+
+    // Read-backs go after every set, so the cache ends up with what the radar applied
+    uint32_t readback[8];
+    int readbacks = 0;
+
+    if ((diff & FIELD_BIT(DEVICE_STATE_SENSITIVITY)) && saved->sensitivity < 3) {
+        submit(sensitivity[saved->sensitivity]);
+        readback[readbacks++] = CMD_GET_SENSITIVITY;
+    }
+    if ((diff & FIELD_BIT(DEVICE_STATE_TRIGGER_SPEED)) && saved->trigger_speed < 3) {
+        submit(trigger_speed[saved->trigger_speed]);
+        readback[readbacks++] = CMD_GET_TRIGGER_SPEED;
+    }
+    if (diff & FIELD_BIT(DEVICE_STATE_INSTALL_METHOD)) {
+        submit(saved->install_method ? CMD_SET_INSTALL_SIDE_MOUNTED : CMD_SET_INSTALL_TOP_MOUNTED);
+        readback[readbacks++] = CMD_GET_INSTALL_METHOD;
+    }
+    if (diff & FIELD_BIT(DEVICE_STATE_LOW_POWER_MODE)) {
+        submit(saved->low_power_mode ? CMD_ENABLE_LOW_POWER_MODE : CMD_DISABLE_LOW_POWER_MODE);
+        readback[readbacks++] = CMD_GET_LOW_POWER_MODE;
+    }
+
+    // Settings with a payload go out as one UART burst
+    if (diff & FIELD_BIT(DEVICE_STATE_HOLD_DELAY)) {
+        hlk_tx_batch_add_hold_delay(&g_batch, saved->hold_delay_s);
+        readback[readbacks++] = CMD_GET_HOLD_DELAY;
+    }
+    if (diff & FIELD_BIT(DEVICE_STATE_Z_RANGE)) {
+        hlk_tx_batch_add_z_range(&g_batch, saved->z_min_m, saved->z_max_m);
+        readback[readbacks++] = CMD_GET_Z_AXIS_RANGE;
+    }
+    if (diff & FIELD_BIT(DEVICE_STATE_LOW_POWER_TIME)) {
+        hlk_tx_batch_add_low_power_time(&g_batch, saved->low_power_time_ms);
+        readback[readbacks++] = CMD_GET_LOW_POWER_SLEEP_TIME;
+    }
+
+    // Area IDs 0-3 are interference zones, 4-7 detection zones
+    bool zones = false;
+    if (diff & FIELD_BIT(DEVICE_STATE_INTERFERENCE_ZONES)) {
+        zones |= push_zones(saved->interference_zones, state->interference_zones,
+                            state->meta[DEVICE_STATE_INTERFERENCE_ZONES].known, 0);
+    }
+    if (diff & FIELD_BIT(DEVICE_STATE_DETECTION_ZONES)) {
+        zones |= push_zones(saved->detection_zones, state->detection_zones,
+                            state->meta[DEVICE_STATE_DETECTION_ZONES].known, HLK_ZONE_COUNT);
+    }
+    if (zones) {
+        readback[readbacks++] = CMD_GET_ZONES;
+    }
+
+    if (g_batch.frames > 0) {
+        hlk_tx_batch_send(&g_batch);
+    }
+    for (int i = 0; i < readbacks; i++) {
+        submit(readback[i]);
+    }
+
+    int pushed = __builtin_popcount(diff);
+    hlk_port_mutex_lock(g_mutex);
+    if (g_attempts == 1) {
+        g_store_stats.restored = pushed;
+    } else {
+        g_store_stats.repushed += pushed;
+    }
+    hlk_port_mutex_unlock(g_mutex);
+
+    if (g_attempts == 1) {
+        ESP_LOGI(TAG, "💾 Radar differs from saved configuration - pushing %d setting%s",
+                 pushed, pushed == 1 ? "" : "s");
+    } else {
+        ESP_LOGW(TAG, "⚠️  %d setting%s not applied - pushing again (attempt %d of %d)",
+                 pushed, pushed == 1 ? "" : "s", g_attempts, CONFIG_STORE_RESTORE_ATTEMPTS);
+    }
+    return pushed;
+}
+
+void config_store_boot_complete(uint32_t now_ms) {
+    // Whatever still differs after the last attempt keeps its saved value
+    uint32_t pinned = 0;
+    if (g_saved.fields) {
+        device_state_get(&g_state);
+        pinned = differing_fields(&g_saved, &g_state);
+        for (int f = 0; f < DEVICE_STATE_FIELDS; f++) {
+            g_pin_version[f] = g_state.meta[f].version;
+        }
+    }
+    g_pinned = pinned;
+    if (pinned) {
+        ESP_LOGW(TAG, "⚠️  Radar did not take %d saved setting%s - keeping the saved value%s",
+                 __builtin_popcount(pinned), __builtin_popcount(pinned) == 1 ? "" : "s",
+                 __builtin_popcount(pinned) == 1 ? "" : "s");
+    }
+
+    hlk_port_mutex_lock(g_mutex);
+    g_store_stats.pinned = __builtin_popcount(pinned);
+    g_store_stats.ready_ms = now_ms;
+    if (g_store_stats.restored > 0) {
+        g_store_stats.restore_ms = hlk_port_millis() - g_restore_start;
+    }
+    hlk_port_mutex_unlock(g_mutex);
+
+    // Changes from here on are the user's; the first poll saves the boot result
+    g_seen_version = 0;
+    g_ready = true;
+}
+
+bool config_store_poll(uint32_t now_ms) {
+    if (!g_ready) return false;
+
+    uint32_t version = device_state_version();
+    if (version != g_seen_version) {
+        g_seen_version = version;
+        if (!g_dirty) {
+            g_dirty = true;
+            g_dirty_since = now_ms;
+        }
+        g_changed_at = now_ms;
+        hlk_port_mutex_lock(g_mutex);
+        g_store_stats.changes++;
+        hlk_port_mutex_unlock(g_mutex);
+    }
+
+    // Coalesce: wait for changes to settle, but not forever
+    if (!g_dirty) return false;
+    if (now_ms - g_changed_at < CONFIG_STORE_SAVE_DELAY_MS &&
+        now_ms - g_dirty_since < CONFIG_STORE_MAX_DELAY_MS) {
+        return false;
+    }
+    g_dirty = false;
+
+    config_blob_t blob;
+    device_state_get(&g_state);
+    build_blob(&blob, &g_state);
+    if (memcmp(&blob, &g_saved, sizeof(blob)) == 0) {
+        hlk_port_mutex_lock(g_mutex);
+        g_store_stats.skipped++;
+        hlk_port_mutex_unlock(g_mutex);
+        return false;
+    }
+
+    esp_err_t err = write_blob(&blob);
+    hlk_port_mutex_lock(g_mutex);
+    if (err == ESP_OK) {
+        g_saved = blob;
+        g_store_stats.writes++;
+    } else {
+        g_store_stats.errors++;
+    }
+    hlk_port_mutex_unlock(g_mutex);
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "💾 Saved radar configuration (%d settings)", __builtin_popcount(blob.fields));
+    } else {
+        ESP_LOGE(TAG, "❌ Failed to save radar configuration: %s", esp_err_to_name(err));
+    }
+    return err == ESP_OK;
+}
+
+void config_store_get_stats(config_store_stats_t* stats) {
+    if (!stats) return;
+
+    hlk_port_mutex_lock(g_mutex);
+    *stats = g_store_stats;
+    hlk_port_mutex_unlock(g_mutex);
+}
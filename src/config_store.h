@@ -0,0 +1,96 @@
+// Config Store Module
+// Last known radar configuration persisted in NVS. Changes in the device
+// state cache are saved after a quiet period, so a burst of settings costs
+// one flash write. On boot the saved configuration is compared with what the
+// radar reports and only the differences are pushed back.
+
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== CONFIGURATION ==========
+
+#ifndef CONFIG_STORE_SAVE_DELAY_MS
+#define CONFIG_STORE_SAVE_DELAY_MS 5000     // Quiet time after the last change before writing
+#endif
+
+#ifndef CONFIG_STORE_MAX_DELAY_MS
+#define CONFIG_STORE_MAX_DELAY_MS 60000     // Longest a change waits while changes keep coming
+#endif
+
+#ifndef CONFIG_STORE_RESTORE_ATTEMPTS
+#define CONFIG_STORE_RESTORE_ATTEMPTS 3     // Boot pushes before a setting is given up on
+#endif
+
+#define CONFIG_STORE_NAMESPACE "radar"      // NVS namespace
+#define CONFIG_STORE_KEY "config"           // NVS blob key
+
+// ========== DATA STRUCTURES ==========
+
+// Store and warm boot statistics
+typedef struct {
+    bool loaded;              // A saved configuration was found at boot
+    uint32_t restored;        // Settings pushed at boot because the radar differed
+    uint32_t repushed;        // Settings pushed again because the read-back did not match
+    uint32_t pinned;          // Settings the radar never took (saved value kept)
+    uint32_t restore_ms;      // Boot push + read-back time (0 if nothing was pushed)
+    uint32_t ready_ms;        // Milliseconds since boot when the radar was configured
+    uint32_t changes;         // State changes seen since boot
+    uint32_t writes;          // NVS writes
+    uint32_t skipped;         // Coalesced saves that matched flash (no write)
+    uint32_t errors;          // Failed NVS writes
+} config_store_stats_t;
+
+// ========== API FUNCTIONS ==========
+
+/**
+ * Initialize NVS and load the saved configuration
+ * Call before the sensor task starts
+ * @return ESP_OK (also when nothing is saved yet), or the NVS init error
+ */
+esp_err_t config_store_init(void);
+
+/**
+ * Push saved settings that differ from the radar's reported state
+ * Call on the sensor task once the init queries have been answered, and
+ * again after each push's read-backs until it returns 0. Gives up after
+ * CONFIG_STORE_RESTORE_ATTEMPTS pushes. The set commands and their
+ * read-backs go through the command pipeline
+ * @return Number of settings pushed (0 = radar matches, or out of attempts)
+ */
+int config_store_restore(void);
+
+/**
+ * Mark boot configuration complete - saving starts from here
+ * Saved settings the radar still differs on are kept as saved until they
+ * change again
+ * @param now_ms Current time in milliseconds
+ */
+void config_store_boot_complete(uint32_t now_ms);
+
+/**
+ * Save the configuration once changes have settled
+ * Call from a low-priority periodic loop (e.g. app_main)
+ * @param now_ms Current time in milliseconds
+ * @return true if NVS was written
+ */
+bool config_store_poll(uint32_t now_ms);
+
+/**
+ * Get store statistics
+ * @param stats Output statistics
+ */
+void config_store_get_stats(config_store_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONFIG_STORE_H
@@ -0,0 +1,158 @@
+// Device State Implementation
+//
+// Reports are decoded into a scratch copy of their field; only a value that
+// differs from the cache is written back and bumps the version, so periodic
+// re-reads (init, read-back after a set) leave the version alone.
+
+#include "device_state.h"
+#include "hlk_port.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "DeviceState";
+
+// ========== GLOBAL STATE ==========
+
+static device_state_t g_state;
+static hlk_port_mutex_t g_mutex = NULL;
+
+static const char *const g_field_names[DEVICE_STATE_FIELDS] = {
+    "hold_delay", "sensitivity", "trigger_speed", "z_range", "install_method",
+    "low_power_mode", "low_power_time", "working_mode", "detection_zones", "interference_zones"
+};
+
+// ========== HELPERS ==========
+
+static uint32_t read_u32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static float read_f32(const uint8_t *p) {
+    uint32_t bits = read_u32(p);
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// Write a decoded value into the cache (lock held); true if it changed
+static bool store(device_state_field_t field, void *dst, const void *value, size_t size, uint32_t now_ms) {
+    device_state_meta_t *meta = &g_state.meta[field];
+    bool changed = !meta->known || memcmp(dst, value, size) != 0;
+
+    meta->reports++;
+    meta->updated_ms = now_ms;
+    if (changed) {
+        memcpy(dst, value, size);
+        meta->known = true;
+        meta->version = ++g_state.version;
+    }
+    return changed;
+}
+
+// ========== API FUNCTIONS ==========
+
+void device_state_init(void) {
+    if (!g_mutex) {
+        g_mutex = hlk_port_mutex_create();
+    }
+    hlk_port_mutex_lock(g_mutex);
+    memset(&g_state, 0, sizeof(g_state));
+    hlk_port_mutex_unlock(g_mutex);
+}
+
+bool device_state_on_report(uint16_t msg_type, const uint8_t* data, uint16_t len, uint32_t now_ms) {
+    if (!data || len < 1) return false;
+
+    bool changed = false;
+    hlk_port_mutex_lock(g_mutex);
+    switch (msg_type) {
+        case MSG_IND_HUMAN_DETECTION_3D_PWM_DELAY:
+            if (len >= 4) {
+                uint32_t delay = read_u32(data);
+                changed = store(DEVICE_STATE_HOLD_DELAY, &g_state.hold_delay_s, &delay, sizeof(delay), now_ms);
+            }
+            break;
+
+        case MSG_IND_HUMAN_DETECTION_3D_DETECT_SENSITIVITY:
+            changed = store(DEVICE_STATE_SENSITIVITY, &g_state.sensitivity, &data[0], 1, now_ms);
+            break;
+
+        case MSG_IND_HUMAN_DETECTION_3D_DETECT_TRIGGER:
+            changed = store(DEVICE_STATE_TRIGGER_SPEED, &g_state.trigger_speed, &data[0], 1, now_ms);
+            break;
+
+        case MSG_IND_HUMAN_DETECTION_3D_Z_RANGE:
+            if (len >= 8) {
+                // z_min and z_max are adjacent floats in the cache
+                float range[2] = { read_f32(&data[0]), read_f32(&data[4]) };
+                float cached[2] = { g_state.z_min_m, g_state.z_max_m };
+                changed = store(DEVICE_STATE_Z_RANGE, cached, range, sizeof(range), now_ms);
+                g_state.z_min_m = cached[0];
+                g_state.z_max_m = cached[1];
+            }
+            break;
+
+        case MSG_IND_HUMAN_DETECTION_3D_INSTALL_SITE:
+            changed = store(DEVICE_STATE_INSTALL_METHOD, &g_state.install_method, &data[0], 1, now_ms);
+            break;
+
+        case MSG_IND_HUMAN_DETECTION_3D_LOW_POWER_MODE: {
+            bool enabled = data[0] != 0;
+            changed = store(DEVICE_STATE_LOW_POWER_MODE, &g_state.low_power_mode, &enabled, sizeof(enabled), now_ms);
+            break;
+        }
+
+        case MSG_IND_HUMAN_DETECTION_3D_LOW_POWER_TIME:
+            if (len >= 4) {
+                uint32_t time = read_u32(data);
+                changed = store(DEVICE_STATE_LOW_POWER_TIME, &g_state.low_power_time_ms, &time, sizeof(time), now_ms);
+            }
+            break;
+
+        case MSG_IND_HUMAN_DETECTION_3D_MODE:
+            changed = store(DEVICE_STATE_WORKING_MODE, &g_state.working_mode, &data[0], 1, now_ms);
+            break;
+
+        default:
+            break;
+    }
+    uint32_t version = g_state.version;
+    hlk_port_mutex_unlock(g_mutex);
+
+    if (changed) {
+        ESP_LOGD(TAG, "Report 0x%04X changed state (version %lu)", msg_type, (unsigned long)version);
+    }
+    return changed;
+}
+
+bool device_state_set_zones(const hlk_zone_t* zones, bool is_interference, uint32_t now_ms) {
+    if (!zones) return false;
+
+    hlk_port_mutex_lock(g_mutex);
+    bool changed = is_interference
+        ? store(DEVICE_STATE_INTERFERENCE_ZONES, g_state.interference_zones, zones,
+                sizeof(g_state.interference_zones), now_ms)
+        : store(DEVICE_STATE_DETECTION_ZONES, g_state.detection_zones, zones,
+                sizeof(g_state.detection_zones), now_ms);
+    hlk_port_mutex_unlock(g_mutex);
+    return changed;
+}
+
+void device_state_get(device_state_t* state) {
+    if (!state) return;
+
+    hlk_port_mutex_lock(g_mutex);
+    *state = g_state;
+    hlk_port_mutex_unlock(g_mutex);
+}
+
+uint32_t device_state_version(void) {
+    hlk_port_mutex_lock(g_mutex);
+    uint32_t version = g_state.version;
+    hlk_port_mutex_unlock(g_mutex);
+    return version;
+}
+
+const char* device_state_field_name(device_state_field_t field) {
+    return (unsigned)field < DEVICE_STATE_FIELDS ? g_field_names[field] : "unknown";
+}
@@ -0,0 +1,109 @@
+// Device State Module
+// Authoritative RAM cache of the radar's configuration: every settings
+// report (0x0A0D-0x0A14) and both zone sets. Each change bumps a global
+// version and the field's own version, so readers (GET /state) answer from
+// memory and can tell what changed since they last looked.
+
+#ifndef DEVICE_STATE_H
+#define DEVICE_STATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hlk_ld6002.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== DATA STRUCTURES ==========
+
+// Cached fields (settings reports in message type order, then zones)
+typedef enum {
+    DEVICE_STATE_HOLD_DELAY = 0,     // 0x0A0D
+    DEVICE_STATE_SENSITIVITY,        // 0x0A0E
+    DEVICE_STATE_TRIGGER_SPEED,      // 0x0A0F
+    DEVICE_STATE_Z_RANGE,            // 0x0A10
+    DEVICE_STATE_INSTALL_METHOD,     // 0x0A11
+    DEVICE_STATE_LOW_POWER_MODE,     // 0x0A12
+    DEVICE_STATE_LOW_POWER_TIME,     // 0x0A13
+    DEVICE_STATE_WORKING_MODE,       // 0x0A14
+    DEVICE_STATE_DETECTION_ZONES,    // 0x0A0C
+    DEVICE_STATE_INTERFERENCE_ZONES, // 0x0A0B
+    DEVICE_STATE_FIELDS
+} device_state_field_t;
+
+// Per-field bookkeeping
+typedef struct {
+    bool known;              // Reported at least once
+    uint32_t version;        // Global version at which the value last changed
+    uint32_t updated_ms;     // Last report, changed or not
+    uint32_t reports;        // Reports received
+} device_state_meta_t;
+
+// Snapshot of the cache
+typedef struct {
+    uint32_t version;                 // Bumped on every value change
+    uint32_t hold_delay_s;            // Presence hold delay
+    uint8_t sensitivity;              // 0 = low, 1 = medium, 2 = high
+    uint8_t trigger_speed;            // 0 = slow, 1 = medium, 2 = fast
+    float z_min_m;                    // Z-axis range
+    float z_max_m;
+    uint8_t install_method;           // 0 = top, 1 = side mounted
+    bool low_power_mode;
+    uint32_t low_power_time_ms;       // Sleep time in low power mode
+    uint8_t working_mode;             // 0 = low power, 1 = normal
+    hlk_zone_t detection_zones[HLK_ZONE_COUNT];
+    hlk_zone_t interference_zones[HLK_ZONE_COUNT];
+    device_state_meta_t meta[DEVICE_STATE_FIELDS];
+} device_state_t;
+
+// ========== API FUNCTIONS ==========
+
+/**
+ * Initialize device state (everything unknown, version 0)
+ */
+void device_state_init(void);
+
+/**
+ * Store a settings report
+ * @param msg_type Message type (0x0A0D-0x0A14; anything else is ignored)
+ * @param data Payload bytes
+ * @param len Payload length
+ * @param now_ms Current time in milliseconds
+ * @return true if the cached value changed
+ */
+bool device_state_on_report(uint16_t msg_type, const uint8_t* data, uint16_t len, uint32_t now_ms);
+
+/**
+ * Store a zone set report
+ * @param zones HLK_ZONE_COUNT zones
+ * @param is_interference true for interference zones (0x0A0B), false for detection zones (0x0A0C)
+ * @param now_ms Current time in milliseconds
+ * @return true if the cached zones changed
+ */
+bool device_state_set_zones(const hlk_zone_t* zones, bool is_interference, uint32_t now_ms);
+
+/**
+ * Copy the whole cache
+ * @param state Output snapshot
+ */
+void device_state_get(device_state_t* state);
+
+/**
+ * Get the current version without copying the cache
+ * @return Version (0 until the first report)
+ */
+uint32_t device_state_version(void);
+
+/**
+ * Get a field's name as used by GET /state
+ * @param field Field
+ * @return Name, or "unknown"
+ */
+const char* device_state_field_name(device_state_field_t field);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DEVICE_STATE_H
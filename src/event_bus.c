@@ -0,0 +1,154 @@
+// Event Bus Implementation
+//
+// Subscribers stay where they were added; a separate index keeps them in
+// priority order, so publishing is one pass. A queued subscriber owns an
+// ESP-IDF no-split ring buffer: the publish task writes the event header and
+// a copy of its payload as one item with a zero wait, and the subscriber's
+// task receives and handles it.
+// The table is only modified during startup, before anything is published.
+
+#include "event_bus.h"
+#include "hlk_port.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/ringbuf.h"
+#include <string.h>
+
+static const char *TAG = "EventBus";
+
+typedef struct {
+    event_subscriber_t config;
+    RingbufHandle_t queue;       // NULL for inline subscribers
+    event_bus_stats_t stats;
+} subscriber_t;
+
+// ========== GLOBAL STATE ==========
+
+static subscriber_t g_subscribers[EVENT_BUS_MAX_SUBSCRIBERS];
+static uint8_t g_order[EVENT_BUS_MAX_SUBSCRIBERS];   // Indices into g_subscribers, highest priority first
+static int g_subscriber_count = 0;
+
+// ========== HELPERS ==========
+
+static void run_handler(subscriber_t *sub, const event_t *event) {
+    uint32_t start = hlk_port_micros();
+    sub->config.handler(event, sub->config.ctx);
+    uint32_t elapsed = hlk_port_micros() - start;
+
+    sub->stats.handled++;
+    sub->stats.total_us += elapsed;
+    if (elapsed > sub->stats.max_us) {
+        sub->stats.max_us = elapsed;
+    }
+}
+
+// Queued subscriber: item = event_t header followed by the payload copy
+static void worker_task(void *arg) {
+    subscriber_t *sub = arg;
+
+    while (true) {
+        size_t size;
+        uint8_t *item = xRingbufferReceive(sub->queue, &size, portMAX_DELAY);
+        if (!item) continue;
+
+        event_t event;
+        memcpy(&event, item, sizeof(event));
+        event.data = item + sizeof(event_t);
+        run_handler(sub, &event);
+        vRingbufferReturnItem(sub->queue, item);
+    }
+}
+
+static void enqueue(subscriber_t *sub, const event_t *event) {
+    void *item = NULL;
+    if (xRingbufferSendAcquire(sub->queue, &item, sizeof(event_t) + event->len, 0) != pdTRUE) {
+        sub->stats.dropped++;
+        return;
+    }
+
+    memcpy(item, event, sizeof(event_t));
+    if (event->len) {
+        memcpy((uint8_t *)item + sizeof(event_t), event->data, event->len);
+    }
+    xRingbufferSendComplete(sub->queue, item);
+}
+
+// ========== API IMPLEMENTATION ==========
+
+void event_bus_init(void) {
+    memset(g_subscribers, 0, sizeof(g_subscribers));
+    g_subscriber_count = 0;
+}
+
+esp_err_t event_bus_subscribe(const event_subscriber_t* subscriber) {
+    if (!subscriber || !subscriber->handler || !subscriber->name || !subscriber->events) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (g_subscriber_count >= EVENT_BUS_MAX_SUBSCRIBERS) {
+        ESP_LOGE(TAG, "No room for subscriber '%s' (max %d)", subscriber->name, EVENT_BUS_MAX_SUBSCRIBERS);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Slots never move once taken - a worker task holds a pointer to its own
+    subscriber_t *sub = &g_subscribers[g_subscriber_count];
+    memset(sub, 0, sizeof(*sub));
+    sub->config = *subscriber;
+    sub->stats.name = subscriber->name;
+
+    if (subscriber->queue_bytes > 0) {
+        sub->queue = xRingbufferCreate(subscriber->queue_bytes, RINGBUF_TYPE_NOSPLIT);
+        if (!sub->queue) {
+            ESP_LOGE(TAG, "No memory for '%s' queue (%lu bytes)", subscriber->name, subscriber->queue_bytes);
+            return ESP_ERR_NO_MEM;
+        }
+        if (xTaskCreate(worker_task, subscriber->name, EVENT_BUS_WORKER_STACK, sub,
+                        EVENT_BUS_WORKER_PRIORITY, NULL) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to start task for '%s'", subscriber->name);
+            vRingbufferDelete(sub->queue);
+            sub->queue = NULL;
+            return ESP_ERR_NO_MEM;
+        }
+        sub->stats.queued = true;
+    }
+
+    // Delivery order: behind every subscriber of equal or higher priority
+    int pos = g_subscriber_count;
+    while (pos > 0 && g_subscribers[g_order[pos - 1]].config.priority < subscriber->priority) {
+        g_order[pos] = g_order[pos - 1];
+        pos--;
+    }
+    g_order[pos] = g_subscriber_count;
+    g_subscriber_count++;
+
+    ESP_LOGI(TAG, "✅ Subscriber '%s' (events 0x%02lX, priority %d, %s)", subscriber->name,
+             subscriber->events, subscriber->priority, sub->queue ? "queued" : "inline");
+    return ESP_OK;
+}
+
+void event_bus_publish(const event_t* event) {
+    if (!event || event->type >= EVENT_TYPES) return;
+    uint32_t mask = EVENT_MASK(event->type);
+
+    for (int i = 0; i < g_subscriber_count; i++) {
+        subscriber_t *sub = &g_subscribers[g_order[i]];
+        if (!(sub->config.events & mask)) continue;
+
+        sub->stats.delivered++;
+        if (sub->queue) {
+            enqueue(sub, event);
+        } else {
+            run_handler(sub, event);
+        }
+    }
+}
+
+int event_bus_get_stats(event_bus_stats_t* stats, int max) {
+    if (!stats) return 0;
+
+    int n = g_subscriber_count < max ? g_subscriber_count : max;
+    for (int i = 0; i < n; i++) {
+        stats[i] = g_subscribers[g_order[i]].stats;
+    }
+    return n;
+}
@@ -0,0 +1,106 @@
+// Event Bus Module
+// Typed publish/subscribe for decoded sensor frames on the publish task.
+// Any number of consumers subscribe to targets, presence, zones, point cloud
+// and config events. Inline subscribers run on the publish task in priority
+// order; queued subscribers get a copy in their own ring buffer and run on
+// their own lower-priority task, so a slow consumer drops its own events
+// instead of delaying everyone else's.
+
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== CONFIGURATION ==========
+
+#define EVENT_BUS_MAX_SUBSCRIBERS 12    // Inline and queued together
+#define EVENT_BUS_WORKER_PRIORITY 1     // FreeRTOS priority of queued subscribers (below the publish task)
+#define EVENT_BUS_WORKER_STACK 4096     // Stack of each queued subscriber's task
+
+// ========== DATA STRUCTURES ==========
+
+// Event types
+typedef enum {
+    EVENT_TARGETS = 0,       // hlk_target_t[count], aux = 1 if Kalman tracks (stable track_id)
+    EVENT_PRESENCE,          // uint32_t[HLK_ZONE_COUNT], raw per-zone flags
+    EVENT_ZONES,             // hlk_zone_t[HLK_ZONE_COUNT], aux = is_interference
+    EVENT_POINT_CLOUD,       // hlk_point_cloud_t, count = points
+    EVENT_CONFIG,            // Raw payload bytes, aux = message type
+    EVENT_TYPES
+} event_type_t;
+
+#define EVENT_MASK(type) (1u << (type))
+
+// Event as handed to subscribers - data is only valid inside the handler
+typedef struct {
+    event_type_t type;
+    uint16_t aux;            // Type-specific
+    uint32_t count;          // Elements (targets, points)
+    uint32_t len;            // Bytes at data (copied for queued subscribers)
+    const void *data;
+} event_t;
+
+typedef void (*event_handler_t)(const event_t* event, void* ctx);
+
+// Subscription
+typedef struct {
+    const char *name;        // Shown in statistics (must outlive the bus)
+    uint32_t events;         // EVENT_MASK() of the types to receive
+    int priority;            // Delivery order, highest first
+    uint32_t queue_bytes;    // 0 = inline on the publish task, else ring buffer for a worker task
+    event_handler_t handler;
+    void *ctx;               // Passed to the handler
+} event_subscriber_t;
+
+// Per-subscriber statistics
+typedef struct {
+    const char *name;
+    bool queued;             // Runs on its own task
+    uint32_t delivered;      // Events handed over (called inline or queued)
+    uint32_t dropped;        // Events lost because its queue was full
+    uint32_t handled;        // Handler calls completed
+    uint32_t total_us;       // Time spent in the handler
+    uint32_t max_us;         // Slowest single call
+} event_bus_stats_t;
+
+// ========== API FUNCTIONS ==========
+
+/**
+ * Initialize event bus (no subscribers)
+ */
+void event_bus_init(void);
+
+/**
+ * Add a subscriber - call during startup, before events are published
+ * @param subscriber Subscription (copied)
+ * @return ESP_OK, ESP_ERR_NO_MEM if the table, queue or task could not be allocated,
+ *         ESP_ERR_INVALID_ARG if handler, name or events are missing
+ */
+esp_err_t event_bus_subscribe(const event_subscriber_t* subscriber);
+
+/**
+ * Deliver an event to every subscriber of its type (publish task only)
+ * Never blocks: a queued subscriber with no room loses the event
+ * @param event Event to deliver
+ */
+void event_bus_publish(const event_t* event);
+
+/**
+ * Get per-subscriber statistics, in delivery order
+ * @param stats Output array
+ * @param max Capacity of stats
+ * @return Number of entries written
+ */
+int event_bus_get_stats(event_bus_stats_t* stats, int max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EVENT_BUS_H
@@ -0,0 +1,121 @@
+// Frame Ring Implementation
+//
+// head and tail are free-running byte counters; only the producer writes
+// head and only the consumer writes tail, so no lock is needed. Each side
+// publishes its counter with a release store after touching the buffer and
+// reads the other's with an acquire load. A record never wraps: if it does
+// not fit before the end of the buffer, the remainder is filled with a
+// padding record (type 0) that the consumer skips.
+
+#include "frame_ring.h"
+#include <string.h>
+
+_Static_assert((FRAME_RING_SIZE & (FRAME_RING_SIZE - 1)) == 0, "FRAME_RING_SIZE must be a power of two");
+_Static_assert(sizeof(frame_record_t) % FRAME_RING_ALIGN == 0, "Record header must keep payloads aligned");
+
+#define RING_MASK (FRAME_RING_SIZE - 1)
+#define ALIGN_UP(n) (((n) + FRAME_RING_ALIGN - 1) & ~(uint32_t)(FRAME_RING_ALIGN - 1))
+
+// ========== GLOBAL STATE ==========
+
+static uint8_t g_buf[FRAME_RING_SIZE] __attribute__((aligned(FRAME_RING_ALIGN)));
+static uint32_t g_head = 0;          // Bytes committed (producer)
+static uint32_t g_tail = 0;          // Bytes released (consumer)
+
+// Producer-private: the record being written
+static uint32_t g_pending_start = 0; // Ring offset of its header (after any padding)
+static uint32_t g_pending_size = 0;  // Header + payload, aligned
+static uint32_t g_pending_len = 0;   // Payload bytes
+
+// Consumer-private: the record returned by frame_ring_peek()
+static uint32_t g_peek_size = 0;
+
+static frame_ring_stats_t g_stats = {0};
+
+// ========== PRODUCER ==========
+
+void frame_ring_init(void) {
+    g_head = 0;
+    g_tail = 0;
+    g_pending_size = 0;
+    g_peek_size = 0;
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_stats.size = FRAME_RING_SIZE;
+}
+
+void* frame_ring_reserve(uint32_t len) {
+    uint32_t size = ALIGN_UP(sizeof(frame_record_t) + len);
+    uint32_t head = g_head;
+    uint32_t tail = __atomic_load_n(&g_tail, __ATOMIC_ACQUIRE);
+    uint32_t room_to_end = FRAME_RING_SIZE - (head & RING_MASK);
+    uint32_t pad = size > room_to_end ? room_to_end : 0;
+
+    if (size > FRAME_RING_SIZE || (head - tail) + pad + size > FRAME_RING_SIZE) {
+        g_stats.dropped++;
+        g_stats.dropped_bytes += len;
+        g_pending_size = 0;
+        return NULL;
+    }
+
+    if (pad) {
+        // Skip the tail end of the buffer; published together with the record
+        frame_record_t *filler = (frame_record_t *)&g_buf[head & RING_MASK];
+        filler->type = 0;
+        filler->aux = 0;
+        filler->len = pad - sizeof(frame_record_t);
+    }
+
+    g_pending_start = head + pad;
+    g_pending_size = pad + size;
+    g_pending_len = len;
+    return ((frame_record_t *)&g_buf[g_pending_start & RING_MASK])->payload;
+}
+
+void frame_ring_commit(frame_record_type_t type, uint16_t aux) {
+    if (g_pending_size == 0) return;
+
+    frame_record_t *record = (frame_record_t *)&g_buf[g_pending_start & RING_MASK];
+    record->type = (uint16_t)type;
+    record->aux = aux;
+    record->len = g_pending_len;
+
+    uint32_t head = g_head + g_pending_size;
+    uint32_t used = head - __atomic_load_n(&g_tail, __ATOMIC_ACQUIRE);
+    if (used > g_stats.high_water) g_stats.high_water = used;
+    g_stats.pushed++;
+    g_pending_size = 0;
+
+    __atomic_store_n(&g_head, head, __ATOMIC_RELEASE);
+}
+
+// ========== CONSUMER ==========
+
+const frame_record_t* frame_ring_peek(void) {
+    uint32_t tail = g_tail;
+    uint32_t head = __atomic_load_n(&g_head, __ATOMIC_ACQUIRE);
+
+    while (tail != head) {
+        const frame_record_t *record = (const frame_record_t *)&g_buf[tail & RING_MASK];
+        if (record->type != 0) {
+            g_peek_size = ALIGN_UP(sizeof(frame_record_t) + record->len);
+            return record;
+        }
+        // Padding runs to the end of the buffer
+        tail += FRAME_RING_SIZE - (tail & RING_MASK);
+        __atomic_store_n(&g_tail, tail, __ATOMIC_RELEASE);
+    }
+    return NULL;
+}
+
+void frame_ring_release(void) {
+    if (g_peek_size == 0) return;
+
+    g_stats.popped++;
+    __atomic_store_n(&g_tail, g_tail + g_peek_size, __ATOMIC_RELEASE);
+    g_peek_size = 0;
+}
+
+void frame_ring_get_stats(frame_ring_stats_t* stats) {
+    if (!stats) return;
+    *stats = g_stats;
+}
@@ -0,0 +1,96 @@
+// Frame Ring Module
+// Lock-free single-producer / single-consumer ring of decoded sensor frames.
+// The UART task writes records in place and never blocks; when the ring is
+// full the frame is dropped and counted. The publish task drains it.
+
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== CONFIGURATION ==========
+
+#ifndef FRAME_RING_SIZE
+#define FRAME_RING_SIZE 8192            // Bytes, power of two (~5 full target reports)
+#endif
+
+#define FRAME_RING_ALIGN 8              // Record start alignment
+
+// ========== DATA STRUCTURES ==========
+
+// Record types (0 is reserved for wrap padding)
+typedef enum {
+    FRAME_RECORD_TARGETS = 1,    // hlk_target_t[len / sizeof(hlk_target_t)]
+    FRAME_RECORD_PRESENCE,       // uint32_t[HLK_ZONE_COUNT]
+    FRAME_RECORD_ZONES,          // hlk_zone_t[HLK_ZONE_COUNT], aux = is_interference
+    FRAME_RECORD_CLOUD,          // Point cloud, packed by the producer
+    FRAME_RECORD_CONFIG,         // Raw payload bytes, aux = message type
+    FRAME_RECORD_TYPES
+} frame_record_type_t;
+
+// Record as seen by the consumer; the payload follows the header
+typedef struct {
+    uint16_t type;           // frame_record_type_t
+    uint16_t aux;            // Type-specific
+    uint32_t len;            // Payload bytes
+    uint8_t payload[];
+} frame_record_t;
+
+// Ring statistics
+typedef struct {
+    uint32_t pushed;         // Records committed
+    uint32_t popped;         // Records released by the consumer
+    uint32_t dropped;        // Frames dropped because the ring was full
+    uint32_t dropped_bytes;  // Payload bytes of the dropped frames
+    uint32_t high_water;     // Most bytes ever in use
+    uint32_t size;           // FRAME_RING_SIZE
+} frame_ring_stats_t;
+
+// ========== API FUNCTIONS ==========
+
+/**
+ * Initialize (empty) ring - call before either side starts
+ */
+void frame_ring_init(void);
+
+/**
+ * Reserve payload space for the next record (producer only)
+ * @param len Payload bytes
+ * @return Write pointer (FRAME_RING_ALIGN aligned), or NULL if the ring is full (counted as a drop)
+ */
+void* frame_ring_reserve(uint32_t len);
+
+/**
+ * Publish the reserved record to the consumer (producer only)
+ * @param type Record type
+ * @param aux Type-specific value
+ */
+void frame_ring_commit(frame_record_type_t type, uint16_t aux);
+
+/**
+ * Get the oldest record without removing it (consumer only)
+ * @return Record, or NULL if the ring is empty
+ */
+const frame_record_t* frame_ring_peek(void);
+
+/**
+ * Remove the record returned by frame_ring_peek() (consumer only)
+ */
+void frame_ring_release(void);
+
+/**
+ * Get ring statistics
+ * @param stats Output statistics
+ */
+void frame_ring_get_stats(frame_ring_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_RING_H
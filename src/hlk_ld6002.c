@@ -2,6 +2,7 @@
 // TinyFrame Protocol V1.2 for 60GHz FMCW radar
 
 #include "hlk_ld6002.h"
+#include "hlk_port.h"
 #include "esp_log.h"
 #include "esp_err.h"
 #include <string.h>
@@ -9,6 +10,8 @@
 
 static const char *TAG = "HLK-LD6002";
 
+#define TF_HEADER_LEN 8  // SOF + ID + LEN + TYPE + HEAD_CKSUM
+
 // ========== GLOBAL STATE ==========
 
 // Sensor statistics
@@ -21,14 +24,32 @@ static struct {
 // Registered callbacks
 static hlk_callbacks_t g_callbacks = {0};
 
+// Decode buffer for the copying on_target callback (kept off the task stack)
+static hlk_target_t g_targets[HLK_MAX_TARGETS];
+
+// Decode buffer for on_point_cloud (~5.6 KB, kept off the task stack)
+static hlk_point_cloud_t g_cloud;
+
+// Ingestion statistics
+static hlk_parser_stats_t g_parser_stats = {0};
+static uint32_t g_last_return_ms = 0;  // When hlk_ld6002_process*() last returned
+
 // Frame parser state
 static struct {
     uint8_t frame_buf[HLK_FRAME_BUF_SIZE];
     uint16_t pos;
     bool syncing;
     uint16_t expected_frame_len;
+    uint8_t cksum;        // Running XOR of the header or data section received so far
+    bool resync_pending;  // Current candidate was found by rescanning a rejected frame
 } g_parser = {0};
 
+// Staging buffer the UART driver's RX ring is drained into
+static uint8_t g_rx_chunk[HLK_RX_CHUNK_SIZE];
+
+// Next frame ID for host → radar frames (peer bit clear)
+static uint16_t g_tx_frame_id = 0;
+
 // ========== UTILITY FUNCTIONS ==========
 
 // Calculate checksum using TF_CKSUM_XOR (XOR all bytes, then invert)
@@ -47,8 +68,8 @@ static uint16_t read_uint16_be(const uint8_t *bytes) {
 
 // Read int32 from little-endian bytes
 static int32_t read_int32_le(const uint8_t *bytes) {
-    return (int32_t)bytes[0] | ((int32_t)bytes[1] << 8) |
-           ((int32_t)bytes[2] << 16) | ((int32_t)bytes[3] << 24);
+    return (int32_t)((uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+                     ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24));
 }
 
 // Read uint32 from little-endian bytes
@@ -57,8 +78,42 @@ static uint32_t read_uint32_le(const uint8_t *bytes) {
            ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
 }
 
+// Read a sensor float as hlk_coord_t - the one place coordinates are converted
+#if HLK_FIXED_POINT
+// Decodes the IEEE-754 bits straight to round(value * 1000) with integer
+// arithmetic, saturating at the int32 range. NaN decodes as 0.
+static hlk_coord_t read_coord_le(const uint8_t *bytes) {
+    uint32_t bits = read_uint32_le(bytes);
+    uint32_t exp = (bits >> 23) & 0xFF;
+    bool negative = bits >> 31;
+    
+    if (exp == 0) return 0;  // Zero / subnormal
+    if (exp == 0xFF) {
+        if (bits & 0x7FFFFF) return 0;  // NaN
+        return negative ? INT32_MIN : INT32_MAX;
+    }
+    
+    // value * 1000 = (mantissa * 125) * 2^(exp - 147); mantissa * 125 < 2^31,
+    // so the whole conversion stays in 32-bit registers
+    uint32_t scaled = (((bits & 0x7FFFFF) | 0x800000) * 125u);
+    int32_t shift = (int32_t)exp - 147;
+    
+    if (shift >= 0) {
+        if (shift > 0 && (shift > 30 || scaled > ((uint32_t)INT32_MAX >> shift))) {
+            return negative ? INT32_MIN : INT32_MAX;
+        }
+        scaled <<= shift;
+    } else if (shift < -31) {
+        return 0;
+    } else {
+        scaled = (scaled + (1u << (-shift - 1))) >> -shift;  // Round half away from zero
+    }
+    
+    return negative ? -(int32_t)scaled : (int32_t)scaled;
+}
+#else
 // Read float from little-endian bytes
-static float read_float_le(const uint8_t *bytes) {
+static float read_coord_le(const uint8_t *bytes) {
     union {
         uint8_t b[4];
         float f;
@@ -69,6 +124,7 @@ static float read_float_le(const uint8_t *bytes) {
     convert.b[3] = bytes[3];
     return convert.f;
 }
+#endif
 
 // Write uint16 to big-endian bytes
 static void write_uint16_be(uint8_t *bytes, uint16_t value) {
@@ -76,17 +132,83 @@ static void write_uint16_be(uint8_t *bytes, uint16_t value) {
     bytes[1] = value & 0xFF;
 }
 
-// Write int32 to little-endian bytes
-static void write_int32_le(uint8_t *bytes, int32_t value) {
+// Write uint32 to little-endian bytes
+static void write_uint32_le(uint8_t *bytes, uint32_t value) {
     bytes[0] = value & 0xFF;
     bytes[1] = (value >> 8) & 0xFF;
     bytes[2] = (value >> 16) & 0xFF;
     bytes[3] = (value >> 24) & 0xFF;
 }
 
-float hlk_calc_distance_3d(float x, float y, float z) {
+// Write int32 to little-endian bytes
+static void write_int32_le(uint8_t *bytes, int32_t value) {
+    write_uint32_le(bytes, (uint32_t)value);
+}
+
+// Write float to little-endian bytes
+static void write_float_le(uint8_t *bytes, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    write_uint32_le(bytes, bits);
+}
+
+// Write hlk_coord_t as a sensor float (setters only - not on the frame path)
+static void write_coord_le(uint8_t *bytes, hlk_coord_t value) {
+    write_float_le(bytes, HLK_COORD_TO_M(value));
+}
+
+uint32_t hlk_isqrt(uint64_t value) {
+    // Binary digit-by-digit root; 32-bit loop for the common (< 65 m) case
+    if (value <= UINT32_MAX) {
+        uint32_t v = (uint32_t)value;
+        uint32_t root = 0;
+        if (v == 0) return 0;
+        uint32_t bit = 1u << ((31 - __builtin_clz(v)) & ~1);  // Highest power of four <= v
+        while (bit) {
+            if (v >= root + bit) {
+                v -= root + bit;
+                root = (root >> 1) + bit;
+            } else {
+                root >>= 1;
+            }
+            bit >>= 2;
+        }
+        return root;
+    }
+    
+    uint64_t v = value;
+    uint64_t root = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+#if HLK_FIXED_POINT
+hlk_coord_t hlk_calc_distance_3d(hlk_coord_t x, hlk_coord_t y, hlk_coord_t z) {
+    uint64_t sum = (uint64_t)((int64_t)x * x) + (uint64_t)((int64_t)y * y) + (uint64_t)((int64_t)z * z);
+    uint32_t root = hlk_isqrt(sum);
+    return root > INT32_MAX ? INT32_MAX : (hlk_coord_t)root;
+}
+#else
+hlk_coord_t hlk_calc_distance_3d(hlk_coord_t x, hlk_coord_t y, hlk_coord_t z) {
     return sqrtf(x * x + y * y + z * z);
 }
+#endif
+
+bool hlk_zone_contains(const hlk_zone_t* zone, hlk_coord_t x, hlk_coord_t y, hlk_coord_t z) {
+    return x >= zone->x_min && x <= zone->x_max &&
+           y >= zone->y_min && y <= zone->y_max &&
+           z >= zone->z_min && z <= zone->z_max;
+}
 
 const char* hlk_sensitivity_to_string(uint8_t level) {
     const char *levels[] = {"Low", "Medium", "High"};
@@ -103,6 +225,53 @@ const char* hlk_install_method_to_string(uint8_t method) {
     return method < 2 ? methods[method] : "Unknown";
 }
 
+// ========== FRAME VIEW ACCESSORS ==========
+
+static const uint8_t *target_record(const hlk_target_view_t *view, int32_t index) {
+    return view->records + index * HLK_TARGET_RECORD_SIZE;
+}
+
+hlk_coord_t hlk_target_view_x(const hlk_target_view_t* view, int32_t index) {
+    return read_coord_le(target_record(view, index));
+}
+
+hlk_coord_t hlk_target_view_y(const hlk_target_view_t* view, int32_t index) {
+    return read_coord_le(target_record(view, index) + 4);
+}
+
+hlk_coord_t hlk_target_view_z(const hlk_target_view_t* view, int32_t index) {
+    return read_coord_le(target_record(view, index) + 8);
+}
+
+int32_t hlk_target_view_velocity(const hlk_target_view_t* view, int32_t index) {
+    return read_int32_le(target_record(view, index) + 12);
+}
+
+int32_t hlk_target_view_cluster_id(const hlk_target_view_t* view, int32_t index) {
+    return read_int32_le(target_record(view, index) + 16);
+}
+
+void hlk_target_view_get(const hlk_target_view_t* view, int32_t index, hlk_target_t* target) {
+    const uint8_t *record = target_record(view, index);
+    target->x = read_coord_le(&record[0]);
+    target->y = read_coord_le(&record[4]);
+    target->z = read_coord_le(&record[8]);
+    target->velocity = read_int32_le(&record[12]);
+    target->cluster_id = read_int32_le(&record[16]);
+    target->speed = 0;
+    target->track_id = 0;
+}
+
+void hlk_zone_view_get(const hlk_zone_view_t* view, int index, hlk_zone_t* zone) {
+    const uint8_t *record = view->records + index * HLK_ZONE_RECORD_SIZE;
+    zone->x_min = read_coord_le(&record[0]);
+    zone->x_max = read_coord_le(&record[4]);
+    zone->y_min = read_coord_le(&record[8]);
+    zone->y_max = read_coord_le(&record[12]);
+    zone->z_min = read_coord_le(&record[16]);
+    zone->z_max = read_coord_le(&record[20]);
+}
+
 // ========== MESSAGE PARSERS ==========
 
 // Parse target position message (0x0A04)
@@ -112,36 +281,48 @@ static void parse_target_position(const uint8_t *data, uint16_t len) {
     int32_t target_num = read_int32_le(&data[0]);
     g_stats.target_frames++;
     
+    hlk_target_view_t view = {
+        .records = &data[4],
+        .count = 0
+    };
+    
     if (target_num > 0) {
-        // Validate data length: 4 bytes header + (20 bytes per target)
-        uint16_t expected_len = 4 + (target_num * 20);
-        if (len < expected_len) {
-            ESP_LOGW(TAG, "Incomplete target data: got %d bytes, expected %d", len, expected_len);
+        // Validate data length: 4 bytes header + (20 bytes per target).
+        // Compared as a record count so a corrupt count cannot wrap the product.
+        if ((uint32_t)target_num > (uint32_t)(len - 4) / HLK_TARGET_RECORD_SIZE) {
+            g_parser_stats.malformed_targets++;
+            ESP_LOGW(TAG, "Incomplete target data: got %d bytes for %ld targets", len, target_num);
             return;
         }
-        
-        // Parse targets
-        hlk_target_t targets[10];  // Support up to 10 targets
-        int32_t num_to_process = target_num > 10 ? 10 : target_num;
-        
-        for (int i = 0; i < num_to_process; i++) {
-            uint16_t offset = 4 + (i * 20);
-            targets[i].x = read_float_le(&data[offset]);
-            targets[i].y = read_float_le(&data[offset + 4]);
-            targets[i].z = read_float_le(&data[offset + 8]);
-            targets[i].velocity = read_int32_le(&data[offset + 12]);
-            targets[i].cluster_id = read_int32_le(&data[offset + 16]);
+        view.count = target_num;
+    }
+    
+    // Zero-copy consumers read straight from the frame buffer
+    if (g_callbacks.on_target_view) {
+        g_callbacks.on_target_view(&view);
+    }
+    
+    // Copying compatibility layer
+    if (g_callbacks.on_target) {
+        if (view.count == 0) {
+            // No targets - trigger callback with count 0
+            g_callbacks.on_target(NULL, 0);
+            return;
         }
         
-        // Trigger callback
-        if (g_callbacks.on_target) {
-            g_callbacks.on_target(targets, num_to_process);
+        int32_t num_to_process = view.count;
+        if (num_to_process > HLK_MAX_TARGETS) {
+            if (g_parser_stats.truncated_frames++ == 0) {
+                ESP_LOGW(TAG, "Target report of %ld exceeds HLK_MAX_TARGETS (%d), truncating",
+                         view.count, HLK_MAX_TARGETS);
+            }
+            g_parser_stats.truncated_targets += num_to_process - HLK_MAX_TARGETS;
+            num_to_process = HLK_MAX_TARGETS;
         }
-    } else {
-        // No targets - trigger callback with count 0
-        if (g_callbacks.on_target) {
-            g_callbacks.on_target(NULL, 0);
+        for (int32_t i = 0; i < num_to_process; i++) {
+            hlk_target_view_get(&view, i, &g_targets[i]);
         }
+        g_callbacks.on_target(g_targets, num_to_process);
     }
 }
 
@@ -150,15 +331,39 @@ static void parse_point_cloud(const uint8_t *data, uint16_t len) {
     if (len < 4) return;
     
     int32_t point_num = read_int32_le(&data[0]);
+    if (point_num < 0) {
+        point_num = 0;
+    }
+    if ((uint32_t)point_num > (uint32_t)(len - 4) / HLK_CLOUD_RECORD_SIZE) {
+        ESP_LOGW(TAG, "Incomplete point cloud: got %d bytes for %ld points", len, point_num);
+        return;
+    }
     
     // Only log occasionally to avoid flooding
     static uint32_t last_cloud_log = 0;
-    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    uint32_t now = hlk_port_millis();
     
     if (point_num > 0 && (now - last_cloud_log > 10000)) {  // Every 10 seconds
         ESP_LOGI(TAG, "☁️  Point Cloud: %ld points", point_num);
         last_cloud_log = now;
     }
+    
+    if (!g_callbacks.on_point_cloud) {
+        return;
+    }
+    
+    // Decode each field into its own array; the record stride stays in the loop
+    const uint8_t *record = &data[4];
+    for (int32_t i = 0; i < point_num; i++, record += HLK_CLOUD_RECORD_SIZE) {
+        g_cloud.cluster[i] = read_int32_le(&record[0]);
+        g_cloud.x[i] = read_coord_le(&record[4]);
+        g_cloud.y[i] = read_coord_le(&record[8]);
+        g_cloud.z[i] = read_coord_le(&record[12]);
+        g_cloud.speed[i] = read_coord_le(&record[16]);
+    }
+    g_cloud.count = point_num;
+    
+    g_callbacks.on_point_cloud(&g_cloud);
 }
 
 // Parse presence status message (0x0A0A)
@@ -180,85 +385,50 @@ static void parse_presence_status(const uint8_t *data, uint16_t len) {
 
 // Parse zone coordinates (0x0A0B or 0x0A0C)
 static void parse_zones(const uint8_t *data, uint16_t len, bool is_interference) {
-    if (len < 96) return;  // 4 zones * 6 floats * 4 bytes = 96 bytes
+    if (len < HLK_ZONE_COUNT * HLK_ZONE_RECORD_SIZE) return;  // 4 zones * 6 floats * 4 bytes = 96 bytes
     
-    hlk_zone_t zones[4];
-    const char *zone_type = is_interference ? "Interference" : "Detection";
-    
-    ESP_LOGI(TAG, "📍 %s Zones:", zone_type);
+    hlk_zone_view_t view = {
+        .records = data,
+        .is_interference = is_interference
+    };
     
-    for (int i = 0; i < 4; i++) {
-        uint16_t offset = i * 24;
-        zones[i].x_min = read_float_le(&data[offset]);
-        zones[i].x_max = read_float_le(&data[offset + 4]);
-        zones[i].y_min = read_float_le(&data[offset + 8]);
-        zones[i].y_max = read_float_le(&data[offset + 12]);
-        zones[i].z_min = read_float_le(&data[offset + 16]);
-        zones[i].z_max = read_float_le(&data[offset + 20]);
-        
-        ESP_LOGI(TAG, "  Zone %d: X[%.1f to %.1f] Y[%.1f to %.1f] Z[%.1f to %.1f]m",
-                 i, zones[i].x_min, zones[i].x_max, 
-                 zones[i].y_min, zones[i].y_max,
-                 zones[i].z_min, zones[i].z_max);
+    // Trigger callbacks
+    if (g_callbacks.on_zones_view) {
+        g_callbacks.on_zones_view(&view);
     }
     
-    // Trigger callback
+    // Decoded (and logged) only for the copying callback
     if (g_callbacks.on_zones) {
+        hlk_zone_t zones[HLK_ZONE_COUNT];
+        const char *zone_type = is_interference ? "Interference" : "Detection";
+        
+        ESP_LOGI(TAG, "📍 %s Zones:", zone_type);
+        
+        for (int i = 0; i < HLK_ZONE_COUNT; i++) {
+            hlk_zone_view_get(&view, i, &zones[i]);
+            
+            ESP_LOGI(TAG, "  Zone %d: X[%.1f to %.1f] Y[%.1f to %.1f] Z[%.1f to %.1f]m",
+                     i, HLK_COORD_TO_M(zones[i].x_min), HLK_COORD_TO_M(zones[i].x_max),
+                     HLK_COORD_TO_M(zones[i].y_min), HLK_COORD_TO_M(zones[i].y_max),
+                     HLK_COORD_TO_M(zones[i].z_min), HLK_COORD_TO_M(zones[i].z_max));
+        }
+        
         g_callbacks.on_zones(zones, is_interference);
     }
 }
 
-// Parse and handle a complete TinyFrame
-static void parse_tinyframe(const uint8_t *frame, uint16_t frame_len) {
-    if (frame_len < 9) {  // Minimum frame: 1+2+2+2+1+0+1
-        ESP_LOGW(TAG, "Frame too short: %d bytes", frame_len);
-        return;
-    }
-    
-    // Parse header (big-endian)
-    uint8_t sof = frame[0];
-    uint16_t frame_id = read_uint16_be(&frame[1]);
-    uint16_t data_len = read_uint16_be(&frame[3]);
-    uint16_t msg_type = read_uint16_be(&frame[5]);
-    uint8_t head_cksum_rx = frame[7];
-    
-    // Verify SOF
-    if (sof != TF_SOF) {
-        ESP_LOGW(TAG, "Invalid SOF: 0x%02X", sof);
-        return;
-    }
-    
-    // Verify header checksum
-    uint8_t head_cksum_calc = calc_checksum(frame, 7);
-    if (head_cksum_calc != head_cksum_rx) {
-        ESP_LOGW(TAG, "Header checksum failed: calc=0x%02X rx=0x%02X", head_cksum_calc, head_cksum_rx);
-        return;
-    }
-    
-    // Verify frame length
-    uint16_t expected_len = 8 + data_len + 1;
-    if (frame_len != expected_len) {
-        ESP_LOGW(TAG, "Frame length mismatch: got=%d expected=%d", frame_len, expected_len);
-        return;
-    }
-    
-    // Get data pointer
-    const uint8_t *data = &frame[8];
-    uint8_t data_cksum_rx = frame[8 + data_len];
-    
-    // Verify data checksum
-    if (data_len > 0) {
-        uint8_t data_cksum_calc = calc_checksum(data, data_len);
-        if (data_cksum_calc != data_cksum_rx) {
-            ESP_LOGW(TAG, "Data checksum failed: calc=0x%02X rx=0x%02X", data_cksum_calc, data_cksum_rx);
-            return;
-        }
-    }
-    
+// Dispatch a validated TinyFrame payload to its message parser
+static void dispatch_frame(uint16_t frame_id, uint16_t msg_type, const uint8_t *data, uint16_t data_len) {
+    uint32_t start_cycles = hlk_port_cycles();
     g_stats.total_frames++;
     ESP_LOGD(TAG, "Frame #%lu: ID=0x%04X Type=0x%04X Len=%d", 
              g_stats.total_frames, frame_id, msg_type, data_len);
     
+    // Raw frame hook (command/response correlation)
+    if (g_callbacks.on_frame) {
+        g_callbacks.on_frame(msg_type, data, data_len);
+    }
+    
     // Process message based on type
     switch (msg_type) {
         case MSG_IND_HUMAN_DETECTION_3D_TGT_RES:
@@ -289,29 +459,271 @@ static void parse_tinyframe(const uint8_t *frame, uint16_t frame_len) {
             ESP_LOGD(TAG, "Message type: 0x%04X (len=%d)", msg_type, data_len);
             break;
     }
+    
+    g_parser_stats.dispatch_cycles += hlk_port_cycles() - start_cycles;
 }
 
-// ========== API IMPLEMENTATION ==========
+// ========== FRAME PARSER ==========
 
-esp_err_t hlk_ld6002_init(void) {
-    const uart_config_t uart_config = {
-        .baud_rate = HLK_LD6002_BAUDRATE,
-        .data_bits = UART_DATA_8_BITS,
-        .parity = UART_PARITY_DISABLE,
-        .stop_bits = UART_STOP_BITS_1,
-        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
-        .source_clk = UART_SCLK_DEFAULT,
-    };
+typedef enum {
+    PARSE_PENDING,  // Byte consumed, frame not complete yet
+    PARSE_FRAME,    // Frame validated and dispatched
+    PARSE_ERROR     // Candidate frame rejected, its bytes are still in frame_buf
+} parse_status_t;
 
-    ESP_ERROR_CHECK(uart_driver_install(HLK_LD6002_UART_PORT, HLK_UART_BUF_SIZE * 2, 0, 0, NULL, 0));
-    ESP_ERROR_CHECK(uart_param_config(HLK_LD6002_UART_PORT, &uart_config));
-    ESP_ERROR_CHECK(uart_set_pin(HLK_LD6002_UART_PORT, HLK_LD6002_TX_PIN, HLK_LD6002_RX_PIN,
-                                 UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE));
+static void parser_reset(void) {
+    g_parser.syncing = false;
+    g_parser.pos = 0;
+    g_parser.expected_frame_len = 0;
+}
+
+// Dispatch the validated frame in frame_buf and start looking for the next SOF
+static parse_status_t parser_complete(uint16_t data_len) {
+    g_parser_stats.frames++;
+    dispatch_frame(read_uint16_be(&g_parser.frame_buf[1]),
+                   read_uint16_be(&g_parser.frame_buf[5]),
+                   &g_parser.frame_buf[TF_HEADER_LEN], data_len);
+    parser_reset();
+    return PARSE_FRAME;
+}
+
+// Advance the frame state machine by one byte. Checksums are accumulated as
+// bytes arrive, so a frame is validated the moment its last byte is received.
+// A frame with LEN 0 (the radar's ACK) ends at HEAD_CKSUM: it has no data
+// section and no DATA_CKSUM.
+static parse_status_t parser_step(uint8_t byte) {
+    if (!g_parser.syncing) {
+        // Looking for SOF
+        if (byte == TF_SOF) {
+            g_parser.frame_buf[0] = byte;
+            g_parser.pos = 1;
+            g_parser.syncing = true;
+            g_parser.expected_frame_len = 0;
+            g_parser.cksum = byte;
+            ESP_LOGD(TAG, "SOF detected");
+        }
+        return PARSE_PENDING;
+    }
     
-    ESP_LOGI(TAG, "Initialized UART%d (TX:%d RX:%d @ %d baud)",
-             HLK_LD6002_UART_PORT, HLK_LD6002_TX_PIN, HLK_LD6002_RX_PIN, HLK_LD6002_BAUDRATE);
+    g_parser.frame_buf[g_parser.pos++] = byte;
     
-    return ESP_OK;
+    // Header bytes (ID, LEN, TYPE)
+    if (g_parser.pos < TF_HEADER_LEN) {
+        g_parser.cksum ^= byte;
+        return PARSE_PENDING;
+    }
+    
+    // Header checksum - validate before trusting the length field
+    if (g_parser.pos == TF_HEADER_LEN) {
+        uint8_t head_cksum_calc = ~g_parser.cksum;
+        if (head_cksum_calc != byte) {
+            // Rescanned candidates are mostly noise - counted, not logged
+            if (g_parser.resync_pending) {
+                ESP_LOGD(TAG, "Header checksum failed: calc=0x%02X rx=0x%02X", head_cksum_calc, byte);
+            } else {
+                ESP_LOGW(TAG, "Header checksum failed: calc=0x%02X rx=0x%02X", head_cksum_calc, byte);
+            }
+            g_parser_stats.header_cksum_errors++;
+            g_parser_stats.rejected_frames++;
+            return PARSE_ERROR;
+        }
+        
+        uint16_t data_len = read_uint16_be(&g_parser.frame_buf[3]);
+        if (data_len == 0) {
+            return parser_complete(0);
+        }
+        
+        // 32-bit so LEN 0xFFF8-0xFFFF cannot wrap to a tiny frame
+        uint32_t frame_len = TF_HEADER_LEN + (uint32_t)data_len + 1;
+        if (frame_len > HLK_FRAME_BUF_SIZE) {
+            if (g_parser.resync_pending) {
+                ESP_LOGD(TAG, "Frame too large: %lu bytes (max %d)",
+                         (unsigned long)frame_len, HLK_FRAME_BUF_SIZE);
+            } else {
+                ESP_LOGW(TAG, "Frame too large: %lu bytes (max %d)", 
+                         (unsigned long)frame_len, HLK_FRAME_BUF_SIZE);
+            }
+            g_parser_stats.oversize_frames++;
+            g_parser_stats.rejected_frames++;
+            return PARSE_ERROR;
+        }
+        g_parser.expected_frame_len = frame_len;
+        g_parser.cksum = 0;
+        return PARSE_PENDING;
+    }
+    
+    // Data bytes
+    if (g_parser.pos < g_parser.expected_frame_len) {
+        g_parser.cksum ^= byte;
+        return PARSE_PENDING;
+    }
+    
+    // Data checksum - frame complete
+    // Header LEN, non-zero and already bounded by the HLK_FRAME_BUF_SIZE check above
+    uint16_t data_len = read_uint16_be(&g_parser.frame_buf[3]);
+    uint8_t data_cksum_calc = ~g_parser.cksum;
+    if (data_cksum_calc != byte) {
+        if (g_parser.resync_pending) {
+            ESP_LOGD(TAG, "Data checksum failed: calc=0x%02X rx=0x%02X", data_cksum_calc, byte);
+        } else {
+            ESP_LOGW(TAG, "Data checksum failed: calc=0x%02X rx=0x%02X", data_cksum_calc, byte);
+        }
+        g_parser_stats.data_cksum_errors++;
+        g_parser_stats.rejected_frames++;
+        return PARSE_ERROR;
+    }
+    
+    return parser_complete(data_len);
+}
+
+// Recover from a rejected candidate frame. The bytes after its SOF may hold
+// the start of a real frame (a stray 0x01 in noise swallows the next header),
+// so they are replayed through the state machine instead of being discarded.
+// Candidates tried here fail quietly (LOGD, still counted in the stats).
+//
+// Every 0x01 in the replayed bytes is a candidate, and one built from noise
+// passes both XOR checksums about 1 time in 65536. In a randomized run
+// (200k frames, 10% with a bit flip, up to 7 junk bytes with 0x01 between
+// frames) 1-4 such false frames reached the callbacks per run, roughly 1 per
+// 40k recovered frames. Build with HLK_PARSER_RESYNC=0 if that matters more
+// than the frames recovered. Requiring a SOF right after a recovered frame
+// was tried: it dropped 40% of the real recoveries (junk follows them as
+// often as it precedes them) and only halved the false ones.
+// Returns number of frames recovered from the replayed bytes.
+static uint32_t parser_recover(void) {
+#if HLK_PARSER_RESYNC
+    uint32_t frames = 0;
+    uint16_t n = g_parser.pos;
+    uint16_t i = 1;  // Skip the rejected SOF
+    
+    // Replay in place: parser_step() writes at pos, which never overtakes i
+    parser_reset();
+    g_parser.resync_pending = true;
+    while (i < n) {
+        parse_status_t status = parser_step(g_parser.frame_buf[i++]);
+        if (status == PARSE_FRAME) {
+            frames++;
+            g_parser_stats.resyncs++;
+        } else if (status == PARSE_ERROR) {
+            // Another false start at frame_buf[0] - drop its SOF and splice
+            // the rest of it onto the bytes not yet replayed
+            uint16_t kept = g_parser.pos - 1;
+            memmove(&g_parser.frame_buf[0], &g_parser.frame_buf[1], kept);
+            memmove(&g_parser.frame_buf[kept], &g_parser.frame_buf[i], n - i);
+            n = kept + (n - i);
+            i = 0;
+            parser_reset();
+        }
+    }
+    
+    // A candidate still in progress started inside the rescanned bytes
+    g_parser.resync_pending = g_parser.syncing;
+    return frames;
+#else
+    parser_reset();
+    return 0;
+#endif
+}
+
+// Push one byte through the state machine, recovering on errors.
+// Returns number of frames dispatched.
+static uint32_t parser_push(uint8_t byte) {
+    switch (parser_step(byte)) {
+        case PARSE_FRAME:
+            if (g_parser.resync_pending) {
+                g_parser.resync_pending = false;
+                g_parser_stats.resyncs++;
+            }
+            return 1;
+            
+        case PARSE_ERROR:
+            g_parser.resync_pending = false;
+            return parser_recover();
+            
+        default:
+            return 0;
+    }
+}
+
+// Feed a chunk of raw UART bytes through the parser.
+// Noise between frames is skipped with memchr() and payload bytes are copied
+// in bulk; only header and checksum bytes go through parser_step().
+// Returns number of frames dispatched.
+static uint32_t parser_feed(const uint8_t *data, size_t len) {
+    uint32_t frames = 0;
+    
+    while (len > 0) {
+        if (!g_parser.syncing) {
+            const uint8_t *sof = memchr(data, TF_SOF, len);
+            if (!sof) {
+                break;
+            }
+            len -= sof - data;
+            data = sof;
+        } else if (g_parser.pos >= TF_HEADER_LEN && g_parser.pos + 1 < g_parser.expected_frame_len) {
+            size_t n = g_parser.expected_frame_len - 1 - g_parser.pos;
+            if (n > len) {
+                n = len;
+            }
+            uint8_t *dst = &g_parser.frame_buf[g_parser.pos];
+            uint8_t cksum = g_parser.cksum;
+            for (size_t i = 0; i < n; i++) {
+                dst[i] = data[i];
+                cksum ^= data[i];
+            }
+            g_parser.cksum = cksum;
+            g_parser.pos += n;
+            data += n;
+            len -= n;
+            continue;
+        }
+        
+        frames += parser_push(*data);
+        data++;
+        len--;
+    }
+    
+    return frames;
+}
+
+// ========== FRAME ENCODER ==========
+
+#define TF_AREA_PAYLOAD_LEN 28  // area_id (int32) + 6 floats
+
+// Encode one TinyFrame into out (TF_FRAME_OVERHEAD + len bytes, or
+// TF_HEADER_LEN for an empty frame, which has no DATA_CKSUM) with the next
+// host frame ID. Returns number of bytes written.
+static uint16_t encode_frame(uint8_t *out, uint16_t msg_type, const uint8_t *data, uint16_t len) {
+    out[0] = TF_SOF;
+    write_uint16_be(&out[1], g_tx_frame_id);
+    write_uint16_be(&out[3], len);
+    write_uint16_be(&out[5], msg_type);
+    out[7] = calc_checksum(out, 7);
+    g_tx_frame_id = (g_tx_frame_id + 1) & ~TF_ID_PEER_BIT;
+    
+    if (len == 0) {
+        return TF_HEADER_LEN;
+    }
+    memcpy(&out[TF_HEADER_LEN], data, len);
+    out[TF_HEADER_LEN + len] = calc_checksum(data, len);
+    return TF_HEADER_LEN + len + 1;
+}
+
+// Encode a 0x0202 payload
+static void encode_area(uint8_t *data, uint8_t area_id, const hlk_zone_t *zone) {
+    write_int32_le(&data[0], area_id);
+    write_coord_le(&data[4], zone->x_min);
+    write_coord_le(&data[8], zone->x_max);
+    write_coord_le(&data[12], zone->y_min);
+    write_coord_le(&data[16], zone->y_max);
+    write_coord_le(&data[20], zone->z_min);
+    write_coord_le(&data[24], zone->z_max);
+}
+
+// ========== API IMPLEMENTATION ==========
+
+esp_err_t hlk_ld6002_init(void) {
+    return hlk_port_uart_init();
 }
 
 void hlk_ld6002_register_callbacks(const hlk_callbacks_t* callbacks) {
@@ -322,96 +734,218 @@ void hlk_ld6002_register_callbacks(const hlk_callbacks_t* callbacks) {
 }
 
 void hlk_ld6002_send_command(uint32_t cmd) {
-    uint8_t frame[256];
-    uint8_t pos = 0;
-    
-    // Build frame header
-    frame[pos++] = TF_SOF;
-    write_uint16_be(&frame[pos], 0x0000);  // Frame ID = 0
-    pos += 2;
-    write_uint16_be(&frame[pos], 4);  // Data length = 4
-    pos += 2;
-    write_uint16_be(&frame[pos], MSG_CFG_HUMAN_DETECTION_3D);
-    pos += 2;
-    
-    // Calculate and add header checksum
-    frame[pos] = calc_checksum(frame, 7);
-    pos++;
-    
-    // Add data (command as int32_le)
+    uint8_t frame[TF_FRAME_OVERHEAD + 4];
     uint8_t data[4];
+    
     write_int32_le(data, cmd);
-    memcpy(&frame[pos], data, 4);
-    pos += 4;
+    uint16_t len = encode_frame(frame, MSG_CFG_HUMAN_DETECTION_3D, data, sizeof(data));
+    hlk_port_uart_write(frame, len);
     
-    // Calculate and add data checksum
-    frame[pos] = calc_checksum(data, 4);
-    pos++;
+    ESP_LOGI(TAG, "📤 Sent command 0x%02lX", cmd);
+    ESP_LOG_BUFFER_HEX_LEVEL(TAG, frame, len, ESP_LOG_DEBUG);
+}
+
+esp_err_t hlk_ld6002_set_area(uint8_t area_id, const hlk_zone_t* zone) {
+    uint8_t frame[TF_FRAME_OVERHEAD + TF_AREA_PAYLOAD_LEN];
+    uint8_t data[TF_AREA_PAYLOAD_LEN];
     
-    // Send frame
-    uart_write_bytes(HLK_LD6002_UART_PORT, frame, pos);
+    if (area_id >= HLK_AREA_COUNT || !zone) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    encode_area(data, area_id, zone);
+    uint16_t len = encode_frame(frame, MSG_CFG_HUMAN_DETECTION_3D_AREA, data, sizeof(data));
+    hlk_port_uart_write(frame, len);
     
-    ESP_LOGI(TAG, "📤 Sent command 0x%02lX", cmd);
-    ESP_LOG_BUFFER_HEX_LEVEL(TAG, frame, pos, ESP_LOG_DEBUG);
+    ESP_LOGI(TAG, "📤 Set %s zone %d", area_id < HLK_AREA_ID_DETECTION ? "interference" : "detection",
+             area_id % HLK_ZONE_COUNT);
+    return ESP_OK;
 }
 
-int hlk_ld6002_process(uint32_t timeout_ms) {
-    uint8_t byte;
-    int bytes_processed = 0;
-    int len = uart_read_bytes(HLK_LD6002_UART_PORT, &byte, 1, pdMS_TO_TICKS(timeout_ms));
+void hlk_ld6002_set_hold_delay(uint32_t seconds) {
+    uint8_t frame[TF_FRAME_OVERHEAD + 4];
+    uint8_t data[4];
     
-    if (len == 1) {
-        bytes_processed++;
-        
-        if (!g_parser.syncing) {
-            // Looking for SOF
-            if (byte == TF_SOF) {
-                g_parser.frame_buf[0] = byte;
-                g_parser.pos = 1;
-                g_parser.syncing = true;
-                g_parser.expected_frame_len = 0;
-                ESP_LOGD(TAG, "SOF detected");
-            }
+    write_uint32_le(data, seconds);
+    uint16_t len = encode_frame(frame, MSG_CFG_HUMAN_DETECTION_3D_PWM_DELAY, data, sizeof(data));
+    hlk_port_uart_write(frame, len);
+    
+    ESP_LOGI(TAG, "📤 Set hold delay %lu s", seconds);
+}
+
+void hlk_ld6002_set_z_range(float z_min, float z_max) {
+    uint8_t frame[TF_FRAME_OVERHEAD + 8];
+    uint8_t data[8];
+    
+    write_float_le(&data[0], z_min);
+    write_float_le(&data[4], z_max);
+    uint16_t len = encode_frame(frame, MSG_CFG_HUMAN_DETECTION_3D_Z, data, sizeof(data));
+    hlk_port_uart_write(frame, len);
+    
+    ESP_LOGI(TAG, "📤 Set Z range [%.2f to %.2f] m", z_min, z_max);
+}
+
+void hlk_ld6002_set_low_power_time(uint32_t ms) {
+    uint8_t frame[TF_FRAME_OVERHEAD + 4];
+    uint8_t data[4];
+    
+    write_uint32_le(data, ms);
+    uint16_t len = encode_frame(frame, MSG_CFG_HUMAN_DETECTION_3D_LOW_POWER_MODE_TIME, data, sizeof(data));
+    hlk_port_uart_write(frame, len);
+    
+    ESP_LOGI(TAG, "📤 Set low power sleep time %lu ms", ms);
+}
+
+// ========== BATCHED TRANSMIT ==========
+
+void hlk_tx_batch_init(hlk_tx_batch_t* batch) {
+    batch->len = 0;
+    batch->frames = 0;
+}
+
+esp_err_t hlk_tx_batch_add(hlk_tx_batch_t* batch, uint16_t msg_type, const uint8_t* data, uint16_t len) {
+    if ((size_t)batch->len + TF_FRAME_OVERHEAD + len > sizeof(batch->buf)) {
+        ESP_LOGW(TAG, "TX batch full (%d bytes), dropping type 0x%04X", batch->len, msg_type);
+        return ESP_ERR_NO_MEM;
+    }
+    batch->len += encode_frame(&batch->buf[batch->len], msg_type, data, len);
+    batch->frames++;
+    return ESP_OK;
+}
+
+esp_err_t hlk_tx_batch_add_command(hlk_tx_batch_t* batch, uint32_t cmd) {
+    uint8_t data[4];
+    write_int32_le(data, cmd);
+    return hlk_tx_batch_add(batch, MSG_CFG_HUMAN_DETECTION_3D, data, sizeof(data));
+}
+
+esp_err_t hlk_tx_batch_add_area(hlk_tx_batch_t* batch, uint8_t area_id, const hlk_zone_t* zone) {
+    uint8_t data[TF_AREA_PAYLOAD_LEN];
+    if (area_id >= HLK_AREA_COUNT || !zone) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    encode_area(data, area_id, zone);
+    return hlk_tx_batch_add(batch, MSG_CFG_HUMAN_DETECTION_3D_AREA, data, sizeof(data));
+}
+
+esp_err_t hlk_tx_batch_add_hold_delay(hlk_tx_batch_t* batch, uint32_t seconds) {
+    uint8_t data[4];
+    write_uint32_le(data, seconds);
+    return hlk_tx_batch_add(batch, MSG_CFG_HUMAN_DETECTION_3D_PWM_DELAY, data, sizeof(data));
+}
+
+esp_err_t hlk_tx_batch_add_z_range(hlk_tx_batch_t* batch, float z_min, float z_max) {
+    uint8_t data[8];
+    write_float_le(&data[0], z_min);
+    write_float_le(&data[4], z_max);
+    return hlk_tx_batch_add(batch, MSG_CFG_HUMAN_DETECTION_3D_Z, data, sizeof(data));
+}
+
+esp_err_t hlk_tx_batch_add_low_power_time(hlk_tx_batch_t* batch, uint32_t ms) {
+    uint8_t data[4];
+    write_uint32_le(data, ms);
+    return hlk_tx_batch_add(batch, MSG_CFG_HUMAN_DETECTION_3D_LOW_POWER_MODE_TIME, data, sizeof(data));
+}
+
+int hlk_tx_batch_send(hlk_tx_batch_t* batch) {
+    int written = 0;
+    if (batch->len > 0) {
+        written = hlk_port_uart_write(batch->buf, batch->len);
+        ESP_LOGI(TAG, "📤 Sent %d frames in one burst (%d bytes)", batch->frames, batch->len);
+        ESP_LOG_BUFFER_HEX_LEVEL(TAG, batch->buf, batch->len, ESP_LOG_DEBUG);
+    }
+    hlk_tx_batch_init(batch);
+    return written;
+}
+
+// RX overflow - the port has flushed its input, so the partial frame is gone
+static void handle_rx_overflow(void) {
+    g_parser_stats.rx_overflows++;
+    parser_reset();
+    g_parser.resync_pending = false;
+}
+
+uint32_t hlk_ld6002_feed(const uint8_t* data, size_t len) {
+    g_parser_stats.rx_bytes += len;
+    return parser_feed(data, len);
+}
+
+void hlk_ld6002_reset(void) {
+    parser_reset();
+    g_parser.resync_pending = false;
+    memset(&g_stats, 0, sizeof(g_stats));
+    memset(&g_parser_stats, 0, sizeof(g_parser_stats));
+}
+
+int hlk_ld6002_process_bulk(uint32_t timeout_ms, hlk_process_result_t *result) {
+    uint32_t bytes = 0;
+    uint32_t frames = 0;
+    
+    // Time the caller spent elsewhere since the last call returned
+    uint32_t now = hlk_port_millis();
+    if (g_parser_stats.process_calls > 0 && now - g_last_return_ms > g_parser_stats.max_read_gap_ms) {
+        g_parser_stats.max_read_gap_ms = now - g_last_return_ms;
+    }
+    g_parser_stats.process_calls++;
+    
+    // Nothing pending - block until the driver signals data or the timeout expires
+    size_t buffered = hlk_port_uart_buffered();
+    if (buffered == 0) {
+        hlk_port_event_t event = hlk_port_uart_wait(timeout_ms);
+        if (event == HLK_PORT_EVENT_NONE) {
+            g_parser_stats.wait_timeouts++;
         } else {
-            // Building frame
-            if (g_parser.pos < HLK_FRAME_BUF_SIZE) {
-                g_parser.frame_buf[g_parser.pos++] = byte;
-                
-                // After receiving first 7 bytes, calculate expected frame length
-                if (g_parser.pos == 7) {
-                    uint16_t data_len = read_uint16_be(&g_parser.frame_buf[3]);
-                    g_parser.expected_frame_len = 8 + data_len + 1;
-                    
-                    if (g_parser.expected_frame_len > HLK_FRAME_BUF_SIZE) {
-                        ESP_LOGW(TAG, "Frame too large: %d bytes (max %d)", 
-                                 g_parser.expected_frame_len, HLK_FRAME_BUF_SIZE);
-                        g_parser.syncing = false;
-                        g_parser.pos = 0;
-                    } else if (g_parser.expected_frame_len < 9) {
-                        ESP_LOGW(TAG, "Invalid frame length: %d", g_parser.expected_frame_len);
-                        g_parser.syncing = false;
-                        g_parser.pos = 0;
-                    }
-                }
-                
-                // Check if we have a complete frame
-                if (g_parser.expected_frame_len > 0 && g_parser.pos >= g_parser.expected_frame_len) {
-                    parse_tinyframe(g_parser.frame_buf, g_parser.expected_frame_len);
-                    g_parser.syncing = false;
-                    g_parser.pos = 0;
-                    g_parser.expected_frame_len = 0;
-                }
+            g_parser_stats.wakeups++;
+            if (event == HLK_PORT_EVENT_OVERFLOW) {
+                handle_rx_overflow();
             } else {
-                // Buffer overflow
-                ESP_LOGW(TAG, "Frame buffer overflow");
-                g_parser.syncing = false;
-                g_parser.pos = 0;
-                g_parser.expected_frame_len = 0;
+                buffered = hlk_port_uart_buffered();
             }
         }
     }
     
-    return bytes_processed;
+    // Drain everything the driver has buffered, bounded to one RX buffer's worth
+    // so a continuous stream cannot starve the caller
+    while (buffered > 0 && bytes < HLK_UART_BUF_SIZE * 2) {
+        size_t want = buffered < sizeof(g_rx_chunk) ? buffered : sizeof(g_rx_chunk);
+        int len = hlk_port_uart_read(g_rx_chunk, want);
+        g_parser_stats.rx_reads++;
+        if (len <= 0) {
+            break;
+        }
+        bytes += len;
+        frames += parser_feed(g_rx_chunk, len);
+        buffered = hlk_port_uart_buffered();
+    }
+    
+    // Events for data drained above are stale; consume them so the next call
+    // blocks instead of waking for nothing
+    while (bytes > 0) {
+        hlk_port_event_t event = hlk_port_uart_wait(0);
+        if (event == HLK_PORT_EVENT_NONE) {
+            break;
+        }
+        if (event == HLK_PORT_EVENT_OVERFLOW) {
+            handle_rx_overflow();
+            break;
+        }
+    }
+    
+    g_parser_stats.rx_bytes += bytes;
+    if (bytes > g_parser_stats.max_bytes_per_call) {
+        g_parser_stats.max_bytes_per_call = bytes;
+    }
+    
+    if (result) {
+        result->bytes = bytes;
+        result->frames = frames;
+    }
+    
+    g_last_return_ms = hlk_port_millis();
+    return (int)bytes;
+}
+
+int hlk_ld6002_process(uint32_t timeout_ms) {
+    return hlk_ld6002_process_bulk(timeout_ms, NULL);
 }
 
 void hlk_ld6002_get_stats(uint32_t* total_frames, uint32_t* target_frames, uint32_t* presence_frames) {
@@ -419,3 +953,9 @@ void hlk_ld6002_get_stats(uint32_t* total_frames, uint32_t* target_frames, uint3
     if (target_frames) *target_frames = g_stats.target_frames;
     if (presence_frames) *presence_frames = g_stats.presence_frames;
 }
+
+void hlk_ld6002_get_parser_stats(hlk_parser_stats_t* stats) {
+    if (stats) {
+        *stats = g_parser_stats;
+    }
+}
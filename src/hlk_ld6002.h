@@ -4,16 +4,18 @@
 #ifndef HLK_LD6002_H
 #define HLK_LD6002_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
-#include "driver/uart.h"
-#include "driver/gpio.h"
+#include <math.h>
+#include "esp_err.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 // ========== CONFIGURATION ==========
+// UART/pin values are only expanded by the platform port (hlk_port_esp.c)
 
 #ifndef HLK_LD6002_UART_PORT
 #define HLK_LD6002_UART_PORT UART_NUM_1
@@ -31,12 +33,45 @@ extern "C" {
 #define HLK_LD6002_BAUDRATE 115200  // Default for LD6002B-3D
 #endif
 
+#ifndef HLK_FIXED_POINT
+#define HLK_FIXED_POINT 0  // 1 = integer millimetre coordinates (the C3 has no FPU, floats are emulated)
+#endif
+
+#ifndef HLK_PARSER_RESYNC
+#define HLK_PARSER_RESYNC 1  // Rescan rejected frames for a later SOF instead of discarding them (rare false accepts, see parser_recover())
+#endif
+
 #define HLK_UART_BUF_SIZE 2048
 #define HLK_FRAME_BUF_SIZE 1152  // Max: 1 + 2 + 2 + 2 + 1 + 1024 + 1 = 1033 bytes
+#define HLK_RX_CHUNK_SIZE 256    // Bytes drained from the UART driver per read
+#define HLK_TX_BATCH_SIZE 512    // Bytes packed into one UART write by hlk_tx_batch_t
+
+// Targets decoded for the copying on_target callback. Defaults to the largest
+// report a frame that fits HLK_FRAME_BUF_SIZE can carry; lower it to save RAM
+// (larger reports are then truncated and counted in hlk_parser_stats_t)
+#ifndef HLK_MAX_TARGETS
+#define HLK_MAX_TARGETS ((HLK_FRAME_BUF_SIZE - TF_FRAME_OVERHEAD - 4) / HLK_TARGET_RECORD_SIZE)
+#endif
+
+// Largest point cloud a frame that fits HLK_FRAME_BUF_SIZE can carry
+#define HLK_MAX_CLOUD_POINTS ((HLK_FRAME_BUF_SIZE - TF_FRAME_OVERHEAD - 4) / HLK_CLOUD_RECORD_SIZE)
+
+#define HLK_UART_EVENT_QUEUE_LEN 20    // UART driver event queue depth
+#define HLK_UART_RX_TIMEOUT_SYMBOLS 4  // Idle symbols before an RX-timeout wakeup (end of frame burst)
+#define HLK_UART_RX_FULL_THRESHOLD 96  // FIFO fill level that wakes the reader mid-frame (FIFO is 128)
 
 // ========== TINYFRAME PROTOCOL ==========
 
 #define TF_SOF 0x01  // Start of Frame
+#define TF_FRAME_OVERHEAD 9    // SOF + ID + LEN + TYPE + HEAD_CKSUM + DATA_CKSUM
+#define TF_ID_PEER_BIT 0x8000  // Frame ID MSB - clear for frames sent by the host
+
+#define HLK_TARGET_RECORD_SIZE 20  // x, y, z (float), dop_idx, cluster_id (int32)
+#define HLK_ZONE_RECORD_SIZE 24    // x/y/z min/max (6 floats)
+#define HLK_CLOUD_RECORD_SIZE 20   // cluster_index (int32), x, y, z, speed (float)
+#define HLK_ZONE_COUNT 4           // Zones per 0x0A0B/0x0A0C report
+#define HLK_AREA_ID_DETECTION 4    // 0x0202 area_id: 0-3 interference, 4-7 detection
+#define HLK_AREA_COUNT 8
 
 // Command Message Types (Host → Radar)
 #define MSG_CFG_HUMAN_DETECTION_3D                      0x0201
@@ -101,37 +136,131 @@ typedef struct {
     uint8_t data_cksum;    // Data checksum
 } hlk_tinyframe_t;
 
+// Coordinate / speed representation, chosen at compile time.
+// Sensor floats are converted once at decode time; use the macros below
+// instead of assuming units so code builds with either representation.
+#if HLK_FIXED_POINT
+typedef int32_t hlk_coord_t;  // Millimetres (mm/s for speeds)
+#define HLK_COORD_FROM_M(m) ((hlk_coord_t)((m) * 1000.0f + ((m) >= 0 ? 0.5f : -0.5f)))  // Constants only
+#define HLK_COORD_FROM_MM(mm) ((hlk_coord_t)(mm))
+#define HLK_COORD_TO_M(c) ((float)(c) / 1000.0f)  // Logging / JSON only
+#define HLK_COORD_TO_MM(c) ((int32_t)(c))
+#else
+typedef float hlk_coord_t;    // Meters (m/s for speeds)
+#define HLK_COORD_FROM_M(m) ((hlk_coord_t)(m))
+#define HLK_COORD_FROM_MM(mm) ((hlk_coord_t)(mm) / 1000.0f)
+#define HLK_COORD_TO_M(c) ((float)(c))
+#define HLK_COORD_TO_MM(c) ((int32_t)lroundf((c) * 1000.0f))
+#endif
+
 // Target data
 typedef struct {
-    float x;            // X coordinate (meters)
-    float y;            // Y coordinate (meters)
-    float z;            // Z coordinate (meters)
-    int32_t velocity;   // Doppler velocity index
+    hlk_coord_t x;      // X coordinate
+    hlk_coord_t y;      // Y coordinate
+    hlk_coord_t z;      // Z coordinate
+    int32_t velocity;   // Doppler velocity index (0 for clustered targets)
+    hlk_coord_t speed;  // Mean radial speed per second (clustered targets only, 0 from the sensor)
     int32_t cluster_id; // Cluster ID
+    uint16_t track_id;  // Stable ID from kalman_tracker (0 = untracked detection)
 } hlk_target_t;
 
 // Zone bounds
 typedef struct {
-    float x_min;
-    float x_max;
-    float y_min;
-    float y_max;
-    float z_min;
-    float z_max;
+    hlk_coord_t x_min;
+    hlk_coord_t x_max;
+    hlk_coord_t y_min;
+    hlk_coord_t y_max;
+    hlk_coord_t z_min;
+    hlk_coord_t z_max;
 } hlk_zone_t;
 
+// Zero-copy view over a validated target report (0x0A04).
+// Points into the parser's frame buffer - only valid inside the callback.
+typedef struct {
+    const uint8_t *records;  // First target record (HLK_TARGET_RECORD_SIZE bytes each)
+    int32_t count;           // Number of target records
+} hlk_target_view_t;
+
+// Zero-copy view over a validated zone report (0x0A0B / 0x0A0C).
+// Points into the parser's frame buffer - only valid inside the callback.
+typedef struct {
+    const uint8_t *records;  // HLK_ZONE_COUNT zone records (HLK_ZONE_RECORD_SIZE bytes each)
+    bool is_interference;    // true for interference zones, false for detection zones
+} hlk_zone_view_t;
+
+// Decoded point cloud report (0x0A08), structure-of-arrays.
+// Owned by the driver and overwritten by the next frame - only valid inside the callback.
+typedef struct {
+    int32_t count;                          // Points decoded
+    int32_t cluster[HLK_MAX_CLOUD_POINTS];  // Cluster index (points at similar range share one)
+    hlk_coord_t x[HLK_MAX_CLOUD_POINTS];      // X coordinate
+    hlk_coord_t y[HLK_MAX_CLOUD_POINTS];      // Y coordinate
+    hlk_coord_t z[HLK_MAX_CLOUD_POINTS];      // Z coordinate
+    hlk_coord_t speed[HLK_MAX_CLOUD_POINTS];  // Radial speed
+} hlk_point_cloud_t;
+
 // Parsed message callback types
 typedef void (*hlk_target_callback_t)(const hlk_target_t* targets, int32_t count);
 typedef void (*hlk_presence_callback_t)(uint32_t zone0, uint32_t zone1, uint32_t zone2, uint32_t zone3);
 typedef void (*hlk_zones_callback_t)(const hlk_zone_t* zones, bool is_interference);
 typedef void (*hlk_config_callback_t)(uint16_t msg_type, const uint8_t* data, uint16_t len);
+typedef void (*hlk_target_view_callback_t)(const hlk_target_view_t* view);
+typedef void (*hlk_zones_view_callback_t)(const hlk_zone_view_t* view);
+typedef void (*hlk_frame_callback_t)(uint16_t msg_type, const uint8_t* data, uint16_t len);
+typedef void (*hlk_point_cloud_callback_t)(const hlk_point_cloud_t* cloud);
+
+// Outgoing frames packed into a single UART write.
+// Large (HLK_TX_BATCH_SIZE) - keep it static or on a task with stack to spare.
+typedef struct {
+    uint8_t buf[HLK_TX_BATCH_SIZE];
+    uint16_t len;     // Bytes encoded so far
+    uint8_t frames;   // Frames encoded so far
+} hlk_tx_batch_t;
+
+// Result of a single hlk_ld6002_process_bulk() call
+typedef struct {
+    uint32_t bytes;   // Bytes drained from the UART and parsed
+    uint32_t frames;  // Valid frames dispatched to callbacks
+} hlk_process_result_t;
+
+// UART ingestion and parser statistics
+typedef struct {
+    uint32_t process_calls;       // hlk_ld6002_process*() invocations
+    uint32_t rx_reads;            // uart_read_bytes() calls issued
+    uint32_t rx_bytes;            // Total bytes drained from the UART
+    uint32_t max_bytes_per_call;  // Largest drain in a single call
+    uint32_t frames;              // Frames that passed both checksums
+    uint32_t rejected_frames;     // Frames dropped on checksum or length errors
+    uint32_t header_cksum_errors; // Rejected: header checksum mismatch
+    uint32_t data_cksum_errors;   // Rejected: data checksum mismatch
+    uint32_t oversize_frames;     // Rejected: LEN exceeds HLK_FRAME_BUF_SIZE
+    uint32_t resyncs;             // Frames recovered by rescanning rejected bytes
+    uint32_t wakeups;             // UART events that woke the reader
+    uint32_t wait_timeouts;       // Waits that expired with no UART event
+    uint32_t rx_overflows;        // FIFO/ring buffer overflows (input flushed)
+    uint32_t truncated_frames;    // Target reports clipped to HLK_MAX_TARGETS for on_target
+    uint32_t truncated_targets;   // Targets dropped by that clipping
+    uint32_t malformed_targets;   // Target reports whose count exceeds the frame length
+    uint64_t dispatch_cycles;     // CPU cycles spent decoding frames and in callbacks
+    uint32_t max_read_gap_ms;     // Longest time between hlk_ld6002_process*() calls (UART unread)
+} hlk_parser_stats_t;
 
 // Sensor callbacks structure
+// The view callbacks read fields in place from the frame buffer. on_target and
+// on_zones are the copying compatibility layer: the payload is only decoded
+// into hlk_target_t / hlk_zone_t arrays (and zones only logged) when they
+// are registered.
+// on_frame sees every validated frame (including ACKs) before it is dispatched.
+// Point cloud frames are only decoded when on_point_cloud is registered.
 typedef struct {
     hlk_target_callback_t on_target;
     hlk_presence_callback_t on_presence;
     hlk_zones_callback_t on_zones;
     hlk_config_callback_t on_config;
+    hlk_target_view_callback_t on_target_view;
+    hlk_zones_view_callback_t on_zones_view;
+    hlk_frame_callback_t on_frame;
+    hlk_point_cloud_callback_t on_point_cloud;
 } hlk_callbacks_t;
 
 // ========== API FUNCTIONS ==========
@@ -154,6 +283,88 @@ void hlk_ld6002_register_callbacks(const hlk_callbacks_t* callbacks);
  */
 void hlk_ld6002_send_command(uint32_t cmd);
 
+/**
+ * Set one zone's bounds (MSG_CFG_HUMAN_DETECTION_3D_AREA)
+ * @param area_id 0-3 interference zones, 4-7 detection zones
+ * @param zone Zone bounds in meters
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an invalid area_id
+ */
+esp_err_t hlk_ld6002_set_area(uint8_t area_id, const hlk_zone_t* zone);
+
+/**
+ * Set presence hold delay (MSG_CFG_HUMAN_DETECTION_3D_PWM_DELAY)
+ * @param seconds Hold time after the last detection
+ */
+void hlk_ld6002_set_hold_delay(uint32_t seconds);
+
+/**
+ * Set Z-axis detection range (MSG_CFG_HUMAN_DETECTION_3D_Z, 3D mode only)
+ * @param z_min Minimum Z in meters
+ * @param z_max Maximum Z in meters
+ */
+void hlk_ld6002_set_z_range(float z_min, float z_max);
+
+/**
+ * Set low-power mode sleep time (MSG_CFG_HUMAN_DETECTION_3D_LOW_POWER_MODE_TIME)
+ * @param ms Sleep time in milliseconds
+ */
+void hlk_ld6002_set_low_power_time(uint32_t ms);
+
+/**
+ * Reset a TX batch to empty
+ * Frames added to a batch go out in one UART write from hlk_tx_batch_send(),
+ * e.g. all four detection zones plus the Z range in a single burst.
+ * @param batch Batch to initialize
+ */
+void hlk_tx_batch_init(hlk_tx_batch_t* batch);
+
+/**
+ * Encode an arbitrary frame into the batch (assigns the next frame ID)
+ * @param batch Batch to append to
+ * @param msg_type Message type
+ * @param data Payload (little-endian fields), may be NULL if len is 0
+ * @param len Payload length
+ * @return ESP_OK, or ESP_ERR_NO_MEM if the frame does not fit
+ */
+esp_err_t hlk_tx_batch_add(hlk_tx_batch_t* batch, uint16_t msg_type, const uint8_t* data, uint16_t len);
+
+/**
+ * Encode a control command (MSG_CFG_HUMAN_DETECTION_3D)
+ * @return ESP_OK, or ESP_ERR_NO_MEM if the frame does not fit
+ */
+esp_err_t hlk_tx_batch_add_command(hlk_tx_batch_t* batch, uint32_t cmd);
+
+/**
+ * Encode a zone update (MSG_CFG_HUMAN_DETECTION_3D_AREA)
+ * @return ESP_OK, ESP_ERR_NO_MEM if the frame does not fit, ESP_ERR_INVALID_ARG for an invalid area_id
+ */
+esp_err_t hlk_tx_batch_add_area(hlk_tx_batch_t* batch, uint8_t area_id, const hlk_zone_t* zone);
+
+/**
+ * Encode a hold delay update (MSG_CFG_HUMAN_DETECTION_3D_PWM_DELAY)
+ * @return ESP_OK, or ESP_ERR_NO_MEM if the frame does not fit
+ */
+esp_err_t hlk_tx_batch_add_hold_delay(hlk_tx_batch_t* batch, uint32_t seconds);
+
+/**
+ * Encode a Z-range update (MSG_CFG_HUMAN_DETECTION_3D_Z)
+ * @return ESP_OK, or ESP_ERR_NO_MEM if the frame does not fit
+ */
+esp_err_t hlk_tx_batch_add_z_range(hlk_tx_batch_t* batch, float z_min, float z_max);
+
+/**
+ * Encode a low-power sleep time update (MSG_CFG_HUMAN_DETECTION_3D_LOW_POWER_MODE_TIME)
+ * @return ESP_OK, or ESP_ERR_NO_MEM if the frame does not fit
+ */
+esp_err_t hlk_tx_batch_add_low_power_time(hlk_tx_batch_t* batch, uint32_t ms);
+
+/**
+ * Write every encoded frame in one UART call and empty the batch
+ * @param batch Batch to send
+ * @return Bytes written
+ */
+int hlk_tx_batch_send(hlk_tx_batch_t* batch);
+
 /**
  * Parse incoming UART data and trigger callbacks
  * Should be called continuously from a task
@@ -162,6 +373,30 @@ void hlk_ld6002_send_command(uint32_t cmd);
  */
 int hlk_ld6002_process(uint32_t timeout_ms);
 
+/**
+ * Drain all data buffered by the UART driver and parse every complete frame
+ * Blocks on the UART event queue for up to timeout_ms only if nothing is pending,
+ * so the caller wakes as soon as the driver signals RX-timeout or FIFO-full
+ * @param timeout_ms Maximum time to wait for the first byte
+ * @param result Bytes and frames handled by this call (output, may be NULL)
+ * @return Number of bytes processed
+ */
+int hlk_ld6002_process_bulk(uint32_t timeout_ms, hlk_process_result_t* result);
+
+/**
+ * Feed raw bytes straight into the frame parser, bypassing the UART
+ * Used by host-side fuzzing and benchmarks
+ * @param data Raw bytes as received from the sensor
+ * @param len Number of bytes
+ * @return Number of valid frames dispatched
+ */
+uint32_t hlk_ld6002_feed(const uint8_t* data, size_t len);
+
+/**
+ * Discard any partially received frame and clear all statistics
+ */
+void hlk_ld6002_reset(void);
+
 /**
  * Get frame statistics
  * @param total_frames Total frames received (output)
@@ -170,16 +405,83 @@ int hlk_ld6002_process(uint32_t timeout_ms);
  */
 void hlk_ld6002_get_stats(uint32_t* total_frames, uint32_t* target_frames, uint32_t* presence_frames);
 
+/**
+ * Get UART ingestion and parser statistics
+ * @param stats Statistics snapshot (output)
+ */
+void hlk_ld6002_get_parser_stats(hlk_parser_stats_t* stats);
+
+// ========== FRAME VIEW ACCESSORS ==========
+
+/**
+ * Read a target's coordinates from a target view
+ * @param view Target view passed to on_target_view
+ * @param index Target index (0 to view->count - 1)
+ * @return Coordinate (hlk_coord_t units)
+ */
+hlk_coord_t hlk_target_view_x(const hlk_target_view_t* view, int32_t index);
+hlk_coord_t hlk_target_view_y(const hlk_target_view_t* view, int32_t index);
+hlk_coord_t hlk_target_view_z(const hlk_target_view_t* view, int32_t index);
+
+/**
+ * Read a target's Doppler velocity index from a target view
+ * @param view Target view passed to on_target_view
+ * @param index Target index (0 to view->count - 1)
+ * @return Doppler velocity index
+ */
+int32_t hlk_target_view_velocity(const hlk_target_view_t* view, int32_t index);
+
+/**
+ * Read a target's cluster ID from a target view
+ * @param view Target view passed to on_target_view
+ * @param index Target index (0 to view->count - 1)
+ * @return Cluster ID
+ */
+int32_t hlk_target_view_cluster_id(const hlk_target_view_t* view, int32_t index);
+
+/**
+ * Decode a single target from a target view
+ * @param view Target view passed to on_target_view
+ * @param index Target index (0 to view->count - 1)
+ * @param target Decoded target (output)
+ */
+void hlk_target_view_get(const hlk_target_view_t* view, int32_t index, hlk_target_t* target);
+
+/**
+ * Decode a single zone from a zone view
+ * @param view Zone view passed to on_zones_view
+ * @param index Zone index (0 to HLK_ZONE_COUNT - 1)
+ * @param zone Decoded zone bounds (output)
+ */
+void hlk_zone_view_get(const hlk_zone_view_t* view, int index, hlk_zone_t* zone);
+
 // ========== UTILITY FUNCTIONS ==========
 
 /**
- * Calculate 3D distance from origin
+ * Calculate 3D distance from origin (integer square root in fixed-point builds)
  * @param x X coordinate
  * @param y Y coordinate
  * @param z Z coordinate
  * @return Distance in same units as input
  */
-float hlk_calc_distance_3d(float x, float y, float z);
+hlk_coord_t hlk_calc_distance_3d(hlk_coord_t x, hlk_coord_t y, hlk_coord_t z);
+
+/**
+ * Integer square root
+ * @param value Radicand
+ * @return floor(sqrt(value))
+ */
+uint32_t hlk_isqrt(uint64_t value);
+
+/**
+ * Check whether a point lies inside zone bounds (inclusive)
+ * @param zone Zone bounds
+ * @param x X coordinate
+ * @param y Y coordinate
+ * @param z Z coordinate
+ * @return true if inside
+ */
+bool hlk_zone_contains(const hlk_zone_t* zone, hlk_coord_t x, hlk_coord_t y, hlk_coord_t z);
 
 /**
  * Convert sensitivity level to string
@@ -0,0 +1,102 @@
+// HLK-LD6002 Platform Port
+// Thin seam between the TinyFrame driver and the platform (UART, time, locks),
+// so hlk_ld6002.c and the processing modules can also be built on a host for
+// fuzzing and benchmarks
+
+#ifndef HLK_PORT_H
+#define HLK_PORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// UART driver events, as seen by the frame parser
+typedef enum {
+    HLK_PORT_EVENT_NONE,      // Wait timed out, nothing signalled
+    HLK_PORT_EVENT_DATA,      // RX data available (or a non-fatal line event)
+    HLK_PORT_EVENT_OVERFLOW   // RX overflow - buffered input has been flushed
+} hlk_port_event_t;
+
+/**
+ * Install and configure the sensor UART
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t hlk_port_uart_init(void);
+
+/**
+ * Wait for the next UART driver event
+ * @param timeout_ms Maximum time to block (0 = only consume an already queued event)
+ * @return Event type, HLK_PORT_EVENT_NONE on timeout
+ */
+hlk_port_event_t hlk_port_uart_wait(uint32_t timeout_ms);
+
+/**
+ * Get number of received bytes buffered by the UART driver
+ * @return Bytes available to hlk_port_uart_read() without blocking
+ */
+size_t hlk_port_uart_buffered(void);
+
+/**
+ * Read buffered bytes without blocking
+ * @param buf Destination buffer
+ * @param len Maximum bytes to read
+ * @return Bytes read, or negative on error
+ */
+int hlk_port_uart_read(uint8_t *buf, size_t len);
+
+/**
+ * Queue bytes for transmission to the sensor
+ * @param buf Bytes to send
+ * @param len Number of bytes
+ * @return Bytes queued, or negative on error
+ */
+int hlk_port_uart_write(const uint8_t *buf, size_t len);
+
+/**
+ * Get monotonic time
+ * @return Milliseconds since boot
+ */
+uint32_t hlk_port_millis(void);
+
+/**
+ * Get high-resolution monotonic time, for profiling short code paths
+ * @return Microseconds since boot (wraps after ~71 minutes; use differences)
+ */
+uint32_t hlk_port_micros(void);
+
+/**
+ * Read the CPU cycle counter, for per-frame cost accounting
+ * @return Free-running cycle count (wraps; use differences)
+ */
+uint32_t hlk_port_cycles(void);
+
+// Opaque mutex handle (FreeRTOS mutex on the device, pthread mutex on a host)
+typedef void *hlk_port_mutex_t;
+
+/**
+ * Create a mutex
+ * @return Mutex handle, or NULL if out of memory
+ */
+hlk_port_mutex_t hlk_port_mutex_create(void);
+
+/**
+ * Take a mutex, waiting as long as needed
+ * @param mutex Mutex handle (NULL is ignored)
+ */
+void hlk_port_mutex_lock(hlk_port_mutex_t mutex);
+
+/**
+ * Release a mutex
+ * @param mutex Mutex handle (NULL is ignored)
+ */
+void hlk_port_mutex_unlock(hlk_port_mutex_t mutex);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HLK_PORT_H
@@ -0,0 +1,108 @@
+// HLK-LD6002 Platform Port - ESP-IDF Implementation
+// UART driver with event queue, FreeRTOS tick time
+
+#include "hlk_port.h"
+#include "hlk_ld6002.h"
+#include "driver/uart.h"
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+static const char *TAG = "HLK-Port";
+
+// UART driver event queue
+static QueueHandle_t g_uart_queue = NULL;
+
+esp_err_t hlk_port_uart_init(void) {
+    const uart_config_t uart_config = {
+        .baud_rate = HLK_LD6002_BAUDRATE,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .source_clk = UART_SCLK_DEFAULT,
+    };
+
+    ESP_ERROR_CHECK(uart_driver_install(HLK_LD6002_UART_PORT, HLK_UART_BUF_SIZE * 2, 0,
+                                        HLK_UART_EVENT_QUEUE_LEN, &g_uart_queue, 0));
+    ESP_ERROR_CHECK(uart_param_config(HLK_LD6002_UART_PORT, &uart_config));
+    ESP_ERROR_CHECK(uart_set_pin(HLK_LD6002_UART_PORT, HLK_LD6002_TX_PIN, HLK_LD6002_RX_PIN,
+                                 UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE));
+    
+    // Wake the reader when a frame burst ends or the FIFO is filling up
+    ESP_ERROR_CHECK(uart_set_rx_timeout(HLK_LD6002_UART_PORT, HLK_UART_RX_TIMEOUT_SYMBOLS));
+    ESP_ERROR_CHECK(uart_set_rx_full_threshold(HLK_LD6002_UART_PORT, HLK_UART_RX_FULL_THRESHOLD));
+    
+    ESP_LOGI(TAG, "Initialized UART%d (TX:%d RX:%d @ %d baud)",
+             HLK_LD6002_UART_PORT, HLK_LD6002_TX_PIN, HLK_LD6002_RX_PIN, HLK_LD6002_BAUDRATE);
+    
+    return ESP_OK;
+}
+
+hlk_port_event_t hlk_port_uart_wait(uint32_t timeout_ms) {
+    uart_event_t event;
+    if (xQueueReceive(g_uart_queue, &event, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        return HLK_PORT_EVENT_NONE;
+    }
+    
+    switch (event.type) {
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL:
+            // Data already lost - start clean
+            ESP_LOGW(TAG, "UART RX overflow (%s), flushing input",
+                     event.type == UART_FIFO_OVF ? "FIFO" : "ring buffer");
+            uart_flush_input(HLK_LD6002_UART_PORT);
+            xQueueReset(g_uart_queue);
+            return HLK_PORT_EVENT_OVERFLOW;
+            
+        case UART_DATA:
+            return HLK_PORT_EVENT_DATA;
+            
+        default:
+            ESP_LOGD(TAG, "UART event type %d", event.type);
+            return HLK_PORT_EVENT_DATA;
+    }
+}
+
+size_t hlk_port_uart_buffered(void) {
+    size_t buffered = 0;
+    uart_get_buffered_data_len(HLK_LD6002_UART_PORT, &buffered);
+    return buffered;
+}
+
+int hlk_port_uart_read(uint8_t *buf, size_t len) {
+    return uart_read_bytes(HLK_LD6002_UART_PORT, buf, len, 0);
+}
+
+int hlk_port_uart_write(const uint8_t *buf, size_t len) {
+    return uart_write_bytes(HLK_LD6002_UART_PORT, buf, len);
+}
+
+uint32_t hlk_port_millis(void) {
+    return xTaskGetTickCount() * portTICK_PERIOD_MS;
+}
+
+uint32_t hlk_port_micros(void) {
+    return (uint32_t)esp_timer_get_time();
+}
+
+uint32_t hlk_port_cycles(void) {
+    return (uint32_t)esp_cpu_get_cycle_count();
+}
+
+hlk_port_mutex_t hlk_port_mutex_create(void) {
+    return (hlk_port_mutex_t)xSemaphoreCreateMutex();
+}
+
+void hlk_port_mutex_lock(hlk_port_mutex_t mutex) {
+    if (mutex) xSemaphoreTake((SemaphoreHandle_t)mutex, portMAX_DELAY);
+}
+
+void hlk_port_mutex_unlock(hlk_port_mutex_t mutex) {
+    if (mutex) xSemaphoreGive((SemaphoreHandle_t)mutex);
+}
@@ -0,0 +1,356 @@
+// Kalman Tracker Implementation
+//
+// Each track runs a constant-velocity Kalman filter per axis (x, y, z are
+// filtered independently, so the covariance is three 2x2 blocks rather than
+// one 6x6 matrix). Every cycle all tracks are predicted to the current frame,
+// detections are assigned with the Hungarian algorithm on Mahalanobis cost,
+// where each track may also take a "missed" column costing exactly the gate,
+// and unassigned detections outside every gate start tentative tracks.
+// Track slots, detections and the cost matrix are fixed-size static arrays,
+// so both memory and the per-cycle work are bounded by KALMAN_MAX_TRACKS and
+// KALMAN_MAX_MEASUREMENTS. The filter runs in float (meters, seconds)
+// regardless of HLK_FIXED_POINT.
+
+#include "kalman_tracker.h"
+#include "hlk_port.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "Kalman";
+
+#define KALMAN_COLS (KALMAN_MAX_MEASUREMENTS + KALMAN_MAX_TRACKS)  // Detections + one "missed" column per track
+#define KALMAN_COST_INF 1e9f
+#define KALMAN_DT_DEFAULT_MS 100  // First cycle (no previous timestamp)
+
+typedef struct {
+    bool active;
+    bool confirmed;
+    uint16_t id;
+    uint8_t hits;                 // Consecutive associated cycles (saturating)
+    uint8_t misses;               // Consecutive missed cycles
+    float pos[3];                 // Position per axis (m)
+    float vel[3];                 // Velocity per axis (m/s)
+    float p00[3], p01[3], p11[3]; // Per-axis covariance [pos, vel]
+    int32_t velocity;             // Doppler index of the last matched detection
+    hlk_coord_t speed;            // Radial speed of the last matched detection
+    int32_t cluster_id;           // Cluster ID of the last matched detection
+} track_t;
+
+// ========== GLOBAL STATE ==========
+
+static bool g_enabled = KALMAN_TRACKER_DEFAULT_ENABLED;
+static track_t g_tracks[KALMAN_MAX_TRACKS];
+static uint16_t g_next_id = 1;
+static uint32_t g_last_update_ms = 0;
+static volatile bool g_reset_pending = false;  // Set by kalman_tracker_set_enabled()
+
+// Per-cycle scratch
+static float g_meas[KALMAN_MAX_MEASUREMENTS][3];
+static bool g_meas_gated[KALMAN_MAX_MEASUREMENTS];     // Inside some track's gate
+static int8_t g_meas_track[KALMAN_MAX_MEASUREMENTS];   // Assigned track slot, -1 if none
+static uint8_t g_rows[KALMAN_MAX_TRACKS];              // Cost matrix row → track slot
+static float g_cost[KALMAN_MAX_TRACKS][KALMAN_COLS];
+
+// Hungarian algorithm state (1-based, index 0 is the virtual start)
+static float g_u[KALMAN_MAX_TRACKS + 1];
+static float g_v[KALMAN_COLS + 1];
+static float g_minv[KALMAN_COLS + 1];
+static uint8_t g_match[KALMAN_COLS + 1];  // Column → row (0 = free)
+static uint8_t g_way[KALMAN_COLS + 1];
+static bool g_used[KALMAN_COLS + 1];
+
+static kalman_tracker_stats_t g_kalman_stats = {0};
+
+// ========== FILTER ==========
+
+static void track_predict(track_t *t, float dt) {
+    const float q = KALMAN_ACCEL_STD * KALMAN_ACCEL_STD;
+    const float dt2 = dt * dt;
+
+    for (int a = 0; a < 3; a++) {
+        t->pos[a] += t->vel[a] * dt;
+        t->p00[a] += 2.0f * dt * t->p01[a] + dt2 * t->p11[a] + q * dt2 * dt / 3.0f;
+        t->p01[a] += dt * t->p11[a] + q * dt2 / 2.0f;
+        t->p11[a] += q * dt;
+    }
+}
+
+// Mahalanobis distance² of a detection from the predicted position
+static float track_cost(const track_t *t, const float *z) {
+    const float r = KALMAN_MEAS_STD_M * KALMAN_MEAS_STD_M;
+    float d2 = 0.0f;
+
+    for (int a = 0; a < 3; a++) {
+        float innov = z[a] - t->pos[a];
+        d2 += innov * innov / (t->p00[a] + r);
+    }
+    return d2;
+}
+
+static void track_correct(track_t *t, const float *z) {
+    const float r = KALMAN_MEAS_STD_M * KALMAN_MEAS_STD_M;
+
+    for (int a = 0; a < 3; a++) {
+        float s = t->p00[a] + r;
+        float k0 = t->p00[a] / s;
+        float k1 = t->p01[a] / s;
+        float innov = z[a] - t->pos[a];
+
+        t->pos[a] += k0 * innov;
+        t->vel[a] += k1 * innov;
+        t->p11[a] -= k1 * t->p01[a];
+        t->p00[a] *= 1.0f - k0;
+        t->p01[a] *= 1.0f - k0;
+    }
+}
+
+static void track_birth(track_t *t, const float *z, const hlk_target_t *det) {
+    memset(t, 0, sizeof(*t));
+    t->active = true;
+    t->id = g_next_id++;
+    if (g_next_id == 0) g_next_id = 1;  // 0 means untracked
+    t->hits = 1;
+    t->velocity = det->velocity;
+    t->speed = det->speed;
+    t->cluster_id = det->cluster_id;
+
+    for (int a = 0; a < 3; a++) {
+        t->pos[a] = z[a];
+        t->p00[a] = KALMAN_MEAS_STD_M * KALMAN_MEAS_STD_M;
+        t->p11[a] = KALMAN_INIT_VEL_STD * KALMAN_INIT_VEL_STD;
+    }
+}
+
+// ========== ASSOCIATION ==========
+
+// Minimum-cost assignment of rows to columns (rows <= cols), O(rows² * cols).
+// Leaves the row assigned to each column in g_match[1..cols].
+static void hungarian(int rows, int cols) {
+    for (int j = 0; j <= cols; j++) {
+        g_v[j] = 0.0f;
+        g_match[j] = 0;
+    }
+    for (int i = 0; i <= rows; i++) {
+        g_u[i] = 0.0f;
+    }
+
+    for (int i = 1; i <= rows; i++) {
+        int j0 = 0;
+        g_match[0] = (uint8_t)i;
+        for (int j = 0; j <= cols; j++) {
+            g_minv[j] = KALMAN_COST_INF;
+            g_used[j] = false;
+        }
+
+        // Grow an alternating tree until it reaches a free column
+        do {
+            g_used[j0] = true;
+            int i0 = g_match[j0];
+            float delta = KALMAN_COST_INF;
+            int j1 = 0;
+
+            for (int j = 1; j <= cols; j++) {
+                if (g_used[j]) continue;
+                float cur = g_cost[i0 - 1][j - 1] - g_u[i0] - g_v[j];
+                if (cur < g_minv[j]) {
+                    g_minv[j] = cur;
+                    g_way[j] = (uint8_t)j0;
+                }
+                if (g_minv[j] < delta) {
+                    delta = g_minv[j];
+                    j1 = j;
+                }
+            }
+            for (int j = 0; j <= cols; j++) {
+                if (g_used[j]) {
+                    g_u[g_match[j]] += delta;
+                    g_v[j] -= delta;
+                } else {
+                    g_minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (g_match[j0] != 0);
+
+        // Flip the augmenting path
+        do {
+            int j1 = g_way[j0];
+            g_match[j0] = g_match[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+}
+
+// ========== API IMPLEMENTATION ==========
+
+void kalman_tracker_init(void) {
+    memset(g_tracks, 0, sizeof(g_tracks));
+    memset(&g_kalman_stats, 0, sizeof(g_kalman_stats));
+    g_next_id = 1;
+    g_last_update_ms = 0;
+    g_enabled = KALMAN_TRACKER_DEFAULT_ENABLED;
+    ESP_LOGI(TAG, "Tracker initialized (%d tracks, %s)", KALMAN_MAX_TRACKS,
+             g_enabled ? "enabled" : "disabled");
+}
+
+void kalman_tracker_set_enabled(bool enabled) {
+    if (enabled && !g_enabled) {
+        // Stale tracks would coast from wherever they were last seen. Called
+        // from the sensor task, so the publish task clears them on its next update
+        g_reset_pending = true;
+    }
+    g_enabled = enabled;
+    ESP_LOGI(TAG, "🛰️  Tracking %s", enabled ? "enabled" : "disabled");
+}
+
+bool kalman_tracker_is_enabled(void) {
+    return g_enabled;
+}
+
+int32_t kalman_tracker_update(const hlk_target_t* detections, int32_t count, hlk_target_t* tracks) {
+    uint32_t start_us = hlk_port_micros();
+    uint32_t now = hlk_port_millis();
+    int32_t m = count < KALMAN_MAX_MEASUREMENTS ? count : KALMAN_MAX_MEASUREMENTS;
+    int rows = 0;
+
+    if (m < 0) m = 0;
+    if (count > m) {
+        g_kalman_stats.dropped_detections += count - m;
+    }
+
+    if (g_reset_pending) {
+        g_reset_pending = false;
+        memset(g_tracks, 0, sizeof(g_tracks));
+        g_last_update_ms = 0;
+    }
+
+    // Time step since the previous cycle
+    uint32_t dt_ms = g_last_update_ms ? now - g_last_update_ms : KALMAN_DT_DEFAULT_MS;
+    if (dt_ms < KALMAN_DT_MIN_MS) dt_ms = KALMAN_DT_MIN_MS;
+    if (dt_ms > KALMAN_DT_MAX_MS) dt_ms = KALMAN_DT_MAX_MS;
+    g_last_update_ms = now;
+    float dt = dt_ms / 1000.0f;
+
+    for (int k = 0; k < KALMAN_MAX_TRACKS; k++) {
+        if (g_tracks[k].active) {
+            track_predict(&g_tracks[k], dt);
+            g_rows[rows++] = (uint8_t)k;
+        }
+    }
+
+    for (int32_t j = 0; j < m; j++) {
+        g_meas[j][0] = HLK_COORD_TO_M(detections[j].x);
+        g_meas[j][1] = HLK_COORD_TO_M(detections[j].y);
+        g_meas[j][2] = HLK_COORD_TO_M(detections[j].z);
+        g_meas_gated[j] = false;
+        g_meas_track[j] = -1;
+    }
+
+    if (rows > 0) {
+        // Cost matrix: detections, then "missed" columns at exactly the gate so
+        // a pair is only chosen when it beats leaving both unassigned
+        int cols = m + rows;
+        for (int i = 0; i < rows; i++) {
+            const track_t *t = &g_tracks[g_rows[i]];
+            for (int32_t j = 0; j < m; j++) {
+                float d2 = track_cost(t, g_meas[j]);
+                if (d2 < KALMAN_GATE) {
+                    g_meas_gated[j] = true;
+                    g_cost[i][j] = d2;
+                } else {
+                    g_cost[i][j] = 2.0f * KALMAN_GATE;
+                }
+            }
+            for (int j = m; j < cols; j++) {
+                g_cost[i][j] = KALMAN_GATE;
+            }
+        }
+
+        hungarian(rows, cols);
+
+        for (int j = 1; j <= m; j++) {
+            int i = g_match[j];
+            if (i != 0 && g_cost[i - 1][j - 1] < KALMAN_GATE) {
+                g_meas_track[j - 1] = (int8_t)g_rows[i - 1];
+            }
+        }
+    }
+
+    // Correct matched tracks; mark every track as missed first
+    for (int i = 0; i < rows; i++) {
+        g_tracks[g_rows[i]].misses++;
+    }
+    for (int32_t j = 0; j < m; j++) {
+        if (g_meas_track[j] < 0) continue;
+        track_t *t = &g_tracks[g_meas_track[j]];
+        track_correct(t, g_meas[j]);
+        t->misses = 0;
+        t->velocity = detections[j].velocity;
+        t->speed = detections[j].speed;
+        t->cluster_id = detections[j].cluster_id;
+        if (t->hits < UINT8_MAX) t->hits++;
+        if (!t->confirmed && t->hits >= KALMAN_CONFIRM_HITS) {
+            t->confirmed = true;
+            g_kalman_stats.confirmations++;
+        }
+        g_kalman_stats.associations++;
+    }
+
+    // Death: tentative tracks on their first miss, confirmed ones after a run of misses
+    for (int i = 0; i < rows; i++) {
+        track_t *t = &g_tracks[g_rows[i]];
+        if (t->misses == 0) continue;
+        t->hits = 0;
+        t->velocity = 0;
+        t->speed = 0;
+        if (!t->confirmed || t->misses > KALMAN_MAX_MISSES) {
+            t->active = false;
+            g_kalman_stats.deaths++;
+        }
+    }
+
+    // Birth: detections nobody claimed and that sit outside every gate
+    int free_slot = 0;
+    for (int32_t j = 0; j < m; j++) {
+        if (g_meas_track[j] >= 0 || g_meas_gated[j]) continue;
+        while (free_slot < KALMAN_MAX_TRACKS && g_tracks[free_slot].active) free_slot++;
+        if (free_slot == KALMAN_MAX_TRACKS) {
+            g_kalman_stats.full_rejections++;
+            continue;
+        }
+        track_birth(&g_tracks[free_slot], g_meas[j], &detections[j]);
+        g_kalman_stats.births++;
+    }
+
+    // Publish confirmed tracks
+    int32_t out = 0;
+    for (int k = 0; k < KALMAN_MAX_TRACKS; k++) {
+        const track_t *t = &g_tracks[k];
+        if (!t->active || !t->confirmed) continue;
+        tracks[out].x = HLK_COORD_FROM_M(t->pos[0]);
+        tracks[out].y = HLK_COORD_FROM_M(t->pos[1]);
+        tracks[out].z = HLK_COORD_FROM_M(t->pos[2]);
+        tracks[out].velocity = t->velocity;
+        tracks[out].speed = t->speed;
+        tracks[out].cluster_id = t->cluster_id;
+        tracks[out].track_id = t->id;
+        out++;
+    }
+
+    uint32_t elapsed_us = hlk_port_micros() - start_us;
+    g_kalman_stats.cycles++;
+    g_kalman_stats.active_tracks = out;
+    g_kalman_stats.last_us = elapsed_us;
+    g_kalman_stats.total_us += elapsed_us;
+    if (elapsed_us > g_kalman_stats.max_us) {
+        g_kalman_stats.max_us = elapsed_us;
+    }
+
+    return out;
+}
+
+void kalman_tracker_get_stats(kalman_tracker_stats_t* stats) {
+    if (stats) {
+        *stats = g_kalman_stats;
+    }
+}
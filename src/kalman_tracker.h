@@ -0,0 +1,93 @@
+// Kalman Tracker Module
+// Multi-target tracking with stable IDs: constant-velocity Kalman filters,
+// gated global (Hungarian) association and track birth/death
+
+#ifndef KALMAN_TRACKER_H
+#define KALMAN_TRACKER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hlk_ld6002.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== CONFIGURATION ==========
+
+#ifndef KALMAN_TRACKER_DEFAULT_ENABLED
+#define KALMAN_TRACKER_DEFAULT_ENABLED 1  // Publish tracked targets instead of raw detections
+#endif
+
+#define KALMAN_MAX_TRACKS 16          // Track slots (tentative + confirmed)
+#define KALMAN_MAX_MEASUREMENTS 24    // Detections associated per cycle, extra ones are ignored
+#define KALMAN_GATE 11.34f            // Mahalanobis distance² gate (chi², 3 DOF, 99%)
+#define KALMAN_MEAS_STD_M 0.15f       // Sensor position noise per axis (m)
+#define KALMAN_ACCEL_STD 1.0f         // Process noise: white acceleration (m/s²)
+#define KALMAN_INIT_VEL_STD 1.0f      // Velocity uncertainty of a new track (m/s)
+#define KALMAN_CONFIRM_HITS 3         // Consecutive hits before a track is published
+#define KALMAN_MAX_MISSES 10          // Missed cycles before a confirmed track is deleted
+#define KALMAN_DT_MIN_MS 20           // Clamp for the time step between cycles
+#define KALMAN_DT_MAX_MS 1000
+
+// ========== DATA STRUCTURES ==========
+
+// Tracker statistics
+typedef struct {
+    uint32_t cycles;             // kalman_tracker_update() calls
+    uint32_t births;             // Tracks created
+    uint32_t deaths;             // Tracks deleted
+    uint32_t confirmations;      // Tentative tracks promoted to confirmed
+    uint32_t associations;       // Detections assigned to tracks
+    uint32_t dropped_detections; // Detections beyond KALMAN_MAX_MEASUREMENTS
+    uint32_t full_rejections;    // Births refused because all slots were in use
+    uint32_t active_tracks;      // Confirmed tracks after the last cycle
+    uint32_t last_us;            // Runtime of the most recent cycle
+    uint32_t max_us;             // Worst-case cycle runtime
+    uint32_t total_us;           // Sum of cycle runtimes (for the average)
+} kalman_tracker_stats_t;
+
+// ========== API FUNCTIONS ==========
+
+/**
+ * Initialize tracker (drops all tracks)
+ */
+void kalman_tracker_init(void);
+
+/**
+ * Enable or disable tracking
+ * @param enabled true to publish tracked targets, false for raw detections
+ */
+void kalman_tracker_set_enabled(bool enabled);
+
+/**
+ * Check whether tracking is enabled
+ * @return true if enabled
+ */
+bool kalman_tracker_is_enabled(void);
+
+/**
+ * Run one tracking cycle on a detection list
+ *
+ * Output targets are the confirmed tracks: filtered position, the Doppler
+ * velocity index of the detection they were matched to (0 while coasting),
+ * cluster_id of that detection, and a stable track_id.
+ *
+ * @param detections Detections from the sensor or the clustering stage
+ * @param count Number of detections
+ * @param tracks Output array (KALMAN_MAX_TRACKS entries)
+ * @return Number of tracks written
+ */
+int32_t kalman_tracker_update(const hlk_target_t* detections, int32_t count, hlk_target_t* tracks);
+
+/**
+ * Get tracker statistics
+ * @param stats Output statistics
+ */
+void kalman_tracker_get_stats(kalman_tracker_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // KALMAN_TRACKER_H
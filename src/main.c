@@ -14,7 +14,21 @@
 
 // Application modules
 #include "hlk_ld6002.h"
+#include "cmd_pipeline.h"
+#include "cmd_scheduler.h"
+#include "cloud_voxel.h"
+#include "point_cluster.h"
+#include "kalman_tracker.h"
+#include "trajectory_store.h"
+#include "occupancy_map.h"
+#include "zone_engine.h"
+#include "tripwire.h"
 #include "target_tracker.h"
+#include "presence_fsm.h"
+#include "task_profiler.h"
+#include "device_state.h"
+#include "config_store.h"
+#include "frame_ring.h"
 #include "api.h"
 #include "wifi_manager.h"
 #include "web_server.h"
@@ -22,42 +36,118 @@
 // Feature flags
 #define ENABLE_WEB_INTERFACE 1  // Set to 0 to disable WiFi/web for debugging
 
+// Longest the sensor task sleeps waiting for UART data before servicing web commands
+// (shortened to the next scheduled command deadline)
+#define SENSOR_IDLE_WAIT_MS 50
+
+// UART wait while sensor init commands are outstanding (bounds timeout handling latency)
+#define SENSOR_INIT_WAIT_MS 10
+
+// Longest the publish task sleeps with no frames queued before logging statistics
+#define PUBLISH_IDLE_WAIT_MS 1000
+
+// The UART reader outranks the HTTP server (priority 5); publishing runs below it
+#define SENSOR_TASK_PRIORITY (tskIDLE_PRIORITY + 6)
+#define PUBLISH_TASK_PRIORITY (tskIDLE_PRIORITY + 2)
+
 static const char *TAG = "App";
 
 // ========== SENSOR TASK ==========
 
+// Publish task has applied every queued frame (reports reach the state cache there)
+static bool frames_drained(void) {
+    frame_ring_stats_t ring;
+    frame_ring_get_stats(&ring);
+    return ring.popped == ring.pushed;
+}
+
+// Run the parser until every queued command has been answered or failed and
+// the answers are in the state cache; blocking in the parser lets the
+// lower-priority publish task run
+static void wait_for_pipeline(void) {
+    while (!cmd_pipeline_idle() || !frames_drained()) {
+        hlk_ld6002_process(SENSOR_INIT_WAIT_MS);
+        cmd_pipeline_poll();
+    }
+}
+
 static void sensor_task(void *arg) {
     ESP_LOGI(TAG, "═══════════════════════════════════════");
     ESP_LOGI(TAG, "HLK-LD6002B-3D Sensor Task");
     ESP_LOGI(TAG, "═══════════════════════════════════════");
     
-    // Wait for sensor to stabilize
-    vTaskDelay(pdMS_TO_TICKS(1000));
-    
-    // Initialize sensor
+    // Initialize sensor - commands are pipelined and retried on timeout, so
+    // there is no fixed settle delay; init ends when the last answer arrives
     ESP_LOGI(TAG, "📡 Initializing sensor...");
-    hlk_ld6002_send_command(CMD_ENABLE_TARGET_DISPLAY);
-    vTaskDelay(pdMS_TO_TICKS(100));
-    
-    // Request configuration
-    hlk_ld6002_send_command(CMD_GET_SENSITIVITY);
-    vTaskDelay(pdMS_TO_TICKS(100));
-    hlk_ld6002_send_command(CMD_GET_TRIGGER_SPEED);
-    vTaskDelay(pdMS_TO_TICKS(100));
-    hlk_ld6002_send_command(CMD_GET_INSTALL_METHOD);
-    vTaskDelay(pdMS_TO_TICKS(100));
-    hlk_ld6002_send_command(CMD_GET_ZONES);
-    vTaskDelay(pdMS_TO_TICKS(100));
-    
-    ESP_LOGI(TAG, "✅ Ready - waiting for detections...");
+    uint32_t init_start = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    
+    static const uint32_t init_commands[] = {
+        CMD_ENABLE_TARGET_DISPLAY,
+        CMD_GET_SENSITIVITY,
+        CMD_GET_TRIGGER_SPEED,
+        CMD_GET_INSTALL_METHOD,
+        CMD_GET_ZONES,
+        CMD_GET_HOLD_DELAY,
+        CMD_GET_Z_AXIS_RANGE,
+        CMD_GET_LOW_POWER_MODE,
+        CMD_GET_LOW_POWER_SLEEP_TIME,
+    };
+    for (size_t i = 0; i < sizeof(init_commands) / sizeof(init_commands[0]); i++) {
+        cmd_pipeline_submit(init_commands[i], CMD_PIPELINE_DEFAULT_TIMEOUT_MS,
+                            CMD_PIPELINE_DEFAULT_RETRIES);
+    }
+    
+    wait_for_pipeline();
+    
+    // Warm boot: push only the saved settings the radar does not already have,
+    // wait for their read-backs, and push again whatever did not stick
+    uint32_t restore_start = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    while (config_store_restore() > 0) {
+        wait_for_pipeline();
+    }
+    
+    uint32_t ready = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    config_store_boot_complete(ready);
+    config_store_stats_t store;
+    config_store_get_stats(&store);
+    if (store.restored > 0) {
+        ESP_LOGI(TAG, "💾 Restored %lu setting%s in %lu ms (%lu pushed again, %lu not taken)",
+                 store.restored, store.restored == 1 ? "" : "s", ready - restore_start,
+                 store.repushed, store.pinned);
+    }
+    
+    cmd_pipeline_stats_t pipe;
+    cmd_pipeline_get_stats(&pipe);
+    ESP_LOGI(TAG, "✅ Ready in %lu ms (%lu ms since boot) - %lu/%lu commands answered, "
+             "avg %lu ms, max %lu ms, %lu retries",
+             ready - init_start, ready, pipe.completed, pipe.submitted,
+             pipe.completed ? pipe.total_latency_ms / pipe.completed : 0,
+             pipe.max_latency_ms, pipe.retries);
+    if (pipe.failed > 0) {
+        ESP_LOGW(TAG, "⚠️  %lu init command%s got no response - check sensor wiring/power",
+                 pipe.failed, pipe.failed == 1 ? "" : "s");
+    }
+    ESP_LOGI(TAG, "Waiting for detections...");
     ESP_LOGI(TAG, "═══════════════════════════════════════");
     
     while (true) {
-        // Process web commands (via API layer)
+        // Process web commands (via API layer) - queued and sent on deadlines,
+        // never slept on
         api_process_web_commands();
         
-        // Process sensor data
-        hlk_ld6002_process(10);  // 10ms timeout
+        // Process sensor data (blocks on UART events, not a poll) - frames
+        // are only copied into the frame ring here
+        hlk_ld6002_process(cmd_scheduler_next_deadline_ms(SENSOR_IDLE_WAIT_MS));
+        cmd_pipeline_poll();
+    }
+}
+
+// ========== PUBLISH TASK ==========
+
+static void publish_task(void *arg) {
+    while (true) {
+        // Tracking, analytics, logging and SSE for every queued frame
+        api_process_frames(PUBLISH_IDLE_WAIT_MS);
         
         // Log statistics
         api_log_stats();
@@ -81,8 +171,31 @@ void app_main(void) {
         return;
     }
     
-    // Initialize target tracker
+    // Initialize target tracker and presence debounce
     target_tracker_init();
+    presence_fsm_init();
+    
+    // Initialize point cloud reduction
+    cloud_voxel_init();
+    point_cluster_init();
+    kalman_tracker_init();
+    trajectory_store_init();
+    occupancy_map_init();
+    zone_engine_init();
+    tripwire_init();
+    
+    // Per-task CPU and stack sampling (GET /tasks)
+    task_profiler_init();
+    
+    // Cached radar settings and zones (GET /state)
+    device_state_init();
+    
+    // Saved radar configuration, restored by the sensor task
+    config_store_init();
+    
+    // Initialize command pipeline and the scheduler feeding it
+    cmd_pipeline_init();
+    cmd_scheduler_init();
     
     // Initialize API layer
     api_init();
@@ -91,8 +204,10 @@ void app_main(void) {
     hlk_callbacks_t callbacks = {
         .on_target = api_on_target_detected,
         .on_presence = api_on_presence_detected,
+        .on_config = api_on_config_received,
         .on_zones = api_on_zones_received,
-        .on_config = api_on_config_received
+        .on_point_cloud = api_on_point_cloud,
+        .on_frame = cmd_pipeline_on_frame
     };
     hlk_ld6002_register_callbacks(&callbacks);
 
@@ -129,13 +244,28 @@ void app_main(void) {
     ESP_LOGI(TAG, "Web interface disabled (ENABLE_WEB_INTERFACE=0)");
 #endif
 
-    // Create sensor processing task
+    // Create publish task first, so frames have a consumer as soon as they arrive
     BaseType_t task_created = xTaskCreate(
+        publish_task,
+        "publish_task",
+        8 * 1024,  // 8KB stack - tracking, analytics and JSON formatting
+        NULL,
+        PUBLISH_TASK_PRIORITY,
+        NULL
+    );
+    
+    if (task_created != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create publish task!");
+        return;
+    }
+    
+    // Create sensor processing task
+    task_created = xTaskCreate(
         sensor_task,
         "sensor_task",
-        8 * 1024,  // 8KB stack
+        4 * 1024,  // 4KB stack - parsing and command handling only
         NULL,
-        tskIDLE_PRIORITY + 1,
+        SENSOR_TASK_PRIORITY,
         NULL
     );
     
@@ -144,11 +274,14 @@ void app_main(void) {
         return;
     }
     
-    ESP_LOGI(TAG, "✅ Sensor task started");
+    ESP_LOGI(TAG, "✅ Sensor and publish tasks started");
     ESP_LOGI(TAG, "═══════════════════════════════════════");
 
-    // Main loop - monitor web clients
+    // Main loop - task profiling, config saving and web client monitoring
     while (true) {
+        task_profiler_poll(xTaskGetTickCount() * portTICK_PERIOD_MS);
+        config_store_poll(xTaskGetTickCount() * portTICK_PERIOD_MS);
+        
 #if ENABLE_WEB_INTERFACE
         // Periodic status update
         static uint32_t last_status = 0;
@@ -0,0 +1,203 @@
+// Occupancy Map Implementation
+//
+// Every cell holds a 16-bit count and the 8-bit decay tick (a quarter of the
+// half-life) at which the count was last brought up to date. Decay is lazy:
+// a cell is aged only when a target lands in it, when the round-robin sweep
+// passes it (OCCUPANCY_SWEEP_CELLS per update) or when an export reads it;
+// a full pass only runs if updates are too sparse for the sweep to keep the
+// 8-bit ticks from wrapping. Ageing n ticks is a
+// shift by n/4 half-lives plus one Q15 multiply for the remaining quarters,
+// so the whole map stays integer-only and an update costs O(targets).
+
+#include "occupancy_map.h"
+#include "hlk_port.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+static const char *TAG = "Occupancy";
+
+#define OCCUPANCY_TICK_MS ((uint32_t)OCCUPANCY_HALF_LIFE_S * 1000 / 4)  // Decay step: a quarter half-life
+#define OCCUPANCY_CATCHUP_TICKS 128  // Idle ticks after which every cell is aged at once
+
+_Static_assert(OCCUPANCY_TICK_MS > 0, "OCCUPANCY_HALF_LIFE_S too small");
+
+// 2^(-q/4) in Q15 for the quarter half-lives left after the shift
+static const uint16_t k_quarter_q15[4] = { 32768, 27554, 23170, 19484 };
+
+// ========== GLOBAL STATE ==========
+
+static uint16_t g_counts[OCCUPANCY_CELLS];
+static uint8_t g_ticks[OCCUPANCY_CELLS];   // Low 8 bits of the tick each count is valid at
+static SemaphoreHandle_t g_mutex = NULL;
+static uint32_t g_start_ms = 0;            // Tick 0
+static uint32_t g_catchup_tick = 0;        // Every cell has been aged at or after this tick
+static uint32_t g_sweep = 0;               // Next cell for the round-robin sweep
+static uint32_t g_lap_tick = 0;            // Tick at which the current sweep lap started
+static occupancy_map_stats_t g_stats = {0};
+
+// ========== HELPER FUNCTIONS ==========
+
+static void lock(void) {
+    if (g_mutex) xSemaphoreTake(g_mutex, portMAX_DELAY);
+}
+
+static void unlock(void) {
+    if (g_mutex) xSemaphoreGive(g_mutex);
+}
+
+static uint32_t current_tick(void) {
+    return (hlk_port_millis() - g_start_ms) / OCCUPANCY_TICK_MS;
+}
+
+// Bring one cell up to the current tick
+static void age_cell(uint32_t cell, uint32_t tick) {
+    uint8_t n = (uint8_t)((uint8_t)tick - g_ticks[cell]);
+    if (n == 0) return;
+    g_ticks[cell] = (uint8_t)tick;
+
+    uint32_t count = g_counts[cell];
+    if (count == 0) return;
+    if (n >= 64) {  // 16 half-lives empty any 16-bit count
+        g_counts[cell] = 0;
+        return;
+    }
+    count = (count * k_quarter_q15[n & 3]) >> 15;
+    g_counts[cell] = (uint16_t)(count >> (n >> 2));
+}
+
+// When updates are too sparse for the sweep to lap the map in time, cells
+// would alias their 8-bit tick, so age the whole map at once instead
+static void catch_up(uint32_t tick) {
+    if (tick - g_catchup_tick < OCCUPANCY_CATCHUP_TICKS) return;
+    for (uint32_t i = 0; i < OCCUPANCY_CELLS; i++) {
+        age_cell(i, tick);
+    }
+    g_catchup_tick = tick;
+    g_lap_tick = tick;
+    g_sweep = 0;
+}
+
+// Cell index for a position, or -1 outside the grid
+static int32_t cell_index(const hlk_target_t* t) {
+    int32_t x = HLK_COORD_TO_MM(t->x) - OCCUPANCY_ORIGIN_X_MM;
+    int32_t y = HLK_COORD_TO_MM(t->y) - OCCUPANCY_ORIGIN_Y_MM;
+    if (x < 0 || y < 0) return -1;
+
+    int32_t col = x / OCCUPANCY_CELL_MM;
+    int32_t row = y / OCCUPANCY_CELL_MM;
+    if (col >= OCCUPANCY_GRID_W || row >= OCCUPANCY_GRID_H) return -1;
+
+    int32_t band = 0;
+#if OCCUPANCY_Z_BANDS > 1
+    int32_t z = HLK_COORD_TO_MM(t->z);
+    band = z > 0 ? z / OCCUPANCY_Z_BAND_MM : 0;
+    if (band >= OCCUPANCY_Z_BANDS) band = OCCUPANCY_Z_BANDS - 1;
+#endif
+    return (band * OCCUPANCY_GRID_H + row) * OCCUPANCY_GRID_W + col;
+}
+
+// ========== API FUNCTIONS ==========
+
+void occupancy_map_init(void) {
+    if (!g_mutex) {
+        g_mutex = xSemaphoreCreateMutex();
+    }
+    occupancy_map_reset();
+
+    ESP_LOGI(TAG, "✅ Occupancy map: %dx%d x %d band%s of %d mm cells, half-life %d s, %u bytes",
+             OCCUPANCY_GRID_W, OCCUPANCY_GRID_H, OCCUPANCY_Z_BANDS, OCCUPANCY_Z_BANDS == 1 ? "" : "s",
+             OCCUPANCY_CELL_MM, OCCUPANCY_HALF_LIFE_S, (unsigned)(sizeof(g_counts) + sizeof(g_ticks)));
+}
+
+void occupancy_map_reset(void) {
+    lock();
+    memset(g_counts, 0, sizeof(g_counts));
+    memset(g_ticks, 0, sizeof(g_ticks));
+    g_start_ms = hlk_port_millis();
+    g_catchup_tick = 0;
+    g_lap_tick = 0;
+    g_sweep = 0;
+    memset(&g_stats, 0, sizeof(g_stats));
+    unlock();
+}
+
+void occupancy_map_update(const hlk_target_t* targets, int32_t count) {
+    lock();
+    uint32_t tick = current_tick();  // Read under the lock so cells never see time go backwards
+    catch_up(tick);
+    for (int i = 0; i < OCCUPANCY_SWEEP_CELLS; i++) {
+        age_cell(g_sweep, tick);
+        if (++g_sweep == OCCUPANCY_CELLS) {
+            g_sweep = 0;
+            g_catchup_tick = g_lap_tick;  // Completed lap: every cell aged since it started
+            g_lap_tick = tick;
+        }
+    }
+
+    for (int32_t i = 0; i < count; i++) {
+        int32_t cell = cell_index(&targets[i]);
+        if (cell < 0) {
+            g_stats.outside++;
+            continue;
+        }
+        age_cell(cell, tick);
+        if (g_counts[cell] == UINT16_MAX) {
+            g_stats.saturated++;
+            continue;
+        }
+        g_counts[cell]++;
+        g_stats.hits++;
+    }
+    g_stats.frames++;
+    unlock();
+}
+
+void occupancy_map_get_header(occupancy_header_t* header) {
+    if (!header) return;
+
+    memset(header, 0, sizeof(*header));
+    header->magic = OCCUPANCY_MAGIC;
+    header->width = OCCUPANCY_GRID_W;
+    header->height = OCCUPANCY_GRID_H;
+    header->bands = OCCUPANCY_Z_BANDS;
+    header->cell_mm = OCCUPANCY_CELL_MM;
+    header->origin_x_mm = OCCUPANCY_ORIGIN_X_MM;
+    header->origin_y_mm = OCCUPANCY_ORIGIN_Y_MM;
+    header->band_mm = OCCUPANCY_Z_BAND_MM;
+    header->half_life_s = OCCUPANCY_HALF_LIFE_S;
+    header->timestamp_ms = hlk_port_millis();
+
+    lock();
+    header->frames = g_stats.frames;
+    header->hits = g_stats.hits;
+    unlock();
+}
+
+void occupancy_map_read_row(int band, int row, uint16_t* counts) {
+    if (band < 0 || band >= OCCUPANCY_Z_BANDS || row < 0 || row >= OCCUPANCY_GRID_H) {
+        memset(counts, 0, OCCUPANCY_GRID_W * sizeof(uint16_t));
+        return;
+    }
+
+    uint32_t first = (uint32_t)(band * OCCUPANCY_GRID_H + row) * OCCUPANCY_GRID_W;
+
+    lock();
+    uint32_t tick = current_tick();
+    catch_up(tick);
+    for (uint32_t i = 0; i < OCCUPANCY_GRID_W; i++) {
+        age_cell(first + i, tick);
+        counts[i] = g_counts[first + i];
+    }
+    unlock();
+}
+
+void occupancy_map_get_stats(occupancy_map_stats_t* stats) {
+    if (!stats) return;
+
+    lock();
+    *stats = g_stats;
+    unlock();
+    stats->memory_bytes = sizeof(g_counts) + sizeof(g_ticks);
+}
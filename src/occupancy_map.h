@@ -0,0 +1,137 @@
+// Occupancy Map Module
+// Decaying floor-plane heatmap of target positions with integer-only updates,
+// exported as a compact binary blob for GET /heatmap
+
+#ifndef OCCUPANCY_MAP_H
+#define OCCUPANCY_MAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hlk_ld6002.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== CONFIGURATION ==========
+
+#ifndef OCCUPANCY_GRID_W
+#define OCCUPANCY_GRID_W 48             // Cells along X
+#endif
+
+#ifndef OCCUPANCY_GRID_H
+#define OCCUPANCY_GRID_H 48             // Cells along Y
+#endif
+
+#ifndef OCCUPANCY_CELL_MM
+#define OCCUPANCY_CELL_MM 125           // Cell edge length (48 x 125 mm covers the 3 m range both ways)
+#endif
+
+#ifndef OCCUPANCY_ORIGIN_X_MM
+#define OCCUPANCY_ORIGIN_X_MM (-(OCCUPANCY_GRID_W * OCCUPANCY_CELL_MM) / 2)  // X of the grid's first column
+#endif
+
+#ifndef OCCUPANCY_ORIGIN_Y_MM
+#define OCCUPANCY_ORIGIN_Y_MM (-(OCCUPANCY_GRID_H * OCCUPANCY_CELL_MM) / 2)  // Y of the grid's first row
+#endif
+
+#ifndef OCCUPANCY_Z_BANDS
+#define OCCUPANCY_Z_BANDS 1             // Height layers (1 = 2D, >1 = 2.5D split by Z)
+#endif
+
+#ifndef OCCUPANCY_Z_BAND_MM
+#define OCCUPANCY_Z_BAND_MM 1000        // Height of each layer from Z = 0 (top layer is open-ended)
+#endif
+
+#ifndef OCCUPANCY_HALF_LIFE_S
+#define OCCUPANCY_HALF_LIFE_S 600       // Time for a cell's count to halve without new hits
+#endif
+
+#define OCCUPANCY_CELLS (OCCUPANCY_GRID_W * OCCUPANCY_GRID_H * OCCUPANCY_Z_BANDS)
+#define OCCUPANCY_SWEEP_CELLS 4         // Untouched cells aged per update (round-robin)
+#define OCCUPANCY_MAGIC 0x3143434F      // "OCC1" little-endian
+#define OCCUPANCY_HEADER_SIZE 32        // Bytes before the cell array in the binary export
+
+// ========== DATA STRUCTURES ==========
+
+// Binary export header (little-endian), followed by OCCUPANCY_CELLS uint16
+// counts ordered band, row (Y), column (X)
+typedef struct __attribute__((packed)) {
+    uint32_t magic;          // OCCUPANCY_MAGIC
+    uint16_t width;          // OCCUPANCY_GRID_W
+    uint16_t height;         // OCCUPANCY_GRID_H
+    uint16_t bands;          // OCCUPANCY_Z_BANDS
+    uint16_t cell_mm;        // OCCUPANCY_CELL_MM
+    int16_t origin_x_mm;     // X of column 0's lower edge
+    int16_t origin_y_mm;     // Y of row 0's lower edge
+    uint16_t band_mm;        // OCCUPANCY_Z_BAND_MM
+    uint16_t half_life_s;    // OCCUPANCY_HALF_LIFE_S
+    uint32_t frames;         // Updates since reset
+    uint32_t hits;           // Target positions accumulated since reset
+    uint32_t timestamp_ms;   // Device uptime when the snapshot started
+} occupancy_header_t;
+
+_Static_assert(sizeof(occupancy_header_t) == OCCUPANCY_HEADER_SIZE, "occupancy_header_t layout");
+
+// Accumulator statistics
+typedef struct {
+    uint32_t frames;         // occupancy_map_update() calls
+    uint32_t hits;           // Positions added to a cell
+    uint32_t outside;        // Positions outside the grid
+    uint32_t saturated;      // Hits on a cell already at UINT16_MAX
+    uint32_t memory_bytes;   // Static storage for counts and decay ticks
+} occupancy_map_stats_t;
+
+// ========== API FUNCTIONS ==========
+
+/**
+ * Initialize map (clears all cells)
+ */
+void occupancy_map_init(void);
+
+/**
+ * Clear all cells and counters
+ */
+void occupancy_map_reset(void);
+
+/**
+ * Add one frame of target positions
+ *
+ * Each target increments its cell by one. Decay is applied lazily to the
+ * touched cells plus OCCUPANCY_SWEEP_CELLS others, so the cost is
+ * O(targets) per frame.
+ *
+ * @param targets Targets to accumulate
+ * @param count Number of targets
+ */
+void occupancy_map_update(const hlk_target_t* targets, int32_t count);
+
+/**
+ * Fill the binary export header for a snapshot taken now
+ * @param header Output header
+ */
+void occupancy_map_get_header(occupancy_header_t* header);
+
+/**
+ * Copy one decayed row of counts
+ *
+ * Holds the map lock for a single row only, so an export interleaves with
+ * sensor updates instead of stalling them.
+ *
+ * @param band Height layer (0 to OCCUPANCY_Z_BANDS-1)
+ * @param row Row index (0 to OCCUPANCY_GRID_H-1)
+ * @param counts Output: OCCUPANCY_GRID_W counts
+ */
+void occupancy_map_read_row(int band, int row, uint16_t* counts);
+
+/**
+ * Get accumulator statistics
+ * @param stats Output statistics
+ */
+void occupancy_map_get_stats(occupancy_map_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OCCUPANCY_MAP_H
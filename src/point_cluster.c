@@ -0,0 +1,309 @@
+// Point Cloud Clustering Implementation
+//
+// DBSCAN with the neighbourhood radius as grid cell size: every point only
+// has to be compared against the points in its own and the 26 surrounding
+// cells. Neighbour pairs are recorded once in a per-frame adjacency bitmap,
+// core points are merged with union-find, and border points join the cluster
+// of their first core neighbour. All state is static and sized by
+// HLK_MAX_CLOUD_POINTS, so a cycle is bounded by the largest cloud a frame
+// can carry.
+
+#include "point_cluster.h"
+#include "spatial_grid.h"
+#include "hlk_port.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "Cluster";
+
+#define ADJ_WORDS ((HLK_MAX_CLOUD_POINTS + 31) / 32)
+#define NO_CELL 0xFF
+
+_Static_assert(HLK_MAX_CLOUD_POINTS < NO_CELL, "point indices must fit in uint8_t");
+
+typedef struct {
+    uint16_t stamp;     // Entry valid when equal to g_stamp
+    int16_t cx, cy, cz; // Cell index
+    uint8_t head;       // First point in the cell (chained through g_next)
+} cell_entry_t;
+
+// ========== GLOBAL STATE ==========
+
+static bool g_enabled = POINT_CLUSTER_DEFAULT_ENABLED;
+static int32_t g_eps_mm = POINT_CLUSTER_DEFAULT_EPS_MM;
+static int32_t g_min_pts = POINT_CLUSTER_DEFAULT_MIN_PTS;
+
+static cell_entry_t g_cells[POINT_CLUSTER_GRID_SLOTS];
+static uint16_t g_stamp = 0;
+
+// Per-point scratch
+static int16_t g_px[HLK_MAX_CLOUD_POINTS];
+static int16_t g_py[HLK_MAX_CLOUD_POINTS];
+static int16_t g_pz[HLK_MAX_CLOUD_POINTS];
+static int16_t g_cx[HLK_MAX_CLOUD_POINTS];
+static int16_t g_cy[HLK_MAX_CLOUD_POINTS];
+static int16_t g_cz[HLK_MAX_CLOUD_POINTS];
+static uint8_t g_next[HLK_MAX_CLOUD_POINTS];
+static uint8_t g_neighbours[HLK_MAX_CLOUD_POINTS];  // Including self
+static uint8_t g_parent[HLK_MAX_CLOUD_POINTS];
+static uint8_t g_slot[HLK_MAX_CLOUD_POINTS];        // Root → cluster slot
+static uint32_t g_adj[HLK_MAX_CLOUD_POINTS][ADJ_WORDS];
+
+// Per-cluster accumulators (mm, mm/s)
+static int32_t g_sum_x[HLK_MAX_CLOUD_POINTS];
+static int32_t g_sum_y[HLK_MAX_CLOUD_POINTS];
+static int32_t g_sum_z[HLK_MAX_CLOUD_POINTS];
+static int32_t g_sum_speed[HLK_MAX_CLOUD_POINTS];
+static uint8_t g_size[HLK_MAX_CLOUD_POINTS];
+static uint8_t g_order[HLK_MAX_CLOUD_POINTS];
+
+static point_cluster_stats_t g_cluster_stats = {0};
+static uint32_t g_last_cloud_ms = 0;
+
+// ========== HELPERS ==========
+
+// Find a cell's table entry, or the empty slot where it belongs
+static cell_entry_t* cell_lookup(int16_t cx, int16_t cy, int16_t cz) {
+    // Linear probe; the table is over twice the max point count so it never fills
+    uint32_t h = spatial_grid_cell_hash(cx, cy, cz) & (POINT_CLUSTER_GRID_SLOTS - 1);
+    cell_entry_t *e = &g_cells[h];
+    while (e->stamp == g_stamp && (e->cx != cx || e->cy != cy || e->cz != cz)) {
+        h = (h + 1) & (POINT_CLUSTER_GRID_SLOTS - 1);
+        e = &g_cells[h];
+    }
+    return e;
+}
+
+static uint8_t find_root(uint8_t i) {
+    while (g_parent[i] != i) {
+        g_parent[i] = g_parent[g_parent[i]];  // Path halving
+        i = g_parent[i];
+    }
+    return i;
+}
+
+static void merge(uint8_t a, uint8_t b) {
+    a = find_root(a);
+    b = find_root(b);
+    if (a != b) {
+        // Lower index becomes the root, keeping labels stable across frames
+        if (a < b) g_parent[b] = a;
+        else g_parent[a] = b;
+    }
+}
+
+// Record every neighbour pair within eps, visiting each pair once
+static void build_neighbourhoods(int32_t n) {
+    int32_t eps2 = g_eps_mm * g_eps_mm;
+
+    for (int32_t i = 0; i < n; i++) {
+        for (int dz = -1; dz <= 1; dz++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    cell_entry_t *e = cell_lookup(g_cx[i] + dx, g_cy[i] + dy, g_cz[i] + dz);
+                    if (e->stamp != g_stamp) continue;
+
+                    for (uint8_t j = e->head; j != NO_CELL; j = g_next[j]) {
+                        if (j <= i) continue;
+
+                        // Same or adjacent cell, so each delta is below 2*eps and cannot overflow
+                        int32_t ddx = g_px[j] - g_px[i];
+                        int32_t ddy = g_py[j] - g_py[i];
+                        int32_t ddz = g_pz[j] - g_pz[i];
+                        if (ddx * ddx + ddy * ddy + ddz * ddz > eps2) continue;
+
+                        g_adj[i][j >> 5] |= 1u << (j & 31);
+                        g_adj[j][i >> 5] |= 1u << (i & 31);
+                        g_neighbours[i]++;
+                        g_neighbours[j]++;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// ========== API IMPLEMENTATION ==========
+
+void point_cluster_init(void) {
+    memset(g_cells, 0, sizeof(g_cells));
+    memset(&g_cluster_stats, 0, sizeof(g_cluster_stats));
+    g_stamp = 0;
+    g_last_cloud_ms = 0;
+    g_enabled = POINT_CLUSTER_DEFAULT_ENABLED;
+    g_eps_mm = POINT_CLUSTER_DEFAULT_EPS_MM;
+    g_min_pts = POINT_CLUSTER_DEFAULT_MIN_PTS;
+    ESP_LOGI(TAG, "Clustering initialized (eps=%ld mm, min_pts=%ld, %s)",
+             g_eps_mm, g_min_pts, g_enabled ? "enabled" : "disabled");
+}
+
+void point_cluster_set_enabled(bool enabled) {
+    g_enabled = enabled;
+    ESP_LOGI(TAG, "🧩 Clustering %s", enabled ? "enabled" : "disabled");
+}
+
+bool point_cluster_is_enabled(void) {
+    return g_enabled;
+}
+
+void point_cluster_set_params(uint16_t eps_mm, uint8_t min_pts) {
+    if (eps_mm < POINT_CLUSTER_MIN_EPS_MM) eps_mm = POINT_CLUSTER_MIN_EPS_MM;
+    if (eps_mm > POINT_CLUSTER_MAX_EPS_MM) eps_mm = POINT_CLUSTER_MAX_EPS_MM;
+    if (min_pts < 1) min_pts = 1;
+    g_eps_mm = eps_mm;
+    g_min_pts = min_pts;
+    ESP_LOGI(TAG, "Clustering params: eps=%d mm, min_pts=%d", eps_mm, min_pts);
+}
+
+int32_t point_cluster_process(const hlk_point_cloud_t* cloud, hlk_target_t* targets) {
+    uint32_t start_us = hlk_port_micros();
+    int32_t n = cloud->count;
+    int32_t clusters = 0;
+    int32_t noise = 0;
+
+    if (n > HLK_MAX_CLOUD_POINTS) n = HLK_MAX_CLOUD_POINTS;
+
+    // New generation - stale cells become invisible; clear on wrap
+    if (++g_stamp == 0) {
+        memset(g_cells, 0, sizeof(g_cells));
+        g_stamp = 1;
+    }
+
+    // Quantize and bucket points into eps-sized cells
+    for (int32_t i = 0; i < n; i++) {
+        g_px[i] = spatial_grid_to_mm(cloud->x[i]);
+        g_py[i] = spatial_grid_to_mm(cloud->y[i]);
+        g_pz[i] = spatial_grid_to_mm(cloud->z[i]);
+        g_cx[i] = spatial_grid_cell_index(g_px[i], g_eps_mm);
+        g_cy[i] = spatial_grid_cell_index(g_py[i], g_eps_mm);
+        g_cz[i] = spatial_grid_cell_index(g_pz[i], g_eps_mm);
+
+        cell_entry_t *e = cell_lookup(g_cx[i], g_cy[i], g_cz[i]);
+        if (e->stamp != g_stamp) {
+            e->stamp = g_stamp;
+            e->cx = g_cx[i];
+            e->cy = g_cy[i];
+            e->cz = g_cz[i];
+            e->head = NO_CELL;
+        }
+        g_next[i] = e->head;
+        e->head = (uint8_t)i;
+
+        g_neighbours[i] = 1;
+        g_parent[i] = (uint8_t)i;
+        g_slot[i] = NO_CELL;
+        memset(g_adj[i], 0, sizeof(g_adj[i]));
+    }
+
+    build_neighbourhoods(n);
+
+    // Connect core points that are within eps of each other
+    for (int32_t i = 0; i < n; i++) {
+        if (g_neighbours[i] < g_min_pts) continue;
+        for (int32_t w = 0; w < ADJ_WORDS; w++) {
+            uint32_t bits = g_adj[i][w];
+            while (bits) {
+                int32_t j = w * 32 + __builtin_ctz(bits);
+                bits &= bits - 1;
+                if (j > i && g_neighbours[j] >= g_min_pts) {
+                    merge((uint8_t)i, (uint8_t)j);
+                }
+            }
+        }
+    }
+
+    // Label points and accumulate per-cluster sums
+    for (int32_t i = 0; i < n; i++) {
+        int32_t core = -1;
+        if (g_neighbours[i] >= g_min_pts) {
+            core = i;
+        } else {
+            // Border point - attach to the first core neighbour
+            for (int32_t w = 0; w < ADJ_WORDS && core < 0; w++) {
+                uint32_t bits = g_adj[i][w];
+                while (bits) {
+                    int32_t j = w * 32 + __builtin_ctz(bits);
+                    bits &= bits - 1;
+                    if (g_neighbours[j] >= g_min_pts) {
+                        core = j;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (core < 0) {
+            noise++;
+            continue;
+        }
+
+        uint8_t root = find_root((uint8_t)core);
+        if (g_slot[root] == NO_CELL) {
+            g_slot[root] = (uint8_t)clusters;
+            g_sum_x[clusters] = 0;
+            g_sum_y[clusters] = 0;
+            g_sum_z[clusters] = 0;
+            g_sum_speed[clusters] = 0;
+            g_size[clusters] = 0;
+            g_order[clusters] = (uint8_t)clusters;
+            clusters++;
+        }
+
+        uint8_t c = g_slot[root];
+        g_sum_x[c] += g_px[i];
+        g_sum_y[c] += g_py[i];
+        g_sum_z[c] += g_pz[i];
+        g_sum_speed[c] += spatial_grid_to_mm(cloud->speed[i]);
+        g_size[c]++;
+    }
+
+    // Largest clusters first (insertion sort, stable for equal sizes)
+    for (int32_t i = 1; i < clusters; i++) {
+        uint8_t c = g_order[i];
+        int32_t j = i - 1;
+        while (j >= 0 && g_size[g_order[j]] < g_size[c]) {
+            g_order[j + 1] = g_order[j];
+            j--;
+        }
+        g_order[j + 1] = c;
+    }
+
+    int32_t out = clusters < POINT_CLUSTER_MAX_TARGETS ? clusters : POINT_CLUSTER_MAX_TARGETS;
+    for (int32_t t = 0; t < out; t++) {
+        uint8_t c = g_order[t];
+        int32_t size = g_size[c];
+        targets[t].x = HLK_COORD_FROM_MM(g_sum_x[c] / size);
+        targets[t].y = HLK_COORD_FROM_MM(g_sum_y[c] / size);
+        targets[t].z = HLK_COORD_FROM_MM(g_sum_z[c] / size);
+        targets[t].velocity = 0;  // The cloud carries speeds, not Doppler indices
+        targets[t].speed = HLK_COORD_FROM_MM(g_sum_speed[c] / size);
+        targets[t].cluster_id = t;
+        targets[t].track_id = 0;
+    }
+
+    uint32_t elapsed_us = hlk_port_micros() - start_us;
+    uint32_t now = hlk_port_millis();
+
+    g_cluster_stats.cycles++;
+    g_cluster_stats.points_in += n;
+    g_cluster_stats.noise_points += noise;
+    g_cluster_stats.targets_out += out;
+    g_cluster_stats.dropped += clusters - out;
+    g_cluster_stats.last_us = elapsed_us;
+    g_cluster_stats.total_us += elapsed_us;
+    if (elapsed_us > g_cluster_stats.max_us) {
+        g_cluster_stats.max_us = elapsed_us;
+    }
+    if (g_last_cloud_ms != 0) {
+        g_cluster_stats.frame_period_ms = now - g_last_cloud_ms;
+    }
+    g_last_cloud_ms = now;
+
+    return out;
+}
+
+void point_cluster_get_stats(point_cluster_stats_t* stats) {
+    if (stats) {
+        *stats = g_cluster_stats;
+    }
+}
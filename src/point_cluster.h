@@ -0,0 +1,94 @@
+// Point Cloud Clustering Module
+// Grid-accelerated DBSCAN over 0x0A08 point clouds, producing a target list
+// independent of the sensor's own 0x0A04 report
+
+#ifndef POINT_CLUSTER_H
+#define POINT_CLUSTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hlk_ld6002.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== CONFIGURATION ==========
+
+#ifndef POINT_CLUSTER_DEFAULT_ENABLED
+#define POINT_CLUSTER_DEFAULT_ENABLED 0  // Use the sensor's target list until enabled
+#endif
+
+#define POINT_CLUSTER_DEFAULT_EPS_MM 300 // Neighbourhood radius (also the grid cell size)
+#define POINT_CLUSTER_MIN_EPS_MM 50
+#define POINT_CLUSTER_MAX_EPS_MM 1000
+#define POINT_CLUSTER_DEFAULT_MIN_PTS 3  // Neighbours (including self) that make a core point
+#define POINT_CLUSTER_MAX_TARGETS 16     // Largest clusters reported per cycle
+#define POINT_CLUSTER_GRID_SLOTS 128     // Open-addressed cell table (power of two, > 2x max points)
+
+// ========== DATA STRUCTURES ==========
+
+// Runtime statistics
+typedef struct {
+    uint32_t cycles;          // Clouds clustered
+    uint32_t points_in;       // Points received
+    uint32_t noise_points;    // Points not assigned to any cluster
+    uint32_t targets_out;     // Targets emitted
+    uint32_t dropped;         // Clusters beyond POINT_CLUSTER_MAX_TARGETS
+    uint32_t last_us;         // Runtime of the most recent cycle
+    uint32_t max_us;          // Worst-case cycle runtime
+    uint32_t total_us;        // Sum of cycle runtimes (for the average)
+    uint32_t frame_period_ms; // Interval between the last two clouds
+} point_cluster_stats_t;
+
+// ========== API FUNCTIONS ==========
+
+/**
+ * Initialize clustering with default parameters
+ */
+void point_cluster_init(void);
+
+/**
+ * Enable or disable clustering
+ * @param enabled true to replace the sensor's target list with clustered targets
+ */
+void point_cluster_set_enabled(bool enabled);
+
+/**
+ * Check whether clustering is enabled
+ * @return true if enabled
+ */
+bool point_cluster_is_enabled(void);
+
+/**
+ * Set DBSCAN parameters
+ * @param eps_mm Neighbourhood radius in mm, clamped to POINT_CLUSTER_MIN/MAX_EPS_MM
+ * @param min_pts Minimum neighbourhood size for a core point (at least 1)
+ */
+void point_cluster_set_params(uint16_t eps_mm, uint8_t min_pts);
+
+/**
+ * Cluster a point cloud into targets
+ *
+ * Output targets are cluster centroids (hlk_coord_t), ordered by point count
+ * (largest first). speed carries the mean radial speed of the cluster's
+ * points; velocity is 0 since the cloud has no Doppler index, and
+ * cluster_id is the target's index in the list.
+ *
+ * @param cloud Decoded point cloud from the sensor
+ * @param targets Output array (POINT_CLUSTER_MAX_TARGETS entries)
+ * @return Number of targets written
+ */
+int32_t point_cluster_process(const hlk_point_cloud_t* cloud, hlk_target_t* targets);
+
+/**
+ * Get runtime statistics
+ * @param stats Output statistics
+ */
+void point_cluster_get_stats(point_cluster_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POINT_CLUSTER_H
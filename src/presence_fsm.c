@@ -0,0 +1,146 @@
+// Presence State Machine Implementation
+//
+// Each channel runs ABSENT → ENTERING → PRESENT → LEAVING → ABSENT. A raw
+// flip only starts a timer; the debounced output changes once the raw value
+// has held for enter_ms (or exit_ms, and at least hold_ms after entering).
+// A raw flip that reverts before its timer expires is counted as suppressed.
+
+#include "presence_fsm.h"
+#include "hlk_port.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "PresenceFSM";
+
+typedef struct {
+    presence_fsm_channel_t pub;    // State and counters handed out
+    presence_fsm_config_t config;
+    bool raw;                      // Raw value of the last frame
+    uint32_t present_since_ms;     // Entry time, for the hold
+} channel_t;
+
+// ========== GLOBAL STATE ==========
+
+static channel_t g_channels[PRESENCE_FSM_CHANNELS];
+static hlk_port_mutex_t g_mutex = NULL;
+
+static const char *const g_state_names[] = { "absent", "entering", "present", "leaving" };
+
+// ========== API FUNCTIONS ==========
+
+void presence_fsm_init(void) {
+    if (!g_mutex) {
+        g_mutex = hlk_port_mutex_create();
+    }
+    hlk_port_mutex_lock(g_mutex);
+    memset(g_channels, 0, sizeof(g_channels));
+    for (int i = 0; i < PRESENCE_FSM_CHANNELS; i++) {
+        g_channels[i].config.enter_ms = PRESENCE_FSM_ENTER_MS;
+        g_channels[i].config.exit_ms = PRESENCE_FSM_EXIT_MS;
+        g_channels[i].config.hold_ms = PRESENCE_FSM_HOLD_MS;
+    }
+    hlk_port_mutex_unlock(g_mutex);
+
+    ESP_LOGI(TAG, "✅ Presence debounce: enter %d ms, exit %d ms, hold %d ms",
+             PRESENCE_FSM_ENTER_MS, PRESENCE_FSM_EXIT_MS, PRESENCE_FSM_HOLD_MS);
+}
+
+esp_err_t presence_fsm_set_config(int channel, const presence_fsm_config_t* config) {
+    if (channel < 0 || channel >= PRESENCE_FSM_CHANNELS || !config ||
+        config->enter_ms > PRESENCE_FSM_MAX_DELAY_MS || config->exit_ms > PRESENCE_FSM_MAX_DELAY_MS ||
+        config->hold_ms > PRESENCE_FSM_MAX_DELAY_MS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    hlk_port_mutex_lock(g_mutex);
+    g_channels[channel].config = *config;
+    hlk_port_mutex_unlock(g_mutex);
+
+    ESP_LOGI(TAG, "Channel %d: enter %lu ms, exit %lu ms, hold %lu ms", channel,
+             (unsigned long)config->enter_ms, (unsigned long)config->exit_ms,
+             (unsigned long)config->hold_ms);
+    return ESP_OK;
+}
+
+void presence_fsm_get_config(int channel, presence_fsm_config_t* config) {
+    if (channel < 0 || channel >= PRESENCE_FSM_CHANNELS || !config) return;
+
+    hlk_port_mutex_lock(g_mutex);
+    *config = g_channels[channel].config;
+    hlk_port_mutex_unlock(g_mutex);
+}
+
+bool presence_fsm_update(int channel, bool raw, uint32_t now_ms) {
+    if (channel < 0 || channel >= PRESENCE_FSM_CHANNELS) return false;
+
+    hlk_port_mutex_lock(g_mutex);
+    channel_t *c = &g_channels[channel];
+    presence_fsm_channel_t *p = &c->pub;
+    bool was_present = p->present;
+
+    p->frames++;
+    if (raw != c->raw) {
+        p->raw_changes++;
+        c->raw = raw;
+    }
+
+    // Sequential, so zero delays pass through several states in one frame
+    if (p->state == PRESENCE_ABSENT && raw) {
+        p->state = PRESENCE_ENTERING;
+        p->since_ms = now_ms;
+    }
+    if (p->state == PRESENCE_ENTERING) {
+        if (!raw) {
+            p->state = PRESENCE_ABSENT;
+            p->since_ms = now_ms;
+            p->suppressed++;
+        } else if (now_ms - p->since_ms >= c->config.enter_ms) {
+            p->state = PRESENCE_PRESENT;
+            p->since_ms = now_ms;
+            c->present_since_ms = now_ms;
+        }
+    }
+    if (p->state == PRESENCE_PRESENT && !raw) {
+        p->state = PRESENCE_LEAVING;
+        p->since_ms = now_ms;
+    }
+    if (p->state == PRESENCE_LEAVING) {
+        if (raw) {
+            p->state = PRESENCE_PRESENT;
+            p->since_ms = now_ms;
+            p->suppressed++;
+        } else if (now_ms - p->since_ms >= c->config.exit_ms &&
+                   now_ms - c->present_since_ms >= c->config.hold_ms) {
+            p->state = PRESENCE_ABSENT;
+            p->since_ms = now_ms;
+        }
+    }
+
+    p->present = p->state == PRESENCE_PRESENT || p->state == PRESENCE_LEAVING;
+    bool changed = p->present != was_present;
+    if (changed) p->transitions++;
+    hlk_port_mutex_unlock(g_mutex);
+
+    return changed;
+}
+
+bool presence_fsm_is_present(int channel) {
+    if (channel < 0 || channel >= PRESENCE_FSM_CHANNELS) return false;
+
+    hlk_port_mutex_lock(g_mutex);
+    bool present = g_channels[channel].pub.present;
+    hlk_port_mutex_unlock(g_mutex);
+    return present;
+}
+
+void presence_fsm_get_channel(int channel, presence_fsm_channel_t* out) {
+    if (channel < 0 || channel >= PRESENCE_FSM_CHANNELS || !out) return;
+
+    hlk_port_mutex_lock(g_mutex);
+    *out = g_channels[channel].pub;
+    hlk_port_mutex_unlock(g_mutex);
+}
+
+const char* presence_fsm_state_name(presence_state_t state) {
+    return (unsigned)state < sizeof(g_state_names) / sizeof(g_state_names[0]) ? g_state_names[state] : "unknown";
+}
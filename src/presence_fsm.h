@@ -0,0 +1,119 @@
+// Presence State Machine Module
+// Debounced presence per radar zone and for "any person" (target frames),
+// with enter/exit delays, a minimum hold time and per-channel settings.
+// Transitions, not raw frames, drive logging and the event stream.
+
+#ifndef PRESENCE_FSM_H
+#define PRESENCE_FSM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "hlk_ld6002.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== CONFIGURATION ==========
+
+#ifndef PRESENCE_FSM_ENTER_MS
+#define PRESENCE_FSM_ENTER_MS 300       // Raw presence must persist this long before "present"
+#endif
+
+#ifndef PRESENCE_FSM_EXIT_MS
+#define PRESENCE_FSM_EXIT_MS 2000       // Raw absence must persist this long before "absent"
+#endif
+
+#ifndef PRESENCE_FSM_HOLD_MS
+#define PRESENCE_FSM_HOLD_MS 5000       // Minimum time "present" is held once entered
+#endif
+
+#define PRESENCE_FSM_PERSON HLK_ZONE_COUNT          // Channel fed by target frames (any target)
+#define PRESENCE_FSM_CHANNELS (HLK_ZONE_COUNT + 1)  // Radar zones 0-3, then the person channel
+#define PRESENCE_FSM_MAX_DELAY_MS 600000            // Upper limit for every configured delay
+
+// ========== DATA STRUCTURES ==========
+
+typedef enum {
+    PRESENCE_ABSENT,     // Debounced absent
+    PRESENCE_ENTERING,   // Raw present, waiting out enter_ms
+    PRESENCE_PRESENT,    // Debounced present
+    PRESENCE_LEAVING     // Raw absent, waiting out exit_ms / hold_ms
+} presence_state_t;
+
+// Per-channel hysteresis
+typedef struct {
+    uint32_t enter_ms;       // Enter debounce
+    uint32_t exit_ms;        // Exit debounce
+    uint32_t hold_ms;        // Minimum present time
+} presence_fsm_config_t;
+
+// Per-channel state and counters
+typedef struct {
+    presence_state_t state;
+    bool present;            // Debounced output (PRESENT or LEAVING)
+    uint32_t since_ms;       // Uptime of the last state change
+    uint32_t frames;         // Raw frames fed in
+    uint32_t raw_changes;    // Raw value flips
+    uint32_t transitions;    // Debounced transitions emitted
+    uint32_t suppressed;     // Raw flips cancelled by the debounce (flaps)
+} presence_fsm_channel_t;
+
+// ========== API FUNCTIONS ==========
+
+/**
+ * Initialize all channels (absent, default hysteresis, counters cleared)
+ */
+void presence_fsm_init(void);
+
+/**
+ * Set the hysteresis of one channel
+ * @param channel 0-3 for radar zones, PRESENCE_FSM_PERSON for target frames
+ * @param config Delays (each at most PRESENCE_FSM_MAX_DELAY_MS)
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG
+ */
+esp_err_t presence_fsm_set_config(int channel, const presence_fsm_config_t* config);
+
+/**
+ * Get the hysteresis of one channel
+ * @param channel Channel index
+ * @param config Output delays
+ */
+void presence_fsm_get_config(int channel, presence_fsm_config_t* config);
+
+/**
+ * Feed one raw sample into a channel
+ * @param channel Channel index
+ * @param raw Raw presence of this frame
+ * @param now_ms Uptime of the frame
+ * @return true if the debounced output changed (a transition to emit)
+ */
+bool presence_fsm_update(int channel, bool raw, uint32_t now_ms);
+
+/**
+ * Check the debounced output of a channel
+ * @param channel Channel index
+ * @return true if present
+ */
+bool presence_fsm_is_present(int channel);
+
+/**
+ * Get state and counters of one channel
+ * @param channel Channel index
+ * @param out Output copy
+ */
+void presence_fsm_get_channel(int channel, presence_fsm_channel_t* out);
+
+/**
+ * Get a state name for logs and JSON
+ * @param state State value
+ * @return "absent", "entering", "present" or "leaving"
+ */
+const char* presence_fsm_state_name(presence_state_t state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PRESENCE_FSM_H
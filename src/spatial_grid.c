@@ -0,0 +1,25 @@
+// Spatial Grid Implementation
+//
+// Integer helpers for bucketing points into cubic cells. cloud_voxel uses
+// them for its voxels and point_cluster for its DBSCAN neighbour grid.
+
+#include "spatial_grid.h"
+
+// ========== API IMPLEMENTATION ==========
+
+int16_t spatial_grid_to_mm(hlk_coord_t coord) {
+    int32_t mm = HLK_COORD_TO_MM(coord);
+    if (mm > INT16_MAX) return INT16_MAX;
+    if (mm < INT16_MIN) return INT16_MIN;
+    return (int16_t)mm;
+}
+
+int16_t spatial_grid_cell_index(int16_t mm, int32_t size) {
+    int32_t v = mm;
+    return (int16_t)(v >= 0 ? v / size : -((-v + size - 1) / size));
+}
+
+uint32_t spatial_grid_cell_hash(int16_t cx, int16_t cy, int16_t cz) {
+    // Spatial hash from Teschner et al. (large primes per axis)
+    return ((uint32_t)cx * 73856093u) ^ ((uint32_t)cy * 19349663u) ^ ((uint32_t)cz * 83492791u);
+}
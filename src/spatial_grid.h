@@ -0,0 +1,46 @@
+// Spatial Grid Module
+// Millimetre quantization and grid cell hashing shared by the voxel filter
+// and the point cloud clustering
+
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <stdint.h>
+#include "hlk_ld6002.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== API FUNCTIONS ==========
+
+/**
+ * Convert a coordinate (or speed) to int16 millimetres, saturating
+ * @param coord Value in hlk_coord_t units
+ * @return Millimetres clamped to INT16_MIN..INT16_MAX
+ */
+int16_t spatial_grid_to_mm(hlk_coord_t coord);
+
+/**
+ * Get the grid cell of a position along one axis
+ * Floor division, so negative positions round down and cell 0 spans [0, size).
+ * @param mm Position (mm)
+ * @param size Cell edge length (mm, > 0)
+ * @return Cell index
+ */
+int16_t spatial_grid_cell_index(int16_t mm, int32_t size);
+
+/**
+ * Hash a cell for an open-addressed table
+ * @param cx Cell index X
+ * @param cy Cell index Y
+ * @param cz Cell index Z
+ * @return Hash; mask with the (power of two) table size minus one
+ */
+uint32_t spatial_grid_cell_hash(int16_t cx, int16_t cy, int16_t cz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPATIAL_GRID_H
@@ -2,10 +2,11 @@
 // Handles target detection, tracking, and person presence logic
 
 #include "target_tracker.h"
+#include "presence_fsm.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include <math.h>
+#include "freertos/semphr.h"
 #include <string.h>
 
 static const char *TAG = "TargetTracker";
@@ -15,11 +16,26 @@ static const char *TAG = "TargetTracker";
 static target_stats_t g_target_stats = {0};
 static zone_stats_t g_zone_stats = {0};
 
+// Zone analytics - written by the publish task (event bus), copied out by the web server
+static zone_analytics_t g_zone_analytics = {0};
+static SemaphoreHandle_t g_analytics_mutex = NULL;
+static int g_pending_exit_zone = -1;       // Zone vacated within the transition window, -1 = none
+static uint32_t g_pending_exit_time = 0;
+static const uint32_t g_dwell_edges_s[TRACKER_DWELL_BINS - 1] = TRACKER_DWELL_BIN_EDGES_S;
+
 // ========== TARGET TRACKING ==========
 
 void target_tracker_init(void) {
     memset(&g_target_stats, 0, sizeof(g_target_stats));
     memset(&g_zone_stats, 0, sizeof(g_zone_stats));
+    
+    if (!g_analytics_mutex) {
+        g_analytics_mutex = xSemaphoreCreateMutex();
+    }
+    memset(&g_zone_analytics, 0, sizeof(g_zone_analytics));
+    g_zone_analytics.since_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    g_pending_exit_zone = -1;
+    
     ESP_LOGI(TAG, "Target tracker initialized");
 }
 
@@ -30,33 +46,43 @@ bool target_tracker_update(const hlk_target_t* targets, int32_t count) {
     // Detect state changes
     bool count_changed = (count != g_target_stats.last_target_count);
     
+    // Arrival and departure follow the debounced person channel, so a single
+    // empty frame does not end a visit
+    bool present = presence_fsm_is_present(PRESENCE_FSM_PERSON);
+    if (present && !g_target_stats.person_detected) {
+        g_target_stats.person_detected = true;
+        g_target_stats.first_detection_time = now;
+        state_changed = true;
+        
+        ESP_LOGI(TAG, "═══════════════════════════════════════");
+        ESP_LOGI(TAG, "👋 PERSON DETECTED");
+        ESP_LOGI(TAG, "═══════════════════════════════════════");
+    } else if (!present && g_target_stats.person_detected) {
+        uint32_t detection_duration = (now - g_target_stats.first_detection_time) / 1000;
+        state_changed = true;
+        
+        ESP_LOGI(TAG, "═══════════════════════════════════════");
+        ESP_LOGI(TAG, "👋 PERSON LEFT (detected for %lu seconds)", detection_duration);
+        ESP_LOGI(TAG, "═══════════════════════════════════════");
+        
+        g_target_stats.person_detected = false;
+    }
+    
     if (count > 0) {
         // Get first target for movement tracking
-        float x = targets[0].x;
-        float y = targets[0].y;
-        float z = targets[0].z;
-        int32_t dop_idx = targets[0].velocity;
+        hlk_coord_t x = targets[0].x;
+        hlk_coord_t y = targets[0].y;
+        hlk_coord_t z = targets[0].z;
+        bool moving = targets[0].velocity != 0 || targets[0].speed != 0;
         
         // Calculate distance and movement
-        float distance = hlk_calc_distance_3d(x, y, z);
-        float dx = x - g_target_stats.last_x;
-        float dy = y - g_target_stats.last_y;
-        float dz = z - g_target_stats.last_z;
-        float movement = sqrtf(dx * dx + dy * dy + dz * dz);
+        hlk_coord_t distance = hlk_calc_distance_3d(x, y, z);
+        hlk_coord_t movement = hlk_calc_distance_3d(x - g_target_stats.last_x,
+                                                    y - g_target_stats.last_y,
+                                                    z - g_target_stats.last_z);
         
         // Check if target moved significantly
-        bool moved = (movement > TRACKER_MOVEMENT_THRESHOLD_M) || count_changed;
-        
-        // Track new person detection
-        if (!g_target_stats.person_detected) {
-            g_target_stats.person_detected = true;
-            g_target_stats.first_detection_time = now;
-            state_changed = true;
-            
-            ESP_LOGI(TAG, "═══════════════════════════════════════");
-            ESP_LOGI(TAG, "👋 PERSON DETECTED");
-            ESP_LOGI(TAG, "═══════════════════════════════════════");
-        }
+        bool moved = (movement > TRACKER_MOVEMENT_THRESHOLD) || count_changed;
         
         // Log target info on significant events
         if (moved || (now - g_target_stats.last_update_time > TRACKER_UPDATE_INTERVAL_MS)) {
@@ -66,19 +92,21 @@ bool target_tracker_update(const hlk_target_t* targets, int32_t count) {
                 g_target_stats.stationary_count++;
             }
             
-            const char *motion_status = (dop_idx != 0) ? "🏃 Moving" :
-                                       (movement > TRACKER_MOVEMENT_THRESHOLD_M) ? "🚶 Slow" : "🧍 Still";
+            const char *motion_status = moving ? "🏃 Moving" :
+                                       (movement > TRACKER_MOVEMENT_THRESHOLD) ? "🚶 Slow" : "🧍 Still";
             
             if (count == 1) {
                 ESP_LOGI(TAG, "🎯 Target: pos=(%.2f, %.2f, %.2f)m dist=%.2fm %s",
-                         x, y, z, distance, motion_status);
+                         HLK_COORD_TO_M(x), HLK_COORD_TO_M(y), HLK_COORD_TO_M(z),
+                         HLK_COORD_TO_M(distance), motion_status);
             } else {
                 ESP_LOGI(TAG, "🎯 %ld Targets detected:", count);
                 for (int i = 0; i < count && i < 3; i++) {
-                    float t_dist = hlk_calc_distance_3d(targets[i].x, targets[i].y, targets[i].z);
-                    const char *t_motion = (targets[i].velocity != 0) ? "🏃 Moving" : "🧍 Still";
+                    hlk_coord_t t_dist = hlk_calc_distance_3d(targets[i].x, targets[i].y, targets[i].z);
+                    const char *t_motion = (targets[i].velocity != 0 || targets[i].speed != 0) ? "🏃 Moving" : "🧍 Still";
                     ESP_LOGI(TAG, "   #%d: pos=(%.2f, %.2f, %.2f)m dist=%.2fm %s",
-                             i + 1, targets[i].x, targets[i].y, targets[i].z, t_dist, t_motion);
+                             i + 1, HLK_COORD_TO_M(targets[i].x), HLK_COORD_TO_M(targets[i].y),
+                             HLK_COORD_TO_M(targets[i].z), HLK_COORD_TO_M(t_dist), t_motion);
                 }
                 if (count > 3) {
                     ESP_LOGI(TAG, "   (+%ld more targets)", count - 3);
@@ -92,17 +120,6 @@ bool target_tracker_update(const hlk_target_t* targets, int32_t count) {
         g_target_stats.last_x = x;
         g_target_stats.last_y = y;
         g_target_stats.last_z = z;
-        
-    } else if (count_changed && g_target_stats.person_detected) {
-        // Person left
-        uint32_t detection_duration = (now - g_target_stats.first_detection_time) / 1000;
-        state_changed = true;
-        
-        ESP_LOGI(TAG, "═══════════════════════════════════════");
-        ESP_LOGI(TAG, "👋 PERSON LEFT (detected for %lu seconds)", detection_duration);
-        ESP_LOGI(TAG, "═══════════════════════════════════════");
-        
-        g_target_stats.person_detected = false;
     }
     
     g_target_stats.last_target_count = count;
@@ -111,6 +128,82 @@ bool target_tracker_update(const hlk_target_t* targets, int32_t count) {
 
 // ========== ZONE TRACKING ==========
 
+static void zone_exit(int zone, uint32_t now) {
+    zone_dwell_t *z = &g_zone_analytics.zones[zone];
+    uint32_t dwell = now - z->enter_time;
+    
+    z->occupied = false;
+    z->exit_time = now;
+    z->last_dwell_ms = dwell;
+    if (dwell > z->longest_dwell_ms) z->longest_dwell_ms = dwell;
+    z->total_dwell_ms += dwell;
+    
+    int bin = 0;
+    while (bin < TRACKER_DWELL_BINS - 1 && dwell >= g_dwell_edges_s[bin] * 1000) bin++;
+    z->dwell_histogram[bin]++;
+    
+    // Already handed over to a zone entered during this visit
+    for (int i = 0; i < HLK_ZONE_COUNT; i++) {
+        const zone_dwell_t *other = &g_zone_analytics.zones[i];
+        if (other->occupied && (int32_t)(other->enter_time - z->enter_time) >= 0) return;
+    }
+    
+    // Otherwise wait for the next entry; an earlier vacated zone had nowhere to go
+    if (g_pending_exit_zone >= 0) {
+        g_zone_analytics.transitions[g_pending_exit_zone][TRACKER_ZONE_OUTSIDE]++;
+    }
+    g_pending_exit_zone = zone;
+    g_pending_exit_time = now;
+}
+
+static void zone_enter(int zone, uint32_t now) {
+    zone_dwell_t *z = &g_zone_analytics.zones[zone];
+    
+    // Source: a zone just vacated, else the most recently entered occupied zone, else outside
+    int from = TRACKER_ZONE_OUTSIDE;
+    if (g_pending_exit_zone >= 0) {
+        from = g_pending_exit_zone;
+        g_pending_exit_zone = -1;
+    } else {
+        uint32_t newest = 0;
+        for (int i = 0; i < HLK_ZONE_COUNT; i++) {
+            const zone_dwell_t *other = &g_zone_analytics.zones[i];
+            if (i != zone && other->occupied &&
+                (from == TRACKER_ZONE_OUTSIDE || (int32_t)(other->enter_time - newest) >= 0)) {
+                from = i;
+                newest = other->enter_time;
+            }
+        }
+    }
+    g_zone_analytics.transitions[from][zone]++;
+    
+    z->occupied = true;
+    z->enter_time = now;
+    z->visits++;
+}
+
+// O(1) per frame: only zones whose state flipped are touched
+static void zone_analytics_update(const uint32_t presence[HLK_ZONE_COUNT], uint32_t now) {
+    if (g_analytics_mutex) xSemaphoreTake(g_analytics_mutex, portMAX_DELAY);
+    
+    g_zone_analytics.frames++;
+    
+    if (g_pending_exit_zone >= 0 && now - g_pending_exit_time > TRACKER_TRANSITION_WINDOW_MS) {
+        g_zone_analytics.transitions[g_pending_exit_zone][TRACKER_ZONE_OUTSIDE]++;
+        g_pending_exit_zone = -1;
+    }
+    
+    // Exits before entries, so a swap within one frame counts as a move
+    for (int i = 0; i < HLK_ZONE_COUNT; i++) {
+        if (g_zone_analytics.zones[i].occupied && !presence[i]) zone_exit(i, now);
+    }
+    for (int i = 0; i < HLK_ZONE_COUNT; i++) {
+        if (!g_zone_analytics.zones[i].occupied && presence[i]) zone_enter(i, now);
+    }
+    
+    if (g_analytics_mutex) xSemaphoreGive(g_analytics_mutex);
+}
+
 bool zone_tracker_update(uint32_t zone0, uint32_t zone1, uint32_t zone2, uint32_t zone3) {
     uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
     
@@ -147,6 +240,8 @@ bool zone_tracker_update(uint32_t zone0, uint32_t zone1, uint32_t zone2, uint32_
     g_zone_stats.zone_presence[3] = zone3;
     g_zone_stats.changed = changed;
     
+    zone_analytics_update(g_zone_stats.zone_presence, now);
+    
     return changed;
 }
 
@@ -160,6 +255,15 @@ const zone_stats_t* zone_tracker_get_stats(void) {
     return &g_zone_stats;
 }
 
+void zone_tracker_get_analytics(zone_analytics_t* analytics) {
+    if (!analytics) return;
+    
+    if (g_analytics_mutex) xSemaphoreTake(g_analytics_mutex, portMAX_DELAY);
+    *analytics = g_zone_analytics;
+    if (g_analytics_mutex) xSemaphoreGive(g_analytics_mutex);
+    analytics->now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+}
+
 bool target_tracker_person_present(void) {
     return g_target_stats.person_detected;
 }
@@ -15,8 +15,13 @@ extern "C" {
 // ========== CONFIGURATION ==========
 
 #define TRACKER_MOVEMENT_THRESHOLD_M    0.05f   // 5cm movement threshold
+#define TRACKER_MOVEMENT_THRESHOLD      HLK_COORD_FROM_M(TRACKER_MOVEMENT_THRESHOLD_M)
 #define TRACKER_UPDATE_INTERVAL_MS      5000    // Log updates every 5 seconds
 #define TRACKER_PRESENCE_LOG_INTERVAL_MS 30000  // Log presence every 30 seconds
+#define TRACKER_ZONE_OUTSIDE            HLK_ZONE_COUNT  // Transition matrix index for "no zone"
+#define TRACKER_TRANSITION_WINDOW_MS    3000    // Exit→enter gap still counted as a zone-to-zone move
+#define TRACKER_DWELL_BINS              7       // Dwell histogram bins (edges below)
+#define TRACKER_DWELL_BIN_EDGES_S       { 5, 30, 120, 600, 1800, 7200 }  // Upper bin edges; last bin is open
 
 // ========== DATA STRUCTURES ==========
 
@@ -26,8 +31,8 @@ typedef struct {
     uint32_t last_update_time;      // Last time we logged target info
     uint32_t stationary_count;      // Consecutive stationary detections
     int32_t last_target_count;      // Previous target count
-    float last_x, last_y, last_z;   // Last target position
-    bool person_detected;           // Person currently present
+    hlk_coord_t last_x, last_y, last_z;  // Last target position
+    bool person_detected;           // Person currently present (debounced)
 } target_stats_t;
 
 // Zone tracking statistics
@@ -37,6 +42,28 @@ typedef struct {
     bool changed;                   // Did zones change this update
 } zone_stats_t;
 
+// Per-zone dwell analytics (times are uptime ms)
+typedef struct {
+    bool occupied;                  // Zone currently occupied
+    uint32_t visits;                // Completed and ongoing visits
+    uint32_t enter_time;            // Start of the current/last visit
+    uint32_t exit_time;             // End of the last completed visit (0 = none yet)
+    uint32_t last_dwell_ms;         // Duration of the last completed visit
+    uint32_t longest_dwell_ms;      // Longest completed visit
+    uint64_t total_dwell_ms;        // Sum of completed visits (add now - enter_time while occupied)
+    uint32_t dwell_histogram[TRACKER_DWELL_BINS];  // Completed visits by duration
+} zone_dwell_t;
+
+// Zone analytics snapshot
+typedef struct {
+    uint32_t frames;                // Presence frames processed
+    uint32_t since_time;            // Uptime when counting started
+    uint32_t now;                   // Uptime of this snapshot
+    zone_dwell_t zones[HLK_ZONE_COUNT];
+    // Occupancy handovers [from][to]; index TRACKER_ZONE_OUTSIDE is "no zone"
+    uint32_t transitions[HLK_ZONE_COUNT + 1][HLK_ZONE_COUNT + 1];
+} zone_analytics_t;
+
 // ========== API FUNCTIONS ==========
 
 /**
@@ -46,6 +73,8 @@ void target_tracker_init(void);
 
 /**
  * Process target detection data
+ * Call after feeding the frame to presence_fsm_update(PRESENCE_FSM_PERSON, ...);
+ * person arrival/departure follow that debounced channel.
  * @param targets Array of detected targets
  * @param count Number of targets detected
  * @return true if person state changed (detected/left)
@@ -62,6 +91,15 @@ bool target_tracker_update(const hlk_target_t* targets, int32_t count);
  */
 bool zone_tracker_update(uint32_t zone0, uint32_t zone1, uint32_t zone2, uint32_t zone3);
 
+/**
+ * Get a consistent copy of the zone dwell and transition analytics
+ *
+ * Updated incrementally by zone_tracker_update(): O(1) per presence frame.
+ *
+ * @param analytics Output snapshot
+ */
+void zone_tracker_get_analytics(zone_analytics_t* analytics);
+
 /**
  * Get current target statistics
  * @return Pointer to target stats structure
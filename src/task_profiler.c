@@ -0,0 +1,215 @@
+// Task Profiler Implementation
+//
+// Each sample reads every task's run-time counter with
+// uxTaskGetSystemState() and turns the difference to the previous sample
+// into a share of the interval (the counter is the 1 MHz esp_timer, so
+// unsigned differences survive it wrapping). Tasks are matched across
+// samples by their task number; a slot is freed when its task disappears.
+// All slots share one history ring position, and each slot remembers how
+// many of the newest entries are its own.
+
+#include "task_profiler.h"
+#include "hlk_port.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <string.h>
+
+static const char *TAG = "TaskProf";
+
+#if defined(configUSE_TRACE_FACILITY) && configUSE_TRACE_FACILITY && \
+    defined(configGENERATE_RUN_TIME_STATS) && configGENERATE_RUN_TIME_STATS
+#define TASK_PROFILER_ENABLED 1
+#else
+#define TASK_PROFILER_ENABLED 0
+#endif
+
+typedef struct {
+    bool used;
+    bool seen;                   // Present in the current sample
+    task_profiler_task_t pub;    // Everything except history, which lives in g_history
+    uint32_t last_runtime;       // Run-time counter at the previous sample
+} task_slot_t;
+
+// ========== GLOBAL STATE ==========
+
+static task_slot_t g_slots[TASK_PROFILER_MAX_TASKS];
+static uint16_t g_history[TASK_PROFILER_MAX_TASKS][TASK_PROFILER_SAMPLES];
+static uint32_t g_head = 0;                // Next history column to write
+static uint32_t g_last_total = 0;          // Total run time at the previous sample
+static uint32_t g_last_sample_ms = 0;
+static task_profiler_stats_t g_prof_stats = {0};
+static hlk_port_mutex_t g_mutex = NULL;
+
+#if TASK_PROFILER_ENABLED
+// Snapshot buffer (kept off the caller's stack)
+static TaskStatus_t g_status[TASK_PROFILER_MAX_TASKS + 8];
+#endif
+
+// ========== HELPERS ==========
+
+#if TASK_PROFILER_ENABLED
+static task_slot_t* find_slot(uint32_t number) {
+    task_slot_t *free_slot = NULL;
+    for (int i = 0; i < TASK_PROFILER_MAX_TASKS; i++) {
+        if (g_slots[i].used && g_slots[i].pub.number == number) {
+            return &g_slots[i];
+        }
+        if (!g_slots[i].used && !free_slot) {
+            free_slot = &g_slots[i];
+        }
+    }
+    return free_slot;
+}
+
+static void take_sample(void) {
+    uint32_t start = hlk_port_micros();
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    UBaseType_t count = uxTaskGetSystemState(g_status, sizeof(g_status) / sizeof(g_status[0]), &total);
+    if (count == 0) return;  // More tasks than the snapshot buffer holds
+
+    hlk_port_mutex_lock(g_mutex);
+    uint32_t interval = (uint32_t)total - g_last_total;
+    bool first = g_prof_stats.samples == 0;
+    uint32_t untracked = 0;
+
+    for (int i = 0; i < TASK_PROFILER_MAX_TASKS; i++) {
+        g_slots[i].seen = false;
+    }
+
+    for (UBaseType_t t = 0; t < count; t++) {
+        const TaskStatus_t *status = &g_status[t];
+        task_slot_t *slot = find_slot(status->xTaskNumber);
+        if (!slot) {
+            untracked++;
+            continue;
+        }
+
+        task_profiler_task_t *pub = &slot->pub;
+        uint32_t runtime = (uint32_t)status->ulRunTimeCounter;
+        uint32_t stack_free = status->usStackHighWaterMark * sizeof(StackType_t);
+
+        if (!slot->used) {
+            // New task: its first interval starts now
+            memset(slot, 0, sizeof(*slot));
+            slot->used = true;
+            pub->number = status->xTaskNumber;
+            strncpy(pub->name, status->pcTaskName, TASK_PROFILER_NAME_LEN - 1);
+            pub->stack_min_free = stack_free;
+        } else if (!first && interval > 0) {
+            uint32_t permille = (uint64_t)(runtime - slot->last_runtime) * 1000 / interval;
+            pub->cpu_permille = permille > 1000 ? 1000 : permille;
+            g_history[slot - g_slots][g_head] = pub->cpu_permille;
+            if (pub->samples < TASK_PROFILER_SAMPLES) pub->samples++;
+        }
+
+        slot->seen = true;
+        slot->last_runtime = runtime;
+        pub->priority = status->uxCurrentPriority;
+        pub->stack_free = stack_free;
+        if (stack_free < pub->stack_min_free) {
+            pub->stack_min_free = stack_free;
+            if (stack_free < 512) {
+                ESP_LOGW(TAG, "⚠️  Task %s down to %lu bytes of stack", pub->name, stack_free);
+            }
+        }
+    }
+
+    // Deleted tasks free their slot
+    for (int i = 0; i < TASK_PROFILER_MAX_TASKS; i++) {
+        if (g_slots[i].used && !g_slots[i].seen) {
+            g_slots[i].used = false;
+        }
+    }
+
+    if (!first) {
+        g_head = (g_head + 1) % TASK_PROFILER_SAMPLES;
+        g_prof_stats.interval_us = interval;
+    }
+    g_last_total = (uint32_t)total;
+    g_prof_stats.samples++;
+    g_prof_stats.tasks = count;
+    g_prof_stats.untracked = untracked;
+    g_prof_stats.sample_us = hlk_port_micros() - start;
+    hlk_port_mutex_unlock(g_mutex);
+}
+#endif
+
+// ========== API FUNCTIONS ==========
+
+void task_profiler_init(void) {
+    if (!g_mutex) {
+        g_mutex = hlk_port_mutex_create();
+    }
+    hlk_port_mutex_lock(g_mutex);
+    memset(g_slots, 0, sizeof(g_slots));
+    memset(g_history, 0, sizeof(g_history));
+    memset(&g_prof_stats, 0, sizeof(g_prof_stats));
+    g_head = 0;
+    g_last_total = 0;
+    g_prof_stats.available = TASK_PROFILER_ENABLED;
+    hlk_port_mutex_unlock(g_mutex);
+
+#if TASK_PROFILER_ENABLED
+    ESP_LOGI(TAG, "✅ Task profiler: %d samples every %d ms", TASK_PROFILER_SAMPLES, TASK_PROFILER_PERIOD_MS);
+#else
+    ESP_LOGW(TAG, "Task profiler disabled (enable FREERTOS_USE_TRACE_FACILITY and FREERTOS_GENERATE_RUN_TIME_STATS)");
+#endif
+}
+
+bool task_profiler_poll(uint32_t now_ms) {
+#if TASK_PROFILER_ENABLED
+    if (g_prof_stats.samples > 0 && now_ms - g_last_sample_ms < TASK_PROFILER_PERIOD_MS) {
+        return false;
+    }
+    g_last_sample_ms = now_ms;
+    take_sample();
+    return true;
+#else
+    (void)now_ms;
+    return false;
+#endif
+}
+
+int task_profiler_get_tasks(task_profiler_task_t* tasks, int max) {
+    if (!tasks || max <= 0) return 0;
+
+    hlk_port_mutex_lock(g_mutex);
+    int n = 0;
+    for (int i = 0; i < TASK_PROFILER_MAX_TASKS && n < max; i++) {
+        const task_slot_t *slot = &g_slots[i];
+        if (!slot->used) continue;
+
+        task_profiler_task_t out = slot->pub;
+
+        // Newest `samples` columns ending just before g_head, oldest first
+        uint32_t sum = 0;
+        out.cpu_max_permille = 0;
+        for (uint16_t k = 0; k < out.samples; k++) {
+            uint32_t col = (g_head + TASK_PROFILER_SAMPLES - out.samples + k) % TASK_PROFILER_SAMPLES;
+            out.history[k] = g_history[i][col];
+            sum += out.history[k];
+            if (out.history[k] > out.cpu_max_permille) out.cpu_max_permille = out.history[k];
+        }
+        out.cpu_avg_permille = out.samples ? sum / out.samples : 0;
+
+        // Insert sorted by the last interval's share, busiest first
+        int pos = n;
+        while (pos > 0 && tasks[pos - 1].cpu_permille < out.cpu_permille) {
+            tasks[pos] = tasks[pos - 1];
+            pos--;
+        }
+        tasks[pos] = out;
+        n++;
+    }
+    hlk_port_mutex_unlock(g_mutex);
+    return n;
+}
+
+void task_profiler_get_stats(task_profiler_stats_t* stats) {
+    if (!stats) return;
+
+    hlk_port_mutex_lock(g_mutex);
+    *stats = g_prof_stats;
+    hlk_port_mutex_unlock(g_mutex);
+}
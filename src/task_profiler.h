@@ -0,0 +1,89 @@
+// Task Profiler Module
+// Periodic per-task CPU share and stack headroom from FreeRTOS run-time
+// statistics, kept as a short history for GET /tasks. Needs
+// CONFIG_FREERTOS_USE_TRACE_FACILITY and CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+// (set in sdkconfig); without them sampling is a no-op.
+
+#ifndef TASK_PROFILER_H
+#define TASK_PROFILER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== CONFIGURATION ==========
+
+#ifndef TASK_PROFILER_PERIOD_MS
+#define TASK_PROFILER_PERIOD_MS 2000    // Sampling interval
+#endif
+
+#ifndef TASK_PROFILER_SAMPLES
+#define TASK_PROFILER_SAMPLES 30        // History depth per task (60 s at the default period)
+#endif
+
+#define TASK_PROFILER_MAX_TASKS 24      // Tasks tracked at once (IDF system tasks included)
+#define TASK_PROFILER_NAME_LEN 16       // CONFIG_FREERTOS_MAX_TASK_NAME_LEN
+
+// ========== DATA STRUCTURES ==========
+
+// One task as served by GET /tasks
+typedef struct {
+    char name[TASK_PROFILER_NAME_LEN];
+    uint32_t number;                    // FreeRTOS task number (unique per task)
+    uint8_t priority;                   // Current priority
+    uint16_t cpu_permille;              // CPU share in the last interval
+    uint16_t cpu_avg_permille;          // CPU share averaged over the history
+    uint16_t cpu_max_permille;          // Busiest interval in the history
+    uint32_t stack_free;                // Stack high-water mark: bytes never used
+    uint32_t stack_min_free;            // Lowest high-water mark seen since the task appeared
+    uint16_t samples;                   // Valid history entries
+    uint16_t history[TASK_PROFILER_SAMPLES];  // CPU share per interval, oldest first
+} task_profiler_task_t;
+
+// Profiler statistics
+typedef struct {
+    bool available;                     // Run-time stats compiled in
+    uint32_t samples;                   // Intervals sampled
+    uint32_t interval_us;               // Length of the last interval (run-time counter)
+    uint32_t tasks;                     // Tasks in the last sample
+    uint32_t untracked;                 // Tasks not tracked (more than TASK_PROFILER_MAX_TASKS)
+    uint32_t sample_us;                 // Cost of the last task_profiler_sample()
+} task_profiler_stats_t;
+
+// ========== API FUNCTIONS ==========
+
+/**
+ * Initialize task profiler (empty history)
+ */
+void task_profiler_init(void);
+
+/**
+ * Take a sample if TASK_PROFILER_PERIOD_MS has passed since the last one
+ * Call from a low-priority periodic loop (e.g. app_main)
+ * @param now_ms Current time in milliseconds
+ * @return true if a sample was taken
+ */
+bool task_profiler_poll(uint32_t now_ms);
+
+/**
+ * Copy the tracked tasks, sorted by CPU share in the last interval
+ * @param tasks Output array
+ * @param max Capacity of tasks
+ * @return Number of tasks written
+ */
+int task_profiler_get_tasks(task_profiler_task_t* tasks, int max);
+
+/**
+ * Get profiler statistics
+ * @param stats Output statistics
+ */
+void task_profiler_get_stats(task_profiler_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_PROFILER_H
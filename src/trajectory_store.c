@@ -0,0 +1,188 @@
+// Trajectory Store Implementation
+//
+// One ring buffer per track slot, all statically allocated, so the memory
+// cost is fixed at TRAJECTORY_MAX_TRACKS * TRAJECTORY_DEPTH samples of
+// 8 bytes regardless of traffic. Samples are decimated to TRAJECTORY_SAMPLE_MS
+// and quantized to millimetres with a 16-bit timestamp. The publish task writes
+// (an inline event bus subscriber) and the HTTP server task reads, so slot
+// access is serialized with a mutex held only for the copy.
+
+#include "trajectory_store.h"
+#include "hlk_port.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+static const char *TAG = "Trajectory";
+
+typedef struct {
+    uint16_t track_id;            // 0 = free slot
+    uint16_t head;                // Next write index
+    uint16_t count;               // Valid samples
+    uint32_t last_sample_ms;      // Time of the newest sample
+    trajectory_sample_t ring[TRAJECTORY_DEPTH];
+} trajectory_slot_t;
+
+_Static_assert(TRAJECTORY_DEPTH > 0 && TRAJECTORY_DEPTH <= UINT16_MAX, "TRAJECTORY_DEPTH out of range");
+_Static_assert((uint32_t)TRAJECTORY_HISTORY_MS / TRAJECTORY_TIME_UNIT_MS < UINT16_MAX,
+               "TRAJECTORY_HISTORY_MS exceeds the 16-bit timestamp range");
+
+// ========== GLOBAL STATE ==========
+
+static trajectory_slot_t g_slots[TRAJECTORY_MAX_TRACKS];
+static SemaphoreHandle_t g_mutex = NULL;
+static uint32_t g_samples_total = 0;
+static uint32_t g_evictions = 0;
+static uint32_t g_refused = 0;
+
+// ========== HELPER FUNCTIONS ==========
+
+static int16_t quantize_mm(hlk_coord_t c) {
+    int32_t mm = HLK_COORD_TO_MM(c);
+    if (mm > INT16_MAX) return INT16_MAX;
+    if (mm < INT16_MIN) return INT16_MIN;
+    return (int16_t)mm;
+}
+
+static void lock(void) {
+    if (g_mutex) xSemaphoreTake(g_mutex, portMAX_DELAY);
+}
+
+static void unlock(void) {
+    if (g_mutex) xSemaphoreGive(g_mutex);
+}
+
+static bool slot_expired(const trajectory_slot_t* slot, uint32_t now) {
+    return slot->track_id == 0 || now - slot->last_sample_ms > TRAJECTORY_HISTORY_MS;
+}
+
+static void slot_reset(trajectory_slot_t* slot, uint16_t track_id, uint32_t now) {
+    slot->track_id = track_id;
+    slot->head = 0;
+    slot->count = 0;
+    slot->last_sample_ms = now - TRAJECTORY_SAMPLE_MS;  // First sample is taken immediately
+}
+
+// Slot already holding this track, else a free/expired slot, else the stalest
+// ended trail. Trails still being written are never evicted (NULL is returned).
+static trajectory_slot_t* find_slot(uint16_t track_id, uint32_t now) {
+    trajectory_slot_t* free_slot = NULL;
+    trajectory_slot_t* stalest = &g_slots[0];
+    for (int i = 0; i < TRAJECTORY_MAX_TRACKS; i++) {
+        trajectory_slot_t* slot = &g_slots[i];
+        if (slot->track_id == track_id) {
+            // Samples from before a long gap would alias the 16-bit timestamps
+            if (slot_expired(slot, now)) slot_reset(slot, track_id, now);
+            return slot;
+        }
+        if (!free_slot && slot_expired(slot, now)) free_slot = slot;
+        if (now - slot->last_sample_ms > now - stalest->last_sample_ms) stalest = slot;
+    }
+
+    trajectory_slot_t* slot = free_slot;
+    if (!slot) {
+        if (now - stalest->last_sample_ms <= 2 * TRAJECTORY_SAMPLE_MS) {
+            g_refused++;
+            return NULL;
+        }
+        slot = stalest;
+        g_evictions++;
+    }
+    slot_reset(slot, track_id, now);
+    return slot;
+}
+
+// ========== API FUNCTIONS ==========
+
+void trajectory_store_init(void) {
+    if (!g_mutex) {
+        g_mutex = xSemaphoreCreateMutex();
+    }
+    lock();
+    memset(g_slots, 0, sizeof(g_slots));
+    g_samples_total = 0;
+    g_evictions = 0;
+    g_refused = 0;
+    unlock();
+
+    ESP_LOGI(TAG, "✅ Trajectory store: %d tracks x %d samples (%lu ms @ %d ms), %u bytes",
+             TRAJECTORY_MAX_TRACKS, TRAJECTORY_DEPTH, (uint32_t)TRAJECTORY_HISTORY_MS,
+             TRAJECTORY_SAMPLE_MS, (unsigned)sizeof(g_slots));
+}
+
+void trajectory_store_update(const hlk_target_t* targets, int32_t count) {
+    uint32_t now = hlk_port_millis();
+
+    lock();
+    for (int32_t i = 0; i < count; i++) {
+        const hlk_target_t* t = &targets[i];
+        if (t->track_id == 0) continue;
+
+        trajectory_slot_t* slot = find_slot(t->track_id, now);
+        if (!slot) continue;
+        if (now - slot->last_sample_ms < TRAJECTORY_SAMPLE_MS) continue;
+
+        trajectory_sample_t* s = &slot->ring[slot->head];
+        s->x = quantize_mm(t->x);
+        s->y = quantize_mm(t->y);
+        s->z = quantize_mm(t->z);
+        s->t = (uint16_t)(now / TRAJECTORY_TIME_UNIT_MS);
+        slot->head = (slot->head + 1) % TRAJECTORY_DEPTH;
+        if (slot->count < TRAJECTORY_DEPTH) slot->count++;
+        slot->last_sample_ms = now;
+        g_samples_total++;
+    }
+    unlock();
+}
+
+bool trajectory_store_get(int slot_index, trajectory_track_t* track, uint32_t* now_ms) {
+    if (slot_index < 0 || slot_index >= TRAJECTORY_MAX_TRACKS) return false;
+
+    uint32_t now = hlk_port_millis();
+    if (now_ms) *now_ms = now;
+
+    lock();
+    const trajectory_slot_t* slot = &g_slots[slot_index];
+    if (slot_expired(slot, now)) {
+        unlock();
+        return false;
+    }
+
+    // Unroll the ring oldest-first, skipping samples that left the window
+    track->track_id = slot->track_id;
+    track->count = 0;
+    uint16_t start = (slot->head + TRAJECTORY_DEPTH - slot->count) % TRAJECTORY_DEPTH;
+    for (uint16_t i = 0; i < slot->count; i++) {
+        const trajectory_sample_t* s = &slot->ring[(start + i) % TRAJECTORY_DEPTH];
+        if (trajectory_store_sample_age_ms(s, now) > TRAJECTORY_HISTORY_MS) continue;
+        track->samples[track->count++] = *s;
+    }
+    unlock();
+
+    return track->count > 0;
+}
+
+uint32_t trajectory_store_sample_age_ms(const trajectory_sample_t* sample, uint32_t now_ms) {
+    uint16_t now_units = (uint16_t)(now_ms / TRAJECTORY_TIME_UNIT_MS);
+    return (uint16_t)(now_units - sample->t) * (uint32_t)TRAJECTORY_TIME_UNIT_MS;
+}
+
+void trajectory_store_get_stats(trajectory_store_stats_t* stats) {
+    if (!stats) return;
+
+    uint32_t now = hlk_port_millis();
+    memset(stats, 0, sizeof(*stats));
+    stats->memory_bytes = sizeof(g_slots);
+
+    lock();
+    for (int i = 0; i < TRAJECTORY_MAX_TRACKS; i++) {
+        if (slot_expired(&g_slots[i], now)) continue;
+        stats->tracks++;
+        stats->samples += g_slots[i].count;
+    }
+    stats->samples_total = g_samples_total;
+    stats->evictions = g_evictions;
+    stats->refused = g_refused;
+    unlock();
+}
@@ -0,0 +1,104 @@
+// Trajectory Store Module
+// Fixed-size per-track position history (last few seconds, 16-bit mm samples)
+// so reconnecting clients can fetch recent trails instead of rebuilding them
+
+#ifndef TRAJECTORY_STORE_H
+#define TRAJECTORY_STORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hlk_ld6002.h"
+#include "kalman_tracker.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== CONFIGURATION ==========
+
+#ifndef TRAJECTORY_HISTORY_MS
+#define TRAJECTORY_HISTORY_MS 10000   // Window kept per track
+#endif
+
+#ifndef TRAJECTORY_SAMPLE_MS
+#define TRAJECTORY_SAMPLE_MS 125      // Minimum spacing between stored samples
+#endif
+
+#define TRAJECTORY_MAX_TRACKS KALMAN_MAX_TRACKS                      // Track slots
+#define TRAJECTORY_DEPTH (TRAJECTORY_HISTORY_MS / TRAJECTORY_SAMPLE_MS)  // Samples per track
+#define TRAJECTORY_TIME_UNIT_MS 10     // Sample timestamp resolution (16-bit, wraps after ~655 s)
+
+// ========== DATA STRUCTURES ==========
+
+// One stored position - 8 bytes
+typedef struct {
+    int16_t x;      // X (mm, saturated to ±32.7 m)
+    int16_t y;      // Y (mm)
+    int16_t z;      // Z (mm)
+    uint16_t t;     // Timestamp in TRAJECTORY_TIME_UNIT_MS units (wrapping)
+} trajectory_sample_t;
+
+// Copy of one track's history, oldest sample first
+typedef struct {
+    uint16_t track_id;                             // Kalman track ID
+    uint16_t count;                                // Valid samples
+    trajectory_sample_t samples[TRAJECTORY_DEPTH];
+} trajectory_track_t;
+
+// Store statistics
+typedef struct {
+    uint32_t memory_bytes;    // Static storage reserved for all slots
+    uint32_t tracks;          // Slots holding a trail
+    uint32_t samples;         // Samples currently stored
+    uint32_t samples_total;   // Samples recorded since boot
+    uint32_t evictions;       // Ended trails dropped early because every slot was in use
+    uint32_t refused;         // Samples not stored because every slot held a live trail
+} trajectory_store_stats_t;
+
+// ========== API FUNCTIONS ==========
+
+/**
+ * Initialize store (drops all trails)
+ */
+void trajectory_store_init(void);
+
+/**
+ * Record the current tracked positions
+ *
+ * Targets with track_id 0 (untracked) are ignored. A track gets a new sample
+ * at most every TRAJECTORY_SAMPLE_MS; trails expire TRAJECTORY_HISTORY_MS
+ * after their last sample.
+ *
+ * @param targets Tracked targets from kalman_tracker_update()
+ * @param count Number of targets
+ */
+void trajectory_store_update(const hlk_target_t* targets, int32_t count);
+
+/**
+ * Copy one slot's trail, dropping samples older than TRAJECTORY_HISTORY_MS
+ * @param slot Slot index (0 to TRAJECTORY_MAX_TRACKS-1)
+ * @param track Output trail
+ * @param now_ms Output: time of the copy (hlk_port_millis), for sample ages
+ * @return true if the slot holds a trail
+ */
+bool trajectory_store_get(int slot, trajectory_track_t* track, uint32_t* now_ms);
+
+/**
+ * Age of a sample relative to a trajectory_store_get() copy
+ * @param sample Stored sample
+ * @param now_ms Time returned by trajectory_store_get()
+ * @return Age in ms
+ */
+uint32_t trajectory_store_sample_age_ms(const trajectory_sample_t* sample, uint32_t now_ms);
+
+/**
+ * Get store statistics
+ * @param stats Output statistics
+ */
+void trajectory_store_get_stats(trajectory_store_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRAJECTORY_STORE_H
@@ -0,0 +1,212 @@
+// Tripwire Implementation
+//
+// Every frame, each tracked target's step from its previous position is
+// tested against every line: the step crosses when the target ends up on the
+// other side of the line and the line's endpoints lie on opposite sides of
+// the step. Side tests are integer cross products. A target standing exactly
+// on a line keeps the side it came from, so touching a line and turning back
+// never counts. Previous positions and sides live in a small open-addressed
+// table keyed by track ID, rebuilt each frame.
+
+#include "tripwire.h"
+#include "hlk_port.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "Tripwire";
+
+#define TRIPWIRE_HASH_SLOTS 32  // Power of two, at least 2x TRIPWIRE_MAX_TRACKS
+
+_Static_assert((TRIPWIRE_HASH_SLOTS & (TRIPWIRE_HASH_SLOTS - 1)) == 0, "TRIPWIRE_HASH_SLOTS must be a power of two");
+_Static_assert(TRIPWIRE_HASH_SLOTS >= 2 * TRIPWIRE_MAX_TRACKS, "TRIPWIRE_HASH_SLOTS too small");
+
+typedef struct {
+    uint16_t id;                        // 0 = empty slot
+    int8_t side[TRIPWIRE_MAX_LINES];    // Last strict side per line: 1 = left, -1 = right, 0 = unknown
+    int32_t x, y;                       // Position in the frame it was stored (mm)
+} track_pos_t;
+
+// ========== GLOBAL STATE ==========
+
+static tripwire_line_t g_lines[TRIPWIRE_MAX_LINES];
+static tripwire_counts_t g_counts[TRIPWIRE_MAX_LINES];
+static int g_line_count = 0;
+static track_pos_t g_positions[2][TRIPWIRE_HASH_SLOTS];  // Previous / current frame
+static int g_prev = 0;
+static hlk_port_mutex_t g_mutex = NULL;
+static tripwire_stats_t g_stats = {0};
+
+// ========== HELPER FUNCTIONS ==========
+
+static int32_t clamp_mm(int32_t mm) {
+    if (mm > 2 * TRIPWIRE_COORD_LIMIT_MM) return 2 * TRIPWIRE_COORD_LIMIT_MM;
+    if (mm < -2 * TRIPWIRE_COORD_LIMIT_MM) return -2 * TRIPWIRE_COORD_LIMIT_MM;
+    return mm;
+}
+
+// Cross product (b - a) x (p - a): > 0 when p is left of a→b
+static int64_t side_of(int32_t ax, int32_t ay, int32_t bx, int32_t by, int32_t px, int32_t py) {
+    return (int64_t)(bx - ax) * (py - ay) - (int64_t)(by - ay) * (px - ax);
+}
+
+static int8_t sign_of(int64_t v) {
+    return (int8_t)((v > 0) - (v < 0));
+}
+
+static const track_pos_t* find_track(const track_pos_t* table, uint16_t id) {
+    for (uint32_t i = 0, slot = id; i < TRIPWIRE_HASH_SLOTS; i++, slot++) {
+        const track_pos_t* pos = &table[slot & (TRIPWIRE_HASH_SLOTS - 1)];
+        if (pos->id == id) return pos;
+        if (pos->id == 0) return NULL;
+    }
+    return NULL;
+}
+
+static track_pos_t* store_track(track_pos_t* table, uint16_t id, int32_t x, int32_t y) {
+    for (uint32_t i = 0, slot = id; i < TRIPWIRE_HASH_SLOTS; i++, slot++) {
+        track_pos_t* pos = &table[slot & (TRIPWIRE_HASH_SLOTS - 1)];
+        if (pos->id == 0 || pos->id == id) {
+            pos->id = id;
+            pos->x = x;
+            pos->y = y;
+            return pos;
+        }
+    }
+    return NULL;
+}
+
+// ========== API FUNCTIONS ==========
+
+void tripwire_init(void) {
+    if (!g_mutex) {
+        g_mutex = hlk_port_mutex_create();
+    }
+    hlk_port_mutex_lock(g_mutex);
+    g_line_count = 0;
+    memset(g_counts, 0, sizeof(g_counts));
+    memset(g_positions, 0, sizeof(g_positions));
+    memset(&g_stats, 0, sizeof(g_stats));
+    hlk_port_mutex_unlock(g_mutex);
+
+    ESP_LOGI(TAG, "✅ Tripwire stage ready (up to %d lines)", TRIPWIRE_MAX_LINES);
+}
+
+esp_err_t tripwire_set_lines(const tripwire_line_t* lines, int count) {
+    if (count < 0 || count > TRIPWIRE_MAX_LINES || (count > 0 && !lines)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < count; i++) {
+        const tripwire_line_t* l = &lines[i];
+        if (l->ax_mm < -TRIPWIRE_COORD_LIMIT_MM || l->ax_mm > TRIPWIRE_COORD_LIMIT_MM ||
+            l->ay_mm < -TRIPWIRE_COORD_LIMIT_MM || l->ay_mm > TRIPWIRE_COORD_LIMIT_MM ||
+            l->bx_mm < -TRIPWIRE_COORD_LIMIT_MM || l->bx_mm > TRIPWIRE_COORD_LIMIT_MM ||
+            l->by_mm < -TRIPWIRE_COORD_LIMIT_MM || l->by_mm > TRIPWIRE_COORD_LIMIT_MM ||
+            (l->ax_mm == l->bx_mm && l->ay_mm == l->by_mm)) {
+            ESP_LOGW(TAG, "Line %d rejected: endpoints must differ and lie within ±%d mm",
+                     i, TRIPWIRE_COORD_LIMIT_MM);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    hlk_port_mutex_lock(g_mutex);
+    if (count > 0) {
+        memcpy(g_lines, lines, count * sizeof(tripwire_line_t));
+    }
+    for (int i = 0; i < count; i++) {
+        g_lines[i].name[TRIPWIRE_NAME_LEN - 1] = '\0';
+    }
+    g_line_count = count;
+    memset(g_counts, 0, sizeof(g_counts));
+    memset(g_positions, 0, sizeof(g_positions));  // Remembered sides refer to the old lines
+    hlk_port_mutex_unlock(g_mutex);
+
+    ESP_LOGI(TAG, "🚪 %d tripwire%s defined", count, count == 1 ? "" : "s");
+    return ESP_OK;
+}
+
+int tripwire_get_lines(tripwire_line_t* lines, tripwire_counts_t* counts, int max) {
+    hlk_port_mutex_lock(g_mutex);
+    int count = g_line_count;
+    int n = count < max ? count : max;
+    if (lines && n > 0) memcpy(lines, g_lines, n * sizeof(tripwire_line_t));
+    if (counts && n > 0) memcpy(counts, g_counts, n * sizeof(tripwire_counts_t));
+    hlk_port_mutex_unlock(g_mutex);
+    return count;
+}
+
+int tripwire_update(const hlk_target_t* targets, int32_t count,
+                    tripwire_event_t* events, int max_events) {
+    int crossings = 0;
+
+    hlk_port_mutex_lock(g_mutex);
+    const track_pos_t* prev = g_positions[g_prev];
+    track_pos_t* cur = g_positions[g_prev ^ 1];
+    memset(cur, 0, sizeof(g_positions[0]));
+
+    for (int32_t t = 0; t < count; t++) {
+        uint16_t id = targets[t].track_id;
+        if (id == 0) {
+            g_stats.untracked++;
+            continue;
+        }
+        int32_t x1 = clamp_mm(HLK_COORD_TO_MM(targets[t].x));
+        int32_t y1 = clamp_mm(HLK_COORD_TO_MM(targets[t].y));
+        track_pos_t* now = store_track(cur, id, x1, y1);
+        if (!now) continue;
+
+        const track_pos_t* last = find_track(prev, id);
+        bool jumped = false;
+        if (last) {
+            int64_t dx = x1 - last->x, dy = y1 - last->y;
+            jumped = dx * dx + dy * dy > (int64_t)TRIPWIRE_MAX_STEP_MM * TRIPWIRE_MAX_STEP_MM;
+            if (jumped && g_line_count > 0) g_stats.jumps_ignored++;
+        }
+
+        for (int l = 0; l < g_line_count; l++) {
+            const tripwire_line_t* line = &g_lines[l];
+            int8_t was = last ? last->side[l] : 0;
+            int8_t side = sign_of(side_of(line->ax_mm, line->ay_mm, line->bx_mm, line->by_mm, x1, y1));
+            now->side[l] = side ? side : was;  // On the line: keep the side it came from
+            if (!last || jumped) continue;
+
+            // Ended strictly on the other side of the line's supporting line...
+            g_stats.tests++;
+            if (side == 0 || was == 0 || side == was) continue;
+
+            // ...and the step passed between the line's endpoints (touching counts)
+            int64_t sa = side_of(last->x, last->y, x1, y1, line->ax_mm, line->ay_mm);
+            int64_t sb = side_of(last->x, last->y, x1, y1, line->bx_mm, line->by_mm);
+            if ((sa > 0 && sb > 0) || (sa < 0 && sb < 0)) continue;
+
+            bool in = side > 0;
+            if (in) g_counts[l].in++;
+            else g_counts[l].out++;
+            g_stats.crossings++;
+
+            if (events && crossings < max_events) {
+                tripwire_event_t* e = &events[crossings];
+                e->line = (uint8_t)l;
+                e->in = in;
+                e->track_id = id;
+                e->in_count = g_counts[l].in;
+                e->out_count = g_counts[l].out;
+                memcpy(e->name, g_lines[l].name, TRIPWIRE_NAME_LEN);
+            }
+            crossings++;
+        }
+    }
+
+    g_prev ^= 1;
+    g_stats.frames++;
+    hlk_port_mutex_unlock(g_mutex);
+
+    return crossings;
+}
+
+void tripwire_get_stats(tripwire_stats_t* stats) {
+    if (!stats) return;
+
+    hlk_port_mutex_lock(g_mutex);
+    *stats = g_stats;
+    hlk_port_mutex_unlock(g_mutex);
+}
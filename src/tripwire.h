@@ -0,0 +1,118 @@
+// Tripwire Module
+// Directional virtual lines that count tracked people crossing them in and
+// out, using segment intersection between consecutive track positions
+
+#ifndef TRIPWIRE_H
+#define TRIPWIRE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "hlk_ld6002.h"
+#include "kalman_tracker.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== CONFIGURATION ==========
+
+#ifndef TRIPWIRE_MAX_LINES
+#define TRIPWIRE_MAX_LINES 8            // Line slots
+#endif
+
+#ifndef TRIPWIRE_MAX_STEP_MM
+#define TRIPWIRE_MAX_STEP_MM 1500       // Longer jumps between frames (ID swaps, glitches) never count
+#endif
+
+#define TRIPWIRE_MAX_TRACKS KALMAN_MAX_TRACKS   // Track positions remembered between frames
+#define TRIPWIRE_COORD_LIMIT_MM 16000   // Line endpoint range
+#define TRIPWIRE_NAME_LEN 16            // Including terminator
+
+// ========== DATA STRUCTURES ==========
+
+// Line from A to B in the sensor's X/Y plane (mm). Walking across it from
+// the right-hand side of A→B to the left-hand side counts as "in".
+typedef struct {
+    char name[TRIPWIRE_NAME_LEN];
+    int16_t ax_mm, ay_mm;
+    int16_t bx_mm, by_mm;
+} tripwire_line_t;
+
+// Crossing reported by tripwire_update()
+typedef struct {
+    uint8_t line;            // Line index
+    bool in;                 // true = right→left of A→B, false = left→right
+    uint16_t track_id;       // Track that crossed
+    uint32_t in_count;       // Line totals after this crossing
+    uint32_t out_count;
+    char name[TRIPWIRE_NAME_LEN];  // Line name, copied with the counts (lines may be replaced meanwhile)
+} tripwire_event_t;
+
+// Per-line totals
+typedef struct {
+    uint32_t in;
+    uint32_t out;
+} tripwire_counts_t;
+
+// Stage statistics
+typedef struct {
+    uint32_t frames;         // tripwire_update() calls
+    uint32_t tests;          // Track-step x line intersection tests
+    uint32_t crossings;      // Crossings counted
+    uint32_t jumps_ignored;  // Steps longer than TRIPWIRE_MAX_STEP_MM
+    uint32_t untracked;      // Targets without a track ID (tracking off)
+} tripwire_stats_t;
+
+// ========== API FUNCTIONS ==========
+
+/**
+ * Initialize stage (no lines, no remembered tracks)
+ */
+void tripwire_init(void);
+
+/**
+ * Replace all lines; counters restart at zero
+ * @param lines Line definitions
+ * @param count Number of lines (0 to TRIPWIRE_MAX_LINES, 0 removes all)
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG for a degenerate or out-of-range line
+ */
+esp_err_t tripwire_set_lines(const tripwire_line_t* lines, int count);
+
+/**
+ * Copy the current lines and their counters
+ * @param lines Output definitions (may be NULL)
+ * @param counts Output counters (may be NULL)
+ * @param max Capacity of the output arrays
+ * @return Number of lines defined
+ */
+int tripwire_get_lines(tripwire_line_t* lines, tripwire_counts_t* counts, int max);
+
+/**
+ * Test one frame of tracked targets against every line
+ *
+ * Each target with a track ID is compared with its position in the previous
+ * frame; a step that carries it across a line counts once, in the direction
+ * of travel. A position exactly on a line keeps the side it came from.
+ * O(tracks x lines).
+ *
+ * @param targets Tracked targets (track_id 0 is ignored)
+ * @param count Number of targets
+ * @param events Output crossings (may be NULL)
+ * @param max_events Capacity of events
+ * @return Number of crossings this frame (events beyond max_events are counted but not reported)
+ */
+int tripwire_update(const hlk_target_t* targets, int32_t count,
+                    tripwire_event_t* events, int max_events);
+
+/**
+ * Get stage statistics
+ * @param stats Output statistics
+ */
+void tripwire_get_stats(tripwire_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRIPWIRE_H
@@ -2,10 +2,21 @@
 // SSE provides real-time updates with ~100ms latency, perfect for 20Hz radar data
 
 #include "web_server.h"
+#include "trajectory_store.h"
+#include "occupancy_map.h"
+#include "target_tracker.h"
+#include "zone_engine.h"
+#include "tripwire.h"
+#include "presence_fsm.h"
+#include "task_profiler.h"
+#include "device_state.h"
+#include <stdlib.h>
 #include "esp_http_server.h"
 #include "esp_log.h"
 #include "cJSON.h"
+#include "esp_random.h"
 #include <string.h>
+#include <math.h>
 
 static const char *TAG = "WebServer";
 
@@ -15,18 +26,63 @@ static httpd_handle_t server = NULL;
 // Client tracking for statistics
 static int client_count = 0;
 
-// Shared message buffer for SSE
-static char message_buffer[1024];
+// SSE message ring - each slot holds a fully framed event ("data: ...\n\n").
+// Clients remember the last sequence number they sent, so back-to-back
+// messages (targets + point cloud + presence from one UART burst) are not
+// lost to overwrites and duplicates are never resent.
+typedef struct {
+    uint16_t len;
+    char data[WEB_SSE_MSG_SIZE];
+} sse_slot_t;
+
+static sse_slot_t sse_ring[WEB_SSE_RING_SLOTS];
+static uint32_t sse_seq = 0;  // Sequence number of the newest message
 static SemaphoreHandle_t message_mutex = NULL;
 
+// A full target list or point cloud must fit one event, framing included
+_Static_assert(sizeof("data: {\"type\":\"target\",\"data\":[]}\n\n") + HLK_MAX_TARGETS * WEB_SSE_TARGET_JSON_MAX
+               <= WEB_SSE_MSG_SIZE, "WEB_SSE_MSG_SIZE too small for HLK_MAX_TARGETS");
+_Static_assert(sizeof("data: {\"type\":\"cloud\",\"data\":[]}\n\n") + HLK_MAX_CLOUD_POINTS * WEB_SSE_CLOUD_JSON_MAX
+               <= WEB_SSE_MSG_SIZE, "WEB_SSE_MSG_SIZE too small for HLK_MAX_CLOUD_POINTS");
+
+// Scratch buffer for hand-formatted target / zone count JSON (built by the publish task)
+static char frame_json[WEB_SSE_MSG_SIZE];
+
+// Point cloud JSON is built on the cloud viewer's own event bus task
+static char cloud_json[WEB_SSE_MSG_SIZE];
+
+// Per-track chunk for GET /trajectories (httpd task only): "[age,x,y,z]" is at most 29 chars
+#define TRAJECTORY_JSON_SIZE (TRAJECTORY_DEPTH * 29 + 64)
+static char trajectory_json[TRAJECTORY_JSON_SIZE];
+static trajectory_track_t trajectory_copy;
+
+// Row buffers for GET /heatmap (httpd task only): a count is at most 6 chars in JSON
+static uint16_t heatmap_row[OCCUPANCY_GRID_W];
+static char heatmap_json[OCCUPANCY_GRID_W * 6 + 256];
+
+// Response buffer for GET /zones (httpd task only)
+static zone_analytics_t zone_analytics;
+static char zone_json[2048];
+
+// Per-zone chunk for GET /polygon_zones (httpd task only). Longest zone object:
+// 15-char name, ZONE_ENGINE_MAX_VERTICES ",[-16000,-16000]" pairs, a z range and a count
+#define ZONE_JSON_VERTEX_MAX 16
+#define ZONE_JSON_CHUNK_MAX (sizeof(",{\"name\":\"\",\"points\":[],\"z\":[-16000,-16000],\"count\":65535}") + \
+                             (ZONE_ENGINE_NAME_LEN - 1) + ZONE_ENGINE_MAX_VERTICES * ZONE_JSON_VERTEX_MAX)
+_Static_assert(ZONE_ENGINE_COORD_LIMIT_MM <= 99999, "zone coordinates must print in at most 5 digits");
+
+// Polygon zone definitions are uploaded as JSON of up to this size
+#define ZONE_ENGINE_POST_MAX 16384
+
+// Tripwire definitions are far smaller
+#define TRIPWIRE_POST_MAX 2048
+
+// Presence hysteresis updates
+#define PRESENCE_POST_MAX 1024
+
 // Command queue for radar control
 static QueueHandle_t cmd_queue = NULL;
 
-// Zone data storage
-static zone_bounds_t detection_zones[4] = {0};
-static zone_bounds_t interference_zones[4] = {0};
-static SemaphoreHandle_t zone_mutex = NULL;
-
 // Embedded HTML file (minified and combined from webapp.html/css/js)
 extern const uint8_t index_html_start[] asm("_binary_webapp_min_html_start");
 extern const uint8_t index_html_end[]   asm("_binary_webapp_min_html_end");
@@ -68,20 +124,30 @@ static esp_err_t sse_handler(httpd_req_t *req) {
     }
     
     // Keep connection alive and send data
-    char last_msg[1024] = {0};
-    for (int i = 0; i < 36000; i++) {  // Max 1 hour (36000 * 100ms)
-        // Check if there's a new message
+    uint32_t last_seq = 0;
+    if (message_mutex && xSemaphoreTake(message_mutex, portMAX_DELAY) == pdTRUE) {
+        last_seq = sse_seq;  // Only stream messages queued after connecting
+        xSemaphoreGive(message_mutex);
+    }
+    
+    // Presence is only broadcast on transitions - give the newcomer the current state
+    web_server_send_presence(presence_fsm_is_present(0), presence_fsm_is_present(1),
+                             presence_fsm_is_present(2), presence_fsm_is_present(3));
+    
+    bool connected = true;
+    for (int i = 0; i < 36000 && connected; i++) {  // Max 1 hour (36000 * 100ms)
+        // Send every message queued since the last pass, oldest first
         if (message_mutex && xSemaphoreTake(message_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-            if (strlen(message_buffer) > 0 && strcmp(message_buffer, last_msg) != 0) {
-                // Format as SSE
-                char sse_msg[1100];
-                snprintf(sse_msg, sizeof(sse_msg), "data: %s\n\n", message_buffer);
-                
-                if (httpd_resp_send_chunk(req, sse_msg, strlen(sse_msg)) != ESP_OK) {
-                    xSemaphoreGive(message_mutex);
+            if (sse_seq - last_seq > WEB_SSE_RING_SLOTS) {
+                last_seq = sse_seq - WEB_SSE_RING_SLOTS;  // Fell behind - skip overwritten slots
+            }
+            while (last_seq != sse_seq) {
+                const sse_slot_t *slot = &sse_ring[(last_seq + 1) % WEB_SSE_RING_SLOTS];
+                if (httpd_resp_send_chunk(req, slot->data, slot->len) != ESP_OK) {
+                    connected = false;
                     break;
                 }
-                strncpy(last_msg, message_buffer, sizeof(last_msg) - 1);
+                last_seq++;
             }
             xSemaphoreGive(message_mutex);
         }
@@ -157,6 +223,44 @@ static esp_err_t config_post_handler(httpd_req_t *req) {
         cmd.type = RADAR_CMD_AUTO_GEN_INTERFERENCE_ZONE;
     } else if (strcmp(cmd_str, "get_zones") == 0) {
         cmd.type = RADAR_CMD_GET_ZONES;
+    } else if (strcmp(cmd_str, "voxel_size") == 0) {
+        cmd.type = RADAR_CMD_SET_VOXEL_SIZE;
+        if (value_json && cJSON_IsNumber(value_json) &&
+            value_json->valueint >= 0 && value_json->valueint <= CLOUD_VOXEL_MAX_SIZE_MM / 10) {
+            cmd.param = value_json->valueint;  // cm
+        } else {
+            valid_cmd = false;
+        }
+    } else if (strcmp(cmd_str, "point_cloud") == 0) {
+        cmd.type = RADAR_CMD_SET_POINT_CLOUD;
+        if (value_json && cJSON_IsString(value_json)) {
+            const char *val = value_json->valuestring;
+            if (strcmp(val, "on") == 0) cmd.param = 1;
+            else if (strcmp(val, "off") == 0) cmd.param = 0;
+            else valid_cmd = false;
+        } else {
+            valid_cmd = false;
+        }
+    } else if (strcmp(cmd_str, "clustering") == 0) {
+        cmd.type = RADAR_CMD_SET_CLUSTERING;
+        if (value_json && cJSON_IsString(value_json)) {
+            const char *val = value_json->valuestring;
+            if (strcmp(val, "on") == 0) cmd.param = 1;
+            else if (strcmp(val, "off") == 0) cmd.param = 0;
+            else valid_cmd = false;
+        } else {
+            valid_cmd = false;
+        }
+    } else if (strcmp(cmd_str, "tracking") == 0) {
+        cmd.type = RADAR_CMD_SET_TRACKING;
+        if (value_json && cJSON_IsString(value_json)) {
+            const char *val = value_json->valuestring;
+            if (strcmp(val, "on") == 0) cmd.param = 1;
+            else if (strcmp(val, "off") == 0) cmd.param = 0;
+            else valid_cmd = false;
+        } else {
+            valid_cmd = false;
+        }
     } else {
         valid_cmd = false;
     }
@@ -181,6 +285,634 @@ static esp_err_t config_post_handler(httpd_req_t *req) {
     return ESP_OK;
 }
 
+// GET handler for recent per-track trajectories
+// Streams one chunk per track so the response never needs the whole store in RAM
+static esp_err_t trajectories_get_handler(httpd_req_t *req) {
+    trajectory_store_stats_t stats;
+    trajectory_store_get_stats(&stats);
+    
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    
+    int pos = snprintf(trajectory_json, sizeof(trajectory_json),
+                       "{\"sample_ms\":%d,\"history_ms\":%d,\"memory_bytes\":%lu,\"tracks\":[",
+                       TRAJECTORY_SAMPLE_MS, TRAJECTORY_HISTORY_MS, stats.memory_bytes);
+    if (httpd_resp_send_chunk(req, trajectory_json, pos) != ESP_OK) return ESP_FAIL;
+    
+    int sent = 0;
+    for (int slot = 0; slot < TRAJECTORY_MAX_TRACKS; slot++) {
+        uint32_t now;
+        if (!trajectory_store_get(slot, &trajectory_copy, &now)) continue;
+        
+        // Points are [age_ms, x, y, z] in mm, oldest first
+        pos = snprintf(trajectory_json, sizeof(trajectory_json), "%s{\"id\":%u,\"points\":[",
+                       sent ? "," : "", (unsigned)trajectory_copy.track_id);
+        for (uint16_t i = 0; i < trajectory_copy.count; i++) {
+            const trajectory_sample_t *s = &trajectory_copy.samples[i];
+            pos += snprintf(&trajectory_json[pos], sizeof(trajectory_json) - pos, "%s[%lu,%d,%d,%d]",
+                            i ? "," : "", trajectory_store_sample_age_ms(s, now), s->x, s->y, s->z);
+        }
+        pos += snprintf(&trajectory_json[pos], sizeof(trajectory_json) - pos, "]}");
+        if (httpd_resp_send_chunk(req, trajectory_json, pos) != ESP_OK) return ESP_FAIL;
+        sent++;
+    }
+    
+    if (httpd_resp_send_chunk(req, "]}", 2) != ESP_OK) return ESP_FAIL;
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+// GET handler for the occupancy heatmap
+// Default is the binary export (occupancy_header_t + uint16 counts, little-endian);
+// ?format=json wraps the same data in JSON. Rows are read one at a time, so the
+// publish task only ever waits for a single row copy.
+static esp_err_t heatmap_get_handler(httpd_req_t *req) {
+    bool json = false;
+    char query[32];
+    char format[8];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "format", format, sizeof(format)) == ESP_OK) {
+        json = strcmp(format, "json") == 0;
+    }
+    
+    occupancy_header_t header;
+    occupancy_map_get_header(&header);
+    
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    
+    if (!json) {
+        // ESP32-C3 is little-endian, so structs and counts go out as stored
+        httpd_resp_set_type(req, "application/octet-stream");
+        if (httpd_resp_send_chunk(req, (const char *)&header, sizeof(header)) != ESP_OK) return ESP_FAIL;
+        for (int band = 0; band < OCCUPANCY_Z_BANDS; band++) {
+            for (int row = 0; row < OCCUPANCY_GRID_H; row++) {
+                occupancy_map_read_row(band, row, heatmap_row);
+                if (httpd_resp_send_chunk(req, (const char *)heatmap_row, sizeof(heatmap_row)) != ESP_OK) {
+                    return ESP_FAIL;
+                }
+            }
+        }
+        return httpd_resp_send_chunk(req, NULL, 0);
+    }
+    
+    httpd_resp_set_type(req, "application/json");
+    int pos = snprintf(heatmap_json, sizeof(heatmap_json),
+                       "{\"width\":%u,\"height\":%u,\"bands\":%u,\"cell_mm\":%u,"
+                       "\"origin_x_mm\":%d,\"origin_y_mm\":%d,\"band_mm\":%u,\"half_life_s\":%u,"
+                       "\"frames\":%lu,\"hits\":%lu,\"timestamp_ms\":%lu,\"counts\":[",
+                       header.width, header.height, header.bands, header.cell_mm,
+                       header.origin_x_mm, header.origin_y_mm, header.band_mm, header.half_life_s,
+                       header.frames, header.hits, header.timestamp_ms);
+    if (httpd_resp_send_chunk(req, heatmap_json, pos) != ESP_OK) return ESP_FAIL;
+    
+    for (int band = 0; band < OCCUPANCY_Z_BANDS; band++) {
+        for (int row = 0; row < OCCUPANCY_GRID_H; row++) {
+            occupancy_map_read_row(band, row, heatmap_row);
+            pos = 0;
+            for (int col = 0; col < OCCUPANCY_GRID_W; col++) {
+                bool first = band == 0 && row == 0 && col == 0;
+                pos += snprintf(&heatmap_json[pos], sizeof(heatmap_json) - pos, "%s%u",
+                                first ? "" : ",", heatmap_row[col]);
+            }
+            if (httpd_resp_send_chunk(req, heatmap_json, pos) != ESP_OK) return ESP_FAIL;
+        }
+    }
+    
+    if (httpd_resp_send_chunk(req, "]}", 2) != ESP_OK) return ESP_FAIL;
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+// GET handler for zone dwell-time and transition analytics
+static esp_err_t zones_get_handler(httpd_req_t *req) {
+    static const uint32_t edges_s[TRACKER_DWELL_BINS - 1] = TRACKER_DWELL_BIN_EDGES_S;
+    const size_t size = sizeof(zone_json);
+    
+    zone_tracker_get_analytics(&zone_analytics);
+    
+    int pos = snprintf(zone_json, size, "{\"now_ms\":%lu,\"since_ms\":%lu,\"frames\":%lu,\"dwell_edges_s\":[",
+                       zone_analytics.now, zone_analytics.since_time, zone_analytics.frames);
+    for (int i = 0; i < TRACKER_DWELL_BINS - 1 && pos < (int)size; i++) {
+        pos += snprintf(&zone_json[pos], size - pos, "%s%lu", i ? "," : "", edges_s[i]);
+    }
+    
+    if (pos < (int)size) pos += snprintf(&zone_json[pos], size - pos, "],\"zones\":[");
+    for (int i = 0; i < HLK_ZONE_COUNT && pos < (int)size; i++) {
+        const zone_dwell_t *z = &zone_analytics.zones[i];
+        uint32_t current_ms = z->occupied ? zone_analytics.now - z->enter_time : 0;
+        uint64_t total_ms = z->total_dwell_ms + current_ms;
+        pos += snprintf(&zone_json[pos], size - pos,
+                        "%s{\"zone\":%d,\"occupied\":%s,\"visits\":%lu,\"enter_ms\":%lu,\"exit_ms\":%lu,"
+                        "\"current_ms\":%lu,\"last_dwell_ms\":%lu,\"longest_dwell_ms\":%lu,"
+                        "\"total_dwell_s\":%lu.%03lu,\"histogram\":[",
+                        i ? "," : "", i, z->occupied ? "true" : "false", z->visits,
+                        z->enter_time, z->exit_time, current_ms, z->last_dwell_ms, z->longest_dwell_ms,
+                        (uint32_t)(total_ms / 1000), (uint32_t)(total_ms % 1000));
+        for (int b = 0; b < TRACKER_DWELL_BINS && pos < (int)size; b++) {
+            pos += snprintf(&zone_json[pos], size - pos, "%s%lu", b ? "," : "", z->dwell_histogram[b]);
+        }
+        if (pos < (int)size) pos += snprintf(&zone_json[pos], size - pos, "]}");
+    }
+    
+    // Rows are "from", columns "to"; index HLK_ZONE_COUNT is outside every zone
+    if (pos < (int)size) pos += snprintf(&zone_json[pos], size - pos, "],\"transitions\":[");
+    for (int from = 0; from <= HLK_ZONE_COUNT && pos < (int)size; from++) {
+        for (int to = 0; to <= HLK_ZONE_COUNT && pos < (int)size; to++) {
+            pos += snprintf(&zone_json[pos], size - pos, "%s%lu",
+                            to ? "," : (from ? ",[" : "["), zone_analytics.transitions[from][to]);
+        }
+        if (pos < (int)size) pos += snprintf(&zone_json[pos], size - pos, "]");
+    }
+    if (pos < (int)size) pos += snprintf(&zone_json[pos], size - pos, "]}");
+    
+    if (pos >= (int)size) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Zone analytics too large");
+        return ESP_FAIL;
+    }
+    
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    return httpd_resp_send(req, zone_json, pos);
+}
+
+// Copy a name into JSON, dropping chars that would need escapes
+static int json_copy_name(char *dst, int room, const char *name) {
+    int pos = 0;
+    for (const char *c = name; *c && pos < room; c++) {
+        if (*c >= 0x20 && *c != '"' && *c != '\\') dst[pos++] = *c;
+    }
+    return pos;
+}
+
+// GET handler for polygon zone definitions and their current person counts
+// One chunk per zone; the definitions are copied to the heap for the request
+static esp_err_t polygon_zones_get_handler(httpd_req_t *req) {
+    zone_engine_zone_t *zones = malloc(ZONE_ENGINE_MAX_ZONES * sizeof(zone_engine_zone_t));
+    if (!zones) {
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+    uint16_t counts[ZONE_ENGINE_MAX_ZONES];
+    int count = zone_engine_get_zones(zones, ZONE_ENGINE_MAX_ZONES);
+    zone_engine_get_counts(counts, ZONE_ENGINE_MAX_ZONES);
+    
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    
+    // Zone chunk: name, up to ZONE_ENGINE_MAX_VERTICES ",[x,y]" pairs, z range, count
+    char chunk[ZONE_JSON_CHUNK_MAX];
+    esp_err_t err = httpd_resp_send_chunk(req, "{\"zones\":[", 10);
+    for (int i = 0; i < count && err == ESP_OK; i++) {
+        const zone_engine_zone_t *z = &zones[i];
+        int pos = snprintf(chunk, sizeof(chunk), "%s{\"name\":\"", i ? "," : "");
+        pos += json_copy_name(&chunk[pos], ZONE_ENGINE_NAME_LEN - 1, z->name);
+        pos += snprintf(&chunk[pos], sizeof(chunk) - pos, "\",\"points\":[");
+        for (int v = 0; v < z->vertex_count && pos < (int)sizeof(chunk); v++) {
+            pos += snprintf(&chunk[pos], sizeof(chunk) - pos, "%s[%d,%d]", v ? "," : "", z->x_mm[v], z->y_mm[v]);
+        }
+        if (pos < (int)sizeof(chunk)) {
+            pos += snprintf(&chunk[pos], sizeof(chunk) - pos, "]");
+        }
+        if (z->prism && pos < (int)sizeof(chunk)) {
+            pos += snprintf(&chunk[pos], sizeof(chunk) - pos, ",\"z\":[%d,%d]", z->z_min_mm, z->z_max_mm);
+        }
+        if (pos < (int)sizeof(chunk)) {
+            pos += snprintf(&chunk[pos], sizeof(chunk) - pos, ",\"count\":%u}", counts[i]);
+        }
+        if (pos >= (int)sizeof(chunk)) {
+            ESP_LOGW(TAG, "Zone %d JSON too large, response aborted", i);
+            err = ESP_FAIL;
+            break;
+        }
+        err = httpd_resp_send_chunk(req, chunk, pos);
+    }
+    free(zones);
+    
+    if (err != ESP_OK || httpd_resp_send_chunk(req, "]}", 2) != ESP_OK) return ESP_FAIL;
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+// Parse one {"name":..,"points":[[x,y],...],"z":[min,max]} object (mm)
+static bool parse_polygon_zone(const cJSON *item, zone_engine_zone_t *zone) {
+    memset(zone, 0, sizeof(*zone));
+    
+    const cJSON *name = cJSON_GetObjectItem(item, "name");
+    if (name && cJSON_IsString(name)) {
+        strncpy(zone->name, name->valuestring, sizeof(zone->name) - 1);
+    }
+    
+    const cJSON *points = cJSON_GetObjectItem(item, "points");
+    int n = cJSON_IsArray(points) ? cJSON_GetArraySize(points) : 0;
+    if (n < 3 || n > ZONE_ENGINE_MAX_VERTICES) return false;
+    for (int v = 0; v < n; v++) {
+        const cJSON *pt = cJSON_GetArrayItem(points, v);
+        const cJSON *x = cJSON_GetArrayItem(pt, 0);
+        const cJSON *y = cJSON_GetArrayItem(pt, 1);
+        if (!cJSON_IsNumber(x) || !cJSON_IsNumber(y)) return false;
+        if (abs(x->valueint) > ZONE_ENGINE_COORD_LIMIT_MM || abs(y->valueint) > ZONE_ENGINE_COORD_LIMIT_MM) return false;
+        zone->x_mm[v] = (int16_t)x->valueint;
+        zone->y_mm[v] = (int16_t)y->valueint;
+    }
+    zone->vertex_count = (uint8_t)n;
+    
+    const cJSON *zr = cJSON_GetObjectItem(item, "z");
+    if (zr) {
+        const cJSON *z_min = cJSON_GetArrayItem(zr, 0);
+        const cJSON *z_max = cJSON_GetArrayItem(zr, 1);
+        if (!cJSON_IsNumber(z_min) || !cJSON_IsNumber(z_max)) return false;
+        if (abs(z_min->valueint) > ZONE_ENGINE_COORD_LIMIT_MM || abs(z_max->valueint) > ZONE_ENGINE_COORD_LIMIT_MM) return false;
+        zone->prism = true;
+        zone->z_min_mm = (int16_t)z_min->valueint;
+        zone->z_max_mm = (int16_t)z_max->valueint;
+    }
+    return true;
+}
+
+// POST handler replacing all polygon zones: {"zones":[...]}
+static esp_err_t polygon_zones_post_handler(httpd_req_t *req) {
+    if (req->content_len == 0 || req->content_len > ZONE_ENGINE_POST_MAX) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Body missing or too large");
+        return ESP_FAIL;
+    }
+    
+    char *body = malloc(req->content_len + 1);
+    zone_engine_zone_t *zones = malloc(ZONE_ENGINE_MAX_ZONES * sizeof(zone_engine_zone_t));
+    if (!body || !zones) {
+        free(body);
+        free(zones);
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+    
+    size_t received = 0;
+    while (received < req->content_len) {
+        int ret = httpd_req_recv(req, &body[received], req->content_len - received);
+        if (ret <= 0) {
+            free(body);
+            free(zones);
+            httpd_resp_send_500(req);
+            return ESP_FAIL;
+        }
+        received += ret;
+    }
+    body[received] = '\0';
+    
+    cJSON *root = cJSON_Parse(body);
+    free(body);
+    const cJSON *list = root ? cJSON_GetObjectItem(root, "zones") : NULL;
+    int count = cJSON_IsArray(list) ? cJSON_GetArraySize(list) : -1;
+    bool valid = count >= 0 && count <= ZONE_ENGINE_MAX_ZONES;
+    for (int i = 0; valid && i < count; i++) {
+        valid = parse_polygon_zone(cJSON_GetArrayItem(list, i), &zones[i]);
+    }
+    cJSON_Delete(root);
+    
+    if (!valid || zone_engine_set_zones(zones, count) != ESP_OK) {
+        free(zones);
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid zone list");
+        return ESP_FAIL;
+    }
+    free(zones);
+    
+    char resp[48];
+    snprintf(resp, sizeof(resp), "{\"status\":\"ok\",\"zones\":%d}", count);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, resp);
+    return ESP_OK;
+}
+
+// GET handler for tripwire definitions and their in/out counters
+static esp_err_t tripwires_get_handler(httpd_req_t *req) {
+    tripwire_line_t lines[TRIPWIRE_MAX_LINES];
+    tripwire_counts_t counts[TRIPWIRE_MAX_LINES];
+    int count = tripwire_get_lines(lines, counts, TRIPWIRE_MAX_LINES);
+    
+    // Per line: name (15) + two "[x,y]" pairs (14 each) + two counters (10 each) + keys
+    char json[TRIPWIRE_MAX_LINES * 128 + 16];
+    int pos = snprintf(json, sizeof(json), "{\"lines\":[");
+    for (int i = 0; i < count; i++) {
+        const tripwire_line_t *l = &lines[i];
+        pos += snprintf(&json[pos], sizeof(json) - pos, "%s{\"name\":\"", i ? "," : "");
+        pos += json_copy_name(&json[pos], TRIPWIRE_NAME_LEN, l->name);
+        pos += snprintf(&json[pos], sizeof(json) - pos,
+                        "\",\"a\":[%d,%d],\"b\":[%d,%d],\"in\":%lu,\"out\":%lu}",
+                        l->ax_mm, l->ay_mm, l->bx_mm, l->by_mm,
+                        (unsigned long)counts[i].in, (unsigned long)counts[i].out);
+    }
+    pos += snprintf(&json[pos], sizeof(json) - pos, "]}");
+    
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    return httpd_resp_send(req, json, pos);
+}
+
+// Parse one {"name":..,"a":[x,y],"b":[x,y]} object (mm)
+static bool parse_tripwire(const cJSON *item, tripwire_line_t *line) {
+    memset(line, 0, sizeof(*line));
+    
+    const cJSON *name = cJSON_GetObjectItem(item, "name");
+    if (name && cJSON_IsString(name)) {
+        strncpy(line->name, name->valuestring, sizeof(line->name) - 1);
+    }
+    
+    const cJSON *a = cJSON_GetObjectItem(item, "a");
+    const cJSON *b = cJSON_GetObjectItem(item, "b");
+    const cJSON *ax = cJSON_GetArrayItem(a, 0), *ay = cJSON_GetArrayItem(a, 1);
+    const cJSON *bx = cJSON_GetArrayItem(b, 0), *by = cJSON_GetArrayItem(b, 1);
+    if (!cJSON_IsNumber(ax) || !cJSON_IsNumber(ay) || !cJSON_IsNumber(bx) || !cJSON_IsNumber(by)) return false;
+    if (abs(ax->valueint) > TRIPWIRE_COORD_LIMIT_MM || abs(ay->valueint) > TRIPWIRE_COORD_LIMIT_MM ||
+        abs(bx->valueint) > TRIPWIRE_COORD_LIMIT_MM || abs(by->valueint) > TRIPWIRE_COORD_LIMIT_MM) return false;
+    line->ax_mm = (int16_t)ax->valueint;
+    line->ay_mm = (int16_t)ay->valueint;
+    line->bx_mm = (int16_t)bx->valueint;
+    line->by_mm = (int16_t)by->valueint;
+    return true;
+}
+
+// POST handler replacing all tripwires: {"lines":[...]}
+static esp_err_t tripwires_post_handler(httpd_req_t *req) {
+    if (req->content_len == 0 || req->content_len > TRIPWIRE_POST_MAX) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Body missing or too large");
+        return ESP_FAIL;
+    }
+    
+    char body[TRIPWIRE_POST_MAX + 1];
+    size_t received = 0;
+    while (received < req->content_len) {
+        int ret = httpd_req_recv(req, &body[received], req->content_len - received);
+        if (ret <= 0) {
+            httpd_resp_send_500(req);
+            return ESP_FAIL;
+        }
+        received += ret;
+    }
+    body[received] = '\0';
+    
+    tripwire_line_t lines[TRIPWIRE_MAX_LINES];
+    cJSON *root = cJSON_Parse(body);
+    const cJSON *list = root ? cJSON_GetObjectItem(root, "lines") : NULL;
+    int count = cJSON_IsArray(list) ? cJSON_GetArraySize(list) : -1;
+    bool valid = count >= 0 && count <= TRIPWIRE_MAX_LINES;
+    for (int i = 0; valid && i < count; i++) {
+        valid = parse_tripwire(cJSON_GetArrayItem(list, i), &lines[i]);
+    }
+    cJSON_Delete(root);
+    
+    if (!valid || tripwire_set_lines(lines, count) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid tripwire list");
+        return ESP_FAIL;
+    }
+    
+    char resp[48];
+    snprintf(resp, sizeof(resp), "{\"status\":\"ok\",\"lines\":%d}", count);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, resp);
+    return ESP_OK;
+}
+
+static const char *const presence_channel_names[PRESENCE_FSM_CHANNELS] = {
+    "zone0", "zone1", "zone2", "zone3", "person"
+};
+
+// GET handler for the debounced presence channels, their hysteresis and counters
+static esp_err_t presence_get_handler(httpd_req_t *req) {
+    char json[PRESENCE_FSM_CHANNELS * 256 + 16];
+    int pos = snprintf(json, sizeof(json), "{\"channels\":[");
+    for (int i = 0; i < PRESENCE_FSM_CHANNELS; i++) {
+        presence_fsm_channel_t ch;
+        presence_fsm_config_t cfg;
+        presence_fsm_get_channel(i, &ch);
+        presence_fsm_get_config(i, &cfg);
+        pos += snprintf(&json[pos], sizeof(json) - pos,
+                        "%s{\"channel\":\"%s\",\"state\":\"%s\",\"present\":%s,\"since_ms\":%lu,"
+                        "\"enter_ms\":%lu,\"exit_ms\":%lu,\"hold_ms\":%lu,"
+                        "\"frames\":%lu,\"raw_changes\":%lu,\"transitions\":%lu,\"suppressed\":%lu}",
+                        i ? "," : "", presence_channel_names[i], presence_fsm_state_name(ch.state),
+                        ch.present ? "true" : "false", (unsigned long)ch.since_ms,
+                        (unsigned long)cfg.enter_ms, (unsigned long)cfg.exit_ms, (unsigned long)cfg.hold_ms,
+                        (unsigned long)ch.frames, (unsigned long)ch.raw_changes,
+                        (unsigned long)ch.transitions, (unsigned long)ch.suppressed);
+    }
+    pos += snprintf(&json[pos], sizeof(json) - pos, "]}");
+    
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    return httpd_resp_send(req, json, pos);
+}
+
+// GET handler for per-task CPU share and stack headroom (FreeRTOS run-time stats)
+// CPU values are permille of the sampling interval; history is oldest first
+static esp_err_t tasks_get_handler(httpd_req_t *req) {
+    static task_profiler_task_t tasks[TASK_PROFILER_MAX_TASKS];  // httpd task only
+    task_profiler_stats_t stats;
+    task_profiler_get_stats(&stats);
+    int count = task_profiler_get_tasks(tasks, TASK_PROFILER_MAX_TASKS);
+    
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    
+    char json[TASK_PROFILER_SAMPLES * 6 + 256];
+    int pos = snprintf(json, sizeof(json),
+                       "{\"available\":%s,\"period_ms\":%d,\"interval_us\":%lu,\"samples\":%lu,"
+                       "\"task_count\":%lu,\"untracked\":%lu,\"sample_us\":%lu,\"tasks\":[",
+                       stats.available ? "true" : "false", TASK_PROFILER_PERIOD_MS,
+                       (unsigned long)stats.interval_us, (unsigned long)stats.samples,
+                       (unsigned long)stats.tasks, (unsigned long)stats.untracked,
+                       (unsigned long)stats.sample_us);
+    if (httpd_resp_send_chunk(req, json, pos) != ESP_OK) return ESP_FAIL;
+    
+    // One chunk per task
+    for (int i = 0; i < count; i++) {
+        const task_profiler_task_t *t = &tasks[i];
+        char name[TASK_PROFILER_NAME_LEN];
+        int name_len = json_copy_name(name, sizeof(name), t->name);
+        pos = snprintf(json, sizeof(json),
+                       "%s{\"name\":\"%.*s\",\"priority\":%u,\"cpu\":%u,\"cpu_avg\":%u,\"cpu_max\":%u,"
+                       "\"stack_free\":%lu,\"stack_min_free\":%lu,\"history\":[",
+                       i ? "," : "", name_len, name, t->priority, t->cpu_permille, t->cpu_avg_permille,
+                       t->cpu_max_permille, (unsigned long)t->stack_free, (unsigned long)t->stack_min_free);
+        for (uint16_t k = 0; k < t->samples; k++) {
+            pos += snprintf(&json[pos], sizeof(json) - pos, "%s%u", k ? "," : "", t->history[k]);
+        }
+        pos += snprintf(&json[pos], sizeof(json) - pos, "]}");
+        if (httpd_resp_send_chunk(req, json, pos) != ESP_OK) return ESP_FAIL;
+    }
+    
+    if (httpd_resp_send_chunk(req, "]}", 2) != ESP_OK) return ESP_FAIL;
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+// Boot-unique part of the /state ETag (versions restart at 0 on every boot)
+static uint32_t state_boot_id = 0;
+
+// Z range is reported as raw floats - clamp so NaN/inf never reach the JSON
+static long state_mm(float m) {
+    if (!(m > -1000000.0f && m < 1000000.0f)) return 0;
+    return lroundf(m * 1000.0f);
+}
+
+// Zone set as [x_min,x_max,y_min,y_max,z_min,z_max] boxes in integer mm
+static int state_zones(char *buf, int size, const hlk_zone_t *zones) {
+    int pos = snprintf(buf, size, "[");
+    for (int i = 0; i < HLK_ZONE_COUNT && pos < size; i++) {
+        const hlk_zone_t *z = &zones[i];
+        pos += snprintf(&buf[pos], size - pos, "%s[%ld,%ld,%ld,%ld,%ld,%ld]", i ? "," : "",
+                        (long)HLK_COORD_TO_MM(z->x_min), (long)HLK_COORD_TO_MM(z->x_max),
+                        (long)HLK_COORD_TO_MM(z->y_min), (long)HLK_COORD_TO_MM(z->y_max),
+                        (long)HLK_COORD_TO_MM(z->z_min), (long)HLK_COORD_TO_MM(z->z_max));
+    }
+    if (pos < size) pos += snprintf(&buf[pos], size - pos, "]");
+    return pos;
+}
+
+// Format one cached field's value; returns its length (>= size if it did not fit)
+static int state_value(char *buf, int size, const device_state_t *state, device_state_field_t field) {
+    switch (field) {
+        case DEVICE_STATE_HOLD_DELAY:
+            return snprintf(buf, size, "%lu", (unsigned long)state->hold_delay_s);
+        case DEVICE_STATE_SENSITIVITY:
+            return snprintf(buf, size, "%u", state->sensitivity);
+        case DEVICE_STATE_TRIGGER_SPEED:
+            return snprintf(buf, size, "%u", state->trigger_speed);
+        case DEVICE_STATE_Z_RANGE:
+            return snprintf(buf, size, "[%ld,%ld]", state_mm(state->z_min_m), state_mm(state->z_max_m));
+        case DEVICE_STATE_INSTALL_METHOD:
+            return snprintf(buf, size, "%u", state->install_method);
+        case DEVICE_STATE_LOW_POWER_MODE:
+            return snprintf(buf, size, "%s", state->low_power_mode ? "true" : "false");
+        case DEVICE_STATE_LOW_POWER_TIME:
+            return snprintf(buf, size, "%lu", (unsigned long)state->low_power_time_ms);
+        case DEVICE_STATE_WORKING_MODE:
+            return snprintf(buf, size, "%u", state->working_mode);
+        case DEVICE_STATE_DETECTION_ZONES:
+            return state_zones(buf, size, state->detection_zones);
+        case DEVICE_STATE_INTERFERENCE_ZONES:
+            return state_zones(buf, size, state->interference_zones);
+        default:
+            return snprintf(buf, size, "null");
+    }
+}
+
+// GET handler for the cached radar settings and zones - answered from RAM,
+// never queries the sensor. Each field is "name":{"version":V,"age_ms":A,"value":...}
+// or null until reported; lengths (z_range, zones) are integer mm. Streamed one
+// chunk per field. The ETag changes only when a value does (If-None-Match -> 304)
+static esp_err_t state_get_handler(httpd_req_t *req) {
+    static device_state_t state;  // httpd task only
+    device_state_get(&state);
+    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    
+    char etag[24];
+    snprintf(etag, sizeof(etag), "\"%08lx-%lu\"", (unsigned long)state_boot_id, (unsigned long)state.version);
+    httpd_resp_set_hdr(req, "ETag", etag);
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    
+    char match[24];
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", match, sizeof(match)) == ESP_OK &&
+        strcmp(match, etag) == 0) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        return httpd_resp_send(req, NULL, 0);
+    }
+    
+    httpd_resp_set_type(req, "application/json");
+    char value[HLK_ZONE_COUNT * 80 + 8];  // Largest value: a zone set, 6 x 11 digits per zone
+    char chunk[sizeof(value) + 96];
+    int pos = snprintf(chunk, sizeof(chunk), "{\"version\":%lu,\"fields\":{", (unsigned long)state.version);
+    if (httpd_resp_send_chunk(req, chunk, pos) != ESP_OK) return ESP_FAIL;
+    
+    for (int f = 0; f < DEVICE_STATE_FIELDS; f++) {
+        const device_state_meta_t *meta = &state.meta[f];
+        const char *name = device_state_field_name(f);
+        if (!meta->known) {
+            pos = snprintf(chunk, sizeof(chunk), "%s\"%s\":null", f ? "," : "", name);
+        } else {
+            int len = state_value(value, sizeof(value), &state, f);
+            if (len >= (int)sizeof(value)) return ESP_FAIL;  // Cannot happen with bounded integers
+            pos = snprintf(chunk, sizeof(chunk), "%s\"%s\":{\"version\":%lu,\"age_ms\":%lu,\"value\":%s}",
+                           f ? "," : "", name, (unsigned long)meta->version,
+                           (unsigned long)(now - meta->updated_ms), value);
+        }
+        if (pos >= (int)sizeof(chunk)) return ESP_FAIL;
+        if (httpd_resp_send_chunk(req, chunk, pos) != ESP_OK) return ESP_FAIL;
+    }
+    
+    if (httpd_resp_send_chunk(req, "}}", 2) != ESP_OK) return ESP_FAIL;
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+// Read an optional delay field; keeps the current value when absent
+static bool parse_presence_delay(const cJSON *item, const char *key, uint32_t *value) {
+    const cJSON *field = cJSON_GetObjectItem(item, key);
+    if (!field) return true;
+    if (!cJSON_IsNumber(field) || field->valuedouble < 0 || field->valuedouble > PRESENCE_FSM_MAX_DELAY_MS) return false;
+    *value = (uint32_t)field->valuedouble;
+    return true;
+}
+
+// POST handler updating channel hysteresis: {"channels":[{"channel":"person","exit_ms":5000},...]}
+static esp_err_t presence_post_handler(httpd_req_t *req) {
+    if (req->content_len == 0 || req->content_len > PRESENCE_POST_MAX) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Body missing or too large");
+        return ESP_FAIL;
+    }
+    
+    char body[PRESENCE_POST_MAX + 1];
+    size_t received = 0;
+    while (received < req->content_len) {
+        int ret = httpd_req_recv(req, &body[received], req->content_len - received);
+        if (ret <= 0) {
+            httpd_resp_send_500(req);
+            return ESP_FAIL;
+        }
+        received += ret;
+    }
+    body[received] = '\0';
+    
+    // Validate everything before applying anything
+    int channels[PRESENCE_FSM_CHANNELS];
+    presence_fsm_config_t configs[PRESENCE_FSM_CHANNELS];
+    cJSON *root = cJSON_Parse(body);
+    const cJSON *list = root ? cJSON_GetObjectItem(root, "channels") : NULL;
+    int count = cJSON_IsArray(list) ? cJSON_GetArraySize(list) : -1;
+    bool valid = count >= 0 && count <= PRESENCE_FSM_CHANNELS;
+    for (int i = 0; valid && i < count; i++) {
+        const cJSON *item = cJSON_GetArrayItem(list, i);
+        const cJSON *name = cJSON_GetObjectItem(item, "channel");
+        channels[i] = -1;
+        for (int c = 0; cJSON_IsString(name) && c < PRESENCE_FSM_CHANNELS; c++) {
+            if (strcmp(name->valuestring, presence_channel_names[c]) == 0) channels[i] = c;
+        }
+        valid = channels[i] >= 0;
+        if (valid) {
+            presence_fsm_get_config(channels[i], &configs[i]);
+            valid = parse_presence_delay(item, "enter_ms", &configs[i].enter_ms) &&
+                    parse_presence_delay(item, "exit_ms", &configs[i].exit_ms) &&
+                    parse_presence_delay(item, "hold_ms", &configs[i].hold_ms);
+        }
+    }
+    cJSON_Delete(root);
+    
+    if (!valid) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid channel list");
+        return ESP_FAIL;
+    }
+    for (int i = 0; i < count; i++) {
+        presence_fsm_set_config(channels[i], &configs[i]);
+    }
+    
+    char resp[48];
+    snprintf(resp, sizeof(resp), "{\"status\":\"ok\",\"channels\":%d}", count);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, resp);
+    return ESP_OK;
+}
+
 esp_err_t web_server_init(void) {
     message_mutex = xSemaphoreCreateMutex();
     if (!message_mutex) {
@@ -188,11 +920,7 @@ esp_err_t web_server_init(void) {
         return ESP_FAIL;
     }
     
-    zone_mutex = xSemaphoreCreateMutex();
-    if (!zone_mutex) {
-        ESP_LOGE(TAG, "Failed to create zone mutex");
-        return ESP_FAIL;
-    }
+    state_boot_id = esp_random();
     
     // Create command queue
     cmd_queue = xQueueCreate(CMD_QUEUE_SIZE, sizeof(radar_cmd_t));
@@ -208,6 +936,7 @@ esp_err_t web_server_init(void) {
     config.recv_wait_timeout = 10;
     config.send_wait_timeout = 10;
     config.stack_size = 8192;  // Increase from default 4096 to handle large HTML file
+    config.max_uri_handlers = 16;  // Default 8 - page, SSE, config and the JSON/binary GET/POST endpoints
     
     ESP_LOGI(TAG, "Starting web server");
     
@@ -240,6 +969,94 @@ esp_err_t web_server_init(void) {
     };
     httpd_register_uri_handler(server, &config_uri);
     
+    httpd_uri_t trajectories_uri = {
+        .uri = "/trajectories",
+        .method = HTTP_GET,
+        .handler = trajectories_get_handler,
+        .user_ctx = NULL
+    };
+    httpd_register_uri_handler(server, &trajectories_uri);
+    
+    httpd_uri_t heatmap_uri = {
+        .uri = "/heatmap",
+        .method = HTTP_GET,
+        .handler = heatmap_get_handler,
+        .user_ctx = NULL
+    };
+    httpd_register_uri_handler(server, &heatmap_uri);
+    
+    httpd_uri_t zones_uri = {
+        .uri = "/zones",
+        .method = HTTP_GET,
+        .handler = zones_get_handler,
+        .user_ctx = NULL
+    };
+    httpd_register_uri_handler(server, &zones_uri);
+    
+    httpd_uri_t polygon_zones_get_uri = {
+        .uri = "/polygon_zones",
+        .method = HTTP_GET,
+        .handler = polygon_zones_get_handler,
+        .user_ctx = NULL
+    };
+    httpd_register_uri_handler(server, &polygon_zones_get_uri);
+    
+    httpd_uri_t polygon_zones_post_uri = {
+        .uri = "/polygon_zones",
+        .method = HTTP_POST,
+        .handler = polygon_zones_post_handler,
+        .user_ctx = NULL
+    };
+    httpd_register_uri_handler(server, &polygon_zones_post_uri);
+    
+    httpd_uri_t tripwires_get_uri = {
+        .uri = "/tripwires",
+        .method = HTTP_GET,
+        .handler = tripwires_get_handler,
+        .user_ctx = NULL
+    };
+    httpd_register_uri_handler(server, &tripwires_get_uri);
+    
+    httpd_uri_t tripwires_post_uri = {
+        .uri = "/tripwires",
+        .method = HTTP_POST,
+        .handler = tripwires_post_handler,
+        .user_ctx = NULL
+    };
+    httpd_register_uri_handler(server, &tripwires_post_uri);
+    
+    httpd_uri_t presence_get_uri = {
+        .uri = "/presence",
+        .method = HTTP_GET,
+        .handler = presence_get_handler,
+        .user_ctx = NULL
+    };
+    httpd_register_uri_handler(server, &presence_get_uri);
+    
+    httpd_uri_t presence_post_uri = {
+        .uri = "/presence",
+        .method = HTTP_POST,
+        .handler = presence_post_handler,
+        .user_ctx = NULL
+    };
+    httpd_register_uri_handler(server, &presence_post_uri);
+    
+    httpd_uri_t tasks_uri = {
+        .uri = "/tasks",
+        .method = HTTP_GET,
+        .handler = tasks_get_handler,
+        .user_ctx = NULL
+    };
+    httpd_register_uri_handler(server, &tasks_uri);
+    
+    httpd_uri_t state_uri = {
+        .uri = "/state",
+        .method = HTTP_GET,
+        .handler = state_get_handler,
+        .user_ctx = NULL
+    };
+    httpd_register_uri_handler(server, &state_uri);
+    
     ESP_LOGI(TAG, "✅ Web server started with SSE streaming and config API");
     return ESP_OK;
 }
@@ -253,10 +1070,6 @@ void web_server_deinit(void) {
         vSemaphoreDelete(message_mutex);
         message_mutex = NULL;
     }
-    if (zone_mutex) {
-        vSemaphoreDelete(zone_mutex);
-        zone_mutex = NULL;
-    }
     if (cmd_queue) {
         vQueueDelete(cmd_queue);
         cmd_queue = NULL;
@@ -269,47 +1082,93 @@ bool web_server_is_running(void) {
 }
 
 // Helper to queue message for SSE broadcast
+// Messages that do not fit a slot are dropped - truncated JSON would only
+// break the client's parser
 static void queue_message(const char *json) {
     if (!message_mutex || !json) return;
     
+    size_t json_len = strlen(json);
+    if (json_len + 8 > WEB_SSE_MSG_SIZE) {  // "data: " + "\n\n"
+        ESP_LOGW(TAG, "SSE message too large (%d bytes), dropped", json_len);
+        return;
+    }
+    
     if (xSemaphoreTake(message_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        strncpy(message_buffer, json, sizeof(message_buffer) - 1);
-        message_buffer[sizeof(message_buffer) - 1] = '\0';
+        sse_slot_t *slot = &sse_ring[(sse_seq + 1) % WEB_SSE_RING_SLOTS];
+        memcpy(slot->data, "data: ", 6);
+        memcpy(&slot->data[6], json, json_len);
+        memcpy(&slot->data[6 + json_len], "\n\n", 2);
+        slot->len = json_len + 8;
+        sse_seq++;
         xSemaphoreGive(message_mutex);
     }
 }
 
+// Coordinate split for printing as meters with millimetre precision
+typedef struct {
+    const char *sign;
+    unsigned long whole;
+    unsigned long frac;
+} meters_t;
+
+static meters_t to_meters(hlk_coord_t coord) {
+    int32_t mm = HLK_COORD_TO_MM(coord);
+    if (mm > WEB_SSE_COORD_MAX_MM) mm = WEB_SSE_COORD_MAX_MM;        // Keeps a target within WEB_SSE_TARGET_JSON_MAX
+    if (mm < -WEB_SSE_COORD_MAX_MM) mm = -WEB_SSE_COORD_MAX_MM;
+    uint32_t mag = mm < 0 ? 0u - (uint32_t)mm : (uint32_t)mm;
+    meters_t m = { mm < 0 ? "-" : "", mag / 1000, mag % 1000 };
+    return m;
+}
+
 void web_server_send_targets(const hlk_target_t* targets, int32_t target_count) {
     if (!server || client_count == 0) return;
     
-    cJSON *root = cJSON_CreateObject();
-    cJSON_AddStringToObject(root, "type", "target");
-    
-    cJSON *data = cJSON_CreateArray();
-    for (int i = 0; i < target_count; i++) {
-        cJSON *target = cJSON_CreateObject();
-        cJSON_AddNumberToObject(target, "x", targets[i].x);
-        cJSON_AddNumberToObject(target, "y", targets[i].y);
-        cJSON_AddNumberToObject(target, "z", targets[i].z);
-        cJSON_AddNumberToObject(target, "v", targets[i].velocity);
-        cJSON_AddNumberToObject(target, "c", targets[i].cluster_id);
-        cJSON_AddItemToArray(data, target);
+    // Hand-formatted like the point cloud: a full report is HLK_MAX_TARGETS
+    // objects, and integer formatting avoids soft-float printf
+    int pos = snprintf(frame_json, sizeof(frame_json), "{\"type\":\"target\",\"data\":[");
+    for (int32_t i = 0; i < target_count && pos < (int)sizeof(frame_json); i++) {
+        meters_t x = to_meters(targets[i].x);
+        meters_t y = to_meters(targets[i].y);
+        meters_t z = to_meters(targets[i].z);
+        meters_t s = to_meters(targets[i].speed);
+        pos += snprintf(&frame_json[pos], sizeof(frame_json) - pos,
+                        "%s{\"x\":%s%lu.%03lu,\"y\":%s%lu.%03lu,\"z\":%s%lu.%03lu,\"v\":%ld,\"s\":%s%lu.%03lu,"
+                        "\"c\":%ld,\"id\":%u}",
+                        i ? "," : "", x.sign, x.whole, x.frac, y.sign, y.whole, y.frac,
+                        z.sign, z.whole, z.frac, (long)targets[i].velocity, s.sign, s.whole, s.frac,
+                        (long)targets[i].cluster_id, (unsigned)targets[i].track_id);
     }
-    cJSON_AddItemToObject(root, "data", data);
-    
-    char *json = cJSON_PrintUnformatted(root);
-    if (json) {
-        queue_message(json);
-        free(json);
+    if (pos < (int)sizeof(frame_json)) {
+        pos += snprintf(&frame_json[pos], sizeof(frame_json) - pos, "]}");
     }
-    cJSON_Delete(root);
+    if (pos >= (int)sizeof(frame_json)) {
+        ESP_LOGW(TAG, "Target JSON too large (%ld targets), dropped", target_count);
+        return;
+    }
+    
+    queue_message(frame_json);
 }
 
-void web_server_send_point_cloud(int32_t point_count, const float* points, int max_points) {
-    // Point cloud support (optional - can be enabled later)
-    (void)point_count;
-    (void)points;
-    (void)max_points;
+void web_server_send_point_cloud(const cloud_voxel_cloud_t* cloud) {
+    if (!server || client_count == 0 || !cloud) return;
+    
+    // Hand-formatted: up to HLK_MAX_CLOUD_POINTS tuples would mean hundreds of
+    // cJSON allocations per frame, and the values are already integers
+    int pos = snprintf(cloud_json, sizeof(cloud_json), "{\"type\":\"cloud\",\"data\":[");
+    for (int32_t i = 0; i < cloud->count && pos < (int)sizeof(cloud_json); i++) {
+        pos += snprintf(&cloud_json[pos], sizeof(cloud_json) - pos, "%s[%d,%d,%d,%d,%d,%d]",
+                        i ? "," : "", cloud->cluster[i], cloud->x[i], cloud->y[i], cloud->z[i],
+                        cloud->speed[i], cloud->weight[i]);
+    }
+    if (pos < (int)sizeof(cloud_json)) {
+        pos += snprintf(&cloud_json[pos], sizeof(cloud_json) - pos, "]}");
+    }
+    if (pos >= (int)sizeof(cloud_json)) {
+        ESP_LOGW(TAG, "Point cloud JSON too large (%ld points), dropped", cloud->count);
+        return;
+    }
+    
+    queue_message(cloud_json);
 }
 
 void web_server_send_presence(uint32_t zone0, uint32_t zone1, 
@@ -334,6 +1193,35 @@ void web_server_send_presence(uint32_t zone0, uint32_t zone1,
     cJSON_Delete(root);
 }
 
+void web_server_send_zone_counts(const uint16_t* counts, int zone_count) {
+    if (!server || client_count == 0 || !counts) return;
+    
+    int pos = snprintf(frame_json, sizeof(frame_json), "{\"type\":\"zone_counts\",\"data\":[");
+    for (int i = 0; i < zone_count && pos < (int)sizeof(frame_json); i++) {
+        pos += snprintf(&frame_json[pos], sizeof(frame_json) - pos, "%s%u", i ? "," : "", counts[i]);
+    }
+    if (pos < (int)sizeof(frame_json)) {
+        pos += snprintf(&frame_json[pos], sizeof(frame_json) - pos, "]}");
+    }
+    if (pos >= (int)sizeof(frame_json)) return;
+    
+    queue_message(frame_json);
+}
+
+void web_server_send_tripwire(const tripwire_event_t* event) {
+    if (!server || client_count == 0 || !event) return;
+    
+    char json[160];
+    int pos = snprintf(json, sizeof(json), "{\"type\":\"tripwire\",\"line\":%u,\"name\":\"", event->line);
+    pos += json_copy_name(&json[pos], TRIPWIRE_NAME_LEN, event->name);
+    snprintf(&json[pos], sizeof(json) - pos,
+             "\",\"dir\":\"%s\",\"id\":%u,\"in\":%lu,\"out\":%lu}",
+             event->in ? "in" : "out", event->track_id,
+             (unsigned long)event->in_count, (unsigned long)event->out_count);
+    
+    queue_message(json);
+}
+
 void web_server_send_config(uint8_t sensitivity, uint8_t trigger_speed, 
                             uint8_t install_method) {
     if (!server || client_count == 0) return;
@@ -358,16 +1246,6 @@ void web_server_send_config(uint8_t sensitivity, uint8_t trigger_speed,
 void web_server_send_zones(const zone_bounds_t* zones, bool is_interference) {
     if (!server || client_count == 0 || !zones) return;
     
-    // Store zones
-    if (zone_mutex && xSemaphoreTake(zone_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        if (is_interference) {
-            memcpy(interference_zones, zones, sizeof(zone_bounds_t) * 4);
-        } else {
-            memcpy(detection_zones, zones, sizeof(zone_bounds_t) * 4);
-        }
-        xSemaphoreGive(zone_mutex);
-    }
-    
     cJSON *root = cJSON_CreateObject();
     cJSON_AddStringToObject(root, "type", is_interference ? "interference_zones" : "detection_zones");
     
@@ -10,11 +10,20 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "hlk_ld6002.h"  // For hlk_target_t
+#include "cloud_voxel.h"  // For cloud_voxel_cloud_t
+#include "tripwire.h"  // For tripwire_event_t
 
 // Server configuration
 #define WEB_SERVER_PORT 80
 #define WEB_SERVER_MAX_CONNECTIONS 4
-#define MAX_TARGETS 10  // Maximum targets to track simultaneously
+#define MAX_TARGETS HLK_MAX_TARGETS  // Maximum targets per SSE update
+
+// SSE broadcast configuration
+#define WEB_SSE_RING_SLOTS 4    // Messages buffered for clients that poll between bursts
+#define WEB_SSE_COORD_MAX_MM 99999   // Target coordinates and speeds are clamped to +/-99.999 in the JSON
+#define WEB_SSE_TARGET_JSON_MAX 93   // Longest target: ,{"x":-99.999,"y":-99.999,"z":-99.999,"v":INT32_MIN,"s":-99.999,"c":INT32_MIN,"id":65535}
+#define WEB_SSE_CLOUD_JSON_MAX 41    // Longest cloud tuple: ,[-32768,-32768,-32768,-32768,-32768,255]
+#define WEB_SSE_MSG_SIZE (HLK_MAX_TARGETS * WEB_SSE_TARGET_JSON_MAX + 64)  // Max SSE event size ("data: " + JSON + "\n\n")
 
 // Command queue configuration
 #define CMD_QUEUE_SIZE 10
@@ -26,7 +35,11 @@ typedef enum {
     RADAR_CMD_CLEAR_INTERFERENCE_ZONE,
     RADAR_CMD_RESET_DETECTION_ZONE,
     RADAR_CMD_AUTO_GEN_INTERFERENCE_ZONE,
-    RADAR_CMD_GET_ZONES
+    RADAR_CMD_GET_ZONES,
+    RADAR_CMD_SET_POINT_CLOUD,
+    RADAR_CMD_SET_VOXEL_SIZE,
+    RADAR_CMD_SET_CLUSTERING,
+    RADAR_CMD_SET_TRACKING
 } radar_cmd_type_t;
 
 // Command structure
@@ -71,11 +84,10 @@ void web_server_send_targets(const hlk_target_t* targets, int32_t target_count);
 
 /**
  * Broadcast point cloud data to all connected SSE clients
- * @param point_count Number of points
- * @param points Array of point data (x, y, z, speed, cluster)
- * @param max_points Maximum number of points to send
+ * Sent as integer [cluster, x, y, z, speed, weight] tuples in mm and mm/s
+ * @param cloud Voxel-reduced point cloud
  */
-void web_server_send_point_cloud(int32_t point_count, const float* points, int max_points);
+void web_server_send_point_cloud(const cloud_voxel_cloud_t* cloud);
 
 /**
  * Broadcast presence status to all connected SSE clients
@@ -87,6 +99,19 @@ void web_server_send_point_cloud(int32_t point_count, const float* points, int m
 void web_server_send_presence(uint32_t zone0, uint32_t zone1,
                               uint32_t zone2, uint32_t zone3);
 
+/**
+ * Broadcast per-zone person counts of the polygon zone engine
+ * @param counts Count per zone, in definition order
+ * @param zone_count Number of zones
+ */
+void web_server_send_zone_counts(const uint16_t* counts, int zone_count);
+
+/**
+ * Broadcast one tripwire crossing with the line's updated in/out totals
+ * @param event Crossing reported by tripwire_update()
+ */
+void web_server_send_tripwire(const tripwire_event_t* event);
+
 /**
  * Broadcast sensor configuration to all connected SSE clients
  * @param sensitivity Detection sensitivity (0=Low, 1=Medium, 2=High)
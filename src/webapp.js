@@ -1,7 +1,8 @@
 // ========== CONFIGURATION ==========
-const MAX_TARGET_HISTORY = 20;  // Maximum number of targets to track
+const MAX_TARGET_HISTORY = 64;  // Maximum number of targets to track (firmware sends at most 56)
 const MAX_TRAIL_LENGTH = 100;   // Maximum history steps per target
 const TARGET_MATCH_DISTANCE = 0.5;  // Distance threshold for matching targets (meters)
+const MAX_CLOUD_POINTS = 64;     // Point cloud buffer size (firmware sends at most 56)
 
 // ========== GLOBAL VARIABLES ==========
 let scene, camera, renderer, grid, zones = [];
@@ -11,8 +12,13 @@ let gridVisible = true, zonesVisible = true;
 let deviceArrow, sceneRoot;
 let targetHistory = {}, trailLines = [], targetLines = [], maxTrailLength = 50;
 let targetHistoryOrder = [];
+let seededTrails = {};  // Device-side trails (GET /trajectories) by track ID, used when the track first appears
 let nextTargetId = 1;  // Incremental ID for new targets
 
+// Point cloud visualization
+let cloudPoints = null, cloudVisible = false;
+let clusteringEnabled = false;  // Targets from on-device point clustering
+
 // Zone visualization
 let detectionZoneMeshes = [];
 let interferenceZoneMeshes = [];
@@ -177,6 +183,8 @@ function init() {
         camera.position.addScaledVector(dir, e.deltaY > 0 ? 0.1 : -0.1);
     });
 
+    initPointCloud();
+
     connectSSE();
     animate();
 }
@@ -189,6 +197,7 @@ function connectSSE() {
         document.getElementById('status').textContent = 'Connected';
         document.getElementById('status').className = 'value connected';
         console.log('SSE connected');
+        loadTrajectories();
     };
 
     es.onerror = () => {
@@ -214,6 +223,8 @@ function connectSSE() {
                 updateInterferenceZones(msg.data);
             } else if (msg.type === 'config') {
                 updateConfigUI(msg.data);
+            } else if (msg.type === 'cloud') {
+                updatePointCloud(msg.data);
             }
         } catch (err) {
             console.error('Parse error:', err);
@@ -221,6 +232,20 @@ function connectSSE() {
     };
 }
 
+// Fetch recent trails kept by the device so tracks reappear with their history
+function loadTrajectories() {
+    fetch('/trajectories')
+        .then(r => r.json())
+        .then(data => {
+            seededTrails = {};
+            data.tracks.forEach(track => {
+                // Points are [age_ms, x, y, z] in mm, oldest first
+                seededTrails[track.id] = track.points.map(p => ({ x: p[1] / 1000, y: p[2] / 1000, z: p[3] / 1000 }));
+            });
+        })
+        .catch(err => console.warn('Trajectory fetch failed:', err));
+}
+
 // ========== TARGET UPDATES ==========
 function updateTargets(data) {
     // Clear cards and rebuild targets array
@@ -249,17 +274,22 @@ function updateTargets(data) {
         let closestId = null;
         let closestDist = Infinity;
 
-        Object.keys(targetHistory).forEach(id => {
-            if (matched.has(id)) return;  // Already matched this frame
-            
-            const hist = targetHistory[id];
-            const dist = distance3D(t, hist.lastPos);
-            
-            if (dist < closestDist && dist < TARGET_MATCH_DISTANCE) {
-                closestDist = dist;
-                closestId = id;
-            }
-        });
+        if (t.id) {
+            // Tracked on the device - the track ID is the identity
+            closestId = targetHistory[t.id] ? t.id : null;
+        } else {
+            Object.keys(targetHistory).forEach(id => {
+                if (matched.has(id)) return;  // Already matched this frame
+                
+                const hist = targetHistory[id];
+                const dist = distance3D(t, hist.lastPos);
+                
+                if (dist < closestDist && dist < TARGET_MATCH_DISTANCE) {
+                    closestDist = dist;
+                    closestId = id;
+                }
+            });
+        }
 
         let targetId;
         if (closestId !== null) {
@@ -268,7 +298,7 @@ function updateTargets(data) {
             matched.add(targetId);
         } else {
             // No match - create new target
-            targetId = nextTargetId++;
+            targetId = t.id || nextTargetId++;
             
             // Check if we need to remove old targets
             if (Object.keys(targetHistory).length >= MAX_TARGET_HISTORY) {
@@ -277,15 +307,16 @@ function updateTargets(data) {
 
             const col = getTargetColor(targetId);
             targetHistory[targetId] = {
-                positions: [],
+                positions: (seededTrails[targetId] || []).slice(-Math.min(maxTrailLength, MAX_TRAIL_LENGTH)),
                 lastSeen: Date.now(),
                 sphere: null,
                 lastPos: { x: t.x, y: t.y, z: t.z },
                 color: col,
-                velocity: t.v,
+                moving: t.v !== 0 || t.s !== 0,
                 clusterId: t.c
             };
             targetHistoryOrder.push(targetId);
+            delete seededTrails[targetId];
 
             const mat = new THREE.MeshStandardMaterial({
                 color: col,
@@ -294,7 +325,7 @@ function updateTargets(data) {
             });
             const sph = new THREE.Mesh(new THREE.SphereGeometry(0.05, 16, 16), mat);
             sph.position.set(t.x, t.z, t.y);
-            sph.userData = { x: t.x, y: t.y, z: t.z, v: t.v, c: t.c, id: targetId };
+            sph.userData = { x: t.x, y: t.y, z: t.z, v: t.v, s: t.s, c: t.c, id: targetId };
             sceneRoot.add(sph);
             targetHistory[targetId].sphere = sph;
             
@@ -303,9 +334,9 @@ function updateTargets(data) {
 
         // Update target data
         targetHistory[targetId].sphere.position.set(t.x, t.z, t.y);
-        targetHistory[targetId].sphere.userData = { x: t.x, y: t.y, z: t.z, v: t.v, c: t.c, id: targetId };
+        targetHistory[targetId].sphere.userData = { x: t.x, y: t.y, z: t.z, v: t.v, s: t.s, c: t.c, id: targetId };
         targetHistory[targetId].lastPos = { x: t.x, y: t.y, z: t.z };
-        targetHistory[targetId].velocity = t.v;
+        targetHistory[targetId].moving = t.v !== 0 || t.s !== 0;
         targetHistory[targetId].clusterId = t.c;
 
         // Add position to history
@@ -362,7 +393,7 @@ function updateTargets(data) {
 
             const card = document.createElement('div');
             card.className = 'target-card' +
-                (active && hist.velocity !== 0 ? ' moving' : '') +
+                (active && hist.moving ? ' moving' : '') +
                 (!active ? ' inactive' : '');
             card.dataset.targetId = id;
             
@@ -370,8 +401,8 @@ function updateTargets(data) {
             card.style.borderColor = hexColor;
             card.style.color = hexColor;
 
-            const statusClass = active && hist.velocity !== 0 ? 'moving' : 'still';
-            const statusText = active && hist.velocity !== 0 ? '🏃 Moving' : '🧍 Still';
+            const statusClass = active && hist.moving ? 'moving' : 'still';
+            const statusText = active && hist.moving ? '🏃 Moving' : '🧍 Still';
 
             card.innerHTML = `
                 <div class="target-name">Target ${id}${active ? '' : ' (lost)'}</div>
@@ -449,6 +480,67 @@ function updatePresence(data) {
     });
 }
 
+// ========== POINT CLOUD ==========
+function initPointCloud() {
+    const geo = new THREE.BufferGeometry();
+    geo.setAttribute('position', new THREE.BufferAttribute(new Float32Array(MAX_CLOUD_POINTS * 3), 3));
+    geo.setAttribute('color', new THREE.BufferAttribute(new Float32Array(MAX_CLOUD_POINTS * 3), 3));
+    geo.setDrawRange(0, 0);
+
+    const mat = new THREE.PointsMaterial({ size: 0.04, vertexColors: true });
+    cloudPoints = new THREE.Points(geo, mat);
+    cloudPoints.visible = cloudVisible;
+    sceneRoot.add(cloudPoints);
+}
+
+// data: [[cluster, x, y, z, speed, weight], ...] in mm and mm/s, one entry per voxel
+function updatePointCloud(data) {
+    if (!cloudPoints) return;
+
+    const pos = cloudPoints.geometry.attributes.position;
+    const col = cloudPoints.geometry.attributes.color;
+    const color = new THREE.Color();
+    const n = Math.min(data.length, MAX_CLOUD_POINTS);
+
+    for (let i = 0; i < n; i++) {
+        const [c, x, y, z] = data[i];
+        pos.setXYZ(i, x / 1000, z / 1000, y / 1000);
+        color.setHex(getTargetColor(c));
+        col.setXYZ(i, color.r, color.g, color.b);
+    }
+    pos.needsUpdate = true;
+    col.needsUpdate = true;
+    cloudPoints.geometry.setDrawRange(0, n);
+    document.getElementById('cloud-count').textContent = n;
+}
+
+function setVoxelSize(value) {
+    sendConfigCommand('voxel_size', parseInt(value));
+}
+
+async function togglePointCloud() {
+    const enable = !cloudVisible;
+    if (!await sendConfigCommand('point_cloud', enable ? 'on' : 'off')) return;
+
+    cloudVisible = enable;
+    cloudPoints.visible = cloudVisible;
+    if (!cloudVisible) {
+        cloudPoints.geometry.setDrawRange(0, 0);
+        document.getElementById('cloud-count').textContent = 0;
+    }
+    document.getElementById('cloud-btn').textContent =
+        cloudVisible ? 'Hide Point Cloud' : 'Show Point Cloud';
+}
+
+async function toggleClustering() {
+    const enable = !clusteringEnabled;
+    if (!await sendConfigCommand('clustering', enable ? 'on' : 'off')) return;
+
+    clusteringEnabled = enable;
+    document.getElementById('cluster-btn').textContent =
+        clusteringEnabled ? 'Use Sensor Targets' : 'Use Clustered Targets';
+}
+
 // ========== ANIMATION LOOP ==========
 function animate() {
     requestAnimationFrame(animate);
@@ -500,7 +592,7 @@ function showFeedback(message, type = 'success') {
 
 async function sendConfigCommand(cmd, value = null) {
     try {
-        const payload = value ? { cmd, value } : { cmd };
+        const payload = value !== null ? { cmd, value } : { cmd };
         const response = await fetch('/config', {
             method: 'POST',
             headers: { 'Content-Type': 'application/json' },
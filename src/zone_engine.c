@@ -0,0 +1,327 @@
+// Zone Engine Implementation
+//
+// Zones are indexed on a uniform grid covering the sensor's range. For every
+// cell the index keeps two bitmasks over the zones: "full" (the cell lies
+// entirely inside the zone, so no geometry is needed) and "partial" (a zone
+// edge passes through the cell, so an exact point-in-polygon test decides).
+// A target therefore costs one cell lookup plus a handful of exact tests for
+// the zones whose boundary is nearby, independent of the total zone count.
+// Targets outside the grid fall back to the zones that extend beyond it.
+// All geometry is integer millimetres; vertices are limited to
+// ±ZONE_ENGINE_COORD_LIMIT_MM so the crossing test fits in 32-bit products.
+
+#include "zone_engine.h"
+#include "hlk_port.h"
+#include "esp_log.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "ZoneEngine";
+
+#define ZONE_CELLS (ZONE_ENGINE_GRID_W * ZONE_ENGINE_GRID_H)
+
+typedef struct {
+    int16_t min_x, max_x, min_y, max_y;
+} zone_bbox_t;
+
+typedef struct {
+    uint32_t full[ZONE_CELLS][ZONE_ENGINE_MASK_WORDS];     // Cell entirely inside the zone
+    uint32_t partial[ZONE_CELLS][ZONE_ENGINE_MASK_WORDS];  // Zone boundary crosses the cell
+    uint32_t outside[ZONE_ENGINE_MASK_WORDS];              // Zone reaches beyond the grid
+    zone_bbox_t bbox[ZONE_ENGINE_MAX_ZONES];
+} zone_index_t;
+
+// ========== GLOBAL STATE ==========
+
+static zone_engine_zone_t g_zones[ZONE_ENGINE_MAX_ZONES];
+static zone_index_t g_index;
+static int g_zone_count = 0;
+static uint16_t g_counts[ZONE_ENGINE_MAX_ZONES];
+static uint16_t g_next_counts[ZONE_ENGINE_MAX_ZONES];
+static hlk_port_mutex_t g_mutex = NULL;
+static zone_engine_stats_t g_stats = {0};
+
+// ========== GEOMETRY ==========
+
+// Crossing-number test; vertices and point are within ±ZONE_ENGINE_COORD_LIMIT_MM
+static bool polygon_contains(const zone_engine_zone_t* zone, int32_t px, int32_t py) {
+    bool inside = false;
+    for (int i = 0, j = zone->vertex_count - 1; i < zone->vertex_count; j = i++) {
+        int32_t xi = zone->x_mm[i], yi = zone->y_mm[i];
+        int32_t xj = zone->x_mm[j], yj = zone->y_mm[j];
+        if ((yi > py) != (yj > py)) {
+            // px < xi + (xj - xi) * (py - yi) / (yj - yi), without the division
+            int32_t lhs = (px - xi) * (yj - yi);
+            int32_t rhs = (xj - xi) * (py - yi);
+            if (yj > yi ? lhs < rhs : lhs > rhs) inside = !inside;
+        }
+    }
+    return inside;
+}
+
+static bool height_matches(const zone_engine_zone_t* zone, int32_t pz) {
+    return !zone->prism || (pz >= zone->z_min_mm && pz <= zone->z_max_mm);
+}
+
+// Segment vs closed rectangle (separating axes: X, Y and the segment normal)
+static bool segment_hits_rect(int32_t ax, int32_t ay, int32_t bx, int32_t by,
+                              int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    if ((ax > bx ? ax : bx) < x0 || (ax < bx ? ax : bx) > x1 ||
+        (ay > by ? ay : by) < y0 || (ay < by ? ay : by) > y1) {
+        return false;
+    }
+
+    const int32_t cx[4] = { x0, x1, x1, x0 };
+    const int32_t cy[4] = { y0, y0, y1, y1 };
+    int above = 0, below = 0;
+    for (int i = 0; i < 4; i++) {
+        int64_t side = (int64_t)(bx - ax) * (cy[i] - ay) - (int64_t)(by - ay) * (cx[i] - ax);
+        if (side > 0) above++;
+        else if (side < 0) below++;
+        else return true;
+    }
+    return above != 4 && below != 4;
+}
+
+// Grid column/row of a coordinate, -1 below the grid, n at or beyond its end
+static int cell_of(int32_t mm, int32_t origin, int n) {
+    int32_t d = mm - origin;
+    if (d < 0) return -1;
+    d /= ZONE_ENGINE_CELL_MM;
+    return d < n ? (int)d : n;
+}
+
+static int clamp_cell(int c, int n) {
+    return c < 0 ? 0 : (c >= n ? n - 1 : c);
+}
+
+// ========== INDEX BUILD ==========
+
+static bool zone_valid(const zone_engine_zone_t* zone) {
+    if (zone->vertex_count < 3 || zone->vertex_count > ZONE_ENGINE_MAX_VERTICES) return false;
+    for (int i = 0; i < zone->vertex_count; i++) {
+        if (abs(zone->x_mm[i]) > ZONE_ENGINE_COORD_LIMIT_MM ||
+            abs(zone->y_mm[i]) > ZONE_ENGINE_COORD_LIMIT_MM) {
+            return false;
+        }
+    }
+    if (zone->prism && (zone->z_min_mm > zone->z_max_mm ||
+                        abs(zone->z_min_mm) > ZONE_ENGINE_COORD_LIMIT_MM ||
+                        abs(zone->z_max_mm) > ZONE_ENGINE_COORD_LIMIT_MM)) {
+        return false;
+    }
+    return true;
+}
+
+static void index_zone(zone_index_t* index, const zone_engine_zone_t* zone, int z) {
+    const uint32_t bit = 1u << (z % 32);
+    const int word = z / 32;
+    zone_bbox_t* box = &index->bbox[z];
+
+    box->min_x = box->max_x = zone->x_mm[0];
+    box->min_y = box->max_y = zone->y_mm[0];
+    for (int i = 1; i < zone->vertex_count; i++) {
+        if (zone->x_mm[i] < box->min_x) box->min_x = zone->x_mm[i];
+        if (zone->x_mm[i] > box->max_x) box->max_x = zone->x_mm[i];
+        if (zone->y_mm[i] < box->min_y) box->min_y = zone->y_mm[i];
+        if (zone->y_mm[i] > box->max_y) box->max_y = zone->y_mm[i];
+    }
+
+    int c0 = cell_of(box->min_x, ZONE_ENGINE_ORIGIN_X_MM, ZONE_ENGINE_GRID_W);
+    int c1 = cell_of(box->max_x, ZONE_ENGINE_ORIGIN_X_MM, ZONE_ENGINE_GRID_W);
+    int r0 = cell_of(box->min_y, ZONE_ENGINE_ORIGIN_Y_MM, ZONE_ENGINE_GRID_H);
+    int r1 = cell_of(box->max_y, ZONE_ENGINE_ORIGIN_Y_MM, ZONE_ENGINE_GRID_H);
+    if (c0 < 0 || r0 < 0 || c1 >= ZONE_ENGINE_GRID_W || r1 >= ZONE_ENGINE_GRID_H) {
+        index->outside[word] |= bit;
+    }
+    if (c1 < 0 || r1 < 0 || c0 >= ZONE_ENGINE_GRID_W || r0 >= ZONE_ENGINE_GRID_H) {
+        return;  // Entirely outside the grid
+    }
+    c0 = clamp_cell(c0, ZONE_ENGINE_GRID_W);
+    c1 = clamp_cell(c1, ZONE_ENGINE_GRID_W);
+    r0 = clamp_cell(r0, ZONE_ENGINE_GRID_H);
+    r1 = clamp_cell(r1, ZONE_ENGINE_GRID_H);
+
+    // Boundary cells: every cell an edge touches needs the exact test
+    for (int i = 0, j = zone->vertex_count - 1; i < zone->vertex_count; j = i++) {
+        int32_t ax = zone->x_mm[j], ay = zone->y_mm[j];
+        int32_t bx = zone->x_mm[i], by = zone->y_mm[i];
+        int ec0 = clamp_cell(cell_of(ax < bx ? ax : bx, ZONE_ENGINE_ORIGIN_X_MM, ZONE_ENGINE_GRID_W), ZONE_ENGINE_GRID_W);
+        int ec1 = clamp_cell(cell_of(ax > bx ? ax : bx, ZONE_ENGINE_ORIGIN_X_MM, ZONE_ENGINE_GRID_W), ZONE_ENGINE_GRID_W);
+        int er0 = clamp_cell(cell_of(ay < by ? ay : by, ZONE_ENGINE_ORIGIN_Y_MM, ZONE_ENGINE_GRID_H), ZONE_ENGINE_GRID_H);
+        int er1 = clamp_cell(cell_of(ay > by ? ay : by, ZONE_ENGINE_ORIGIN_Y_MM, ZONE_ENGINE_GRID_H), ZONE_ENGINE_GRID_H);
+        for (int r = er0; r <= er1; r++) {
+            for (int c = ec0; c <= ec1; c++) {
+                int32_t x0 = ZONE_ENGINE_ORIGIN_X_MM + c * ZONE_ENGINE_CELL_MM;
+                int32_t y0 = ZONE_ENGINE_ORIGIN_Y_MM + r * ZONE_ENGINE_CELL_MM;
+                if (segment_hits_rect(ax, ay, bx, by, x0, y0,
+                                      x0 + ZONE_ENGINE_CELL_MM, y0 + ZONE_ENGINE_CELL_MM)) {
+                    index->partial[r * ZONE_ENGINE_GRID_W + c][word] |= bit;
+                }
+            }
+        }
+    }
+
+    // Cells no edge touches are wholly inside or wholly outside: the centre decides
+    for (int r = r0; r <= r1; r++) {
+        for (int c = c0; c <= c1; c++) {
+            int cell = r * ZONE_ENGINE_GRID_W + c;
+            if (index->partial[cell][word] & bit) continue;
+            int32_t cx = ZONE_ENGINE_ORIGIN_X_MM + c * ZONE_ENGINE_CELL_MM + ZONE_ENGINE_CELL_MM / 2;
+            int32_t cy = ZONE_ENGINE_ORIGIN_Y_MM + r * ZONE_ENGINE_CELL_MM + ZONE_ENGINE_CELL_MM / 2;
+            if (polygon_contains(zone, cx, cy)) {
+                index->full[cell][word] |= bit;
+            }
+        }
+    }
+}
+
+// ========== API FUNCTIONS ==========
+
+void zone_engine_init(void) {
+    if (!g_mutex) {
+        g_mutex = hlk_port_mutex_create();
+    }
+    hlk_port_mutex_lock(g_mutex);
+    memset(&g_index, 0, sizeof(g_index));
+    memset(g_counts, 0, sizeof(g_counts));
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_zone_count = 0;
+    hlk_port_mutex_unlock(g_mutex);
+
+    ESP_LOGI(TAG, "✅ Zone engine: up to %d zones, %dx%d index of %d mm cells, %u bytes",
+             ZONE_ENGINE_MAX_ZONES, ZONE_ENGINE_GRID_W, ZONE_ENGINE_GRID_H, ZONE_ENGINE_CELL_MM,
+             (unsigned)(sizeof(g_zones) + sizeof(g_index) + sizeof(g_counts) + sizeof(g_next_counts)));
+}
+
+esp_err_t zone_engine_set_zones(const zone_engine_zone_t* zones, int count) {
+    if (count < 0 || count > ZONE_ENGINE_MAX_ZONES || (count > 0 && !zones)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < count; i++) {
+        if (!zone_valid(&zones[i])) {
+            ESP_LOGW(TAG, "Zone %d rejected: needs 3-%d vertices within ±%d mm", i,
+                     ZONE_ENGINE_MAX_VERTICES, ZONE_ENGINE_COORD_LIMIT_MM);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    // Build off to the side so evaluation only waits for the copy
+    zone_index_t* index = calloc(1, sizeof(zone_index_t));
+    if (!index) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (int i = 0; i < count; i++) {
+        index_zone(index, &zones[i], i);
+    }
+
+    hlk_port_mutex_lock(g_mutex);
+    memcpy(&g_index, index, sizeof(g_index));
+    if (count > 0) {
+        memcpy(g_zones, zones, count * sizeof(zone_engine_zone_t));
+    }
+    for (int i = 0; i < count; i++) {
+        g_zones[i].name[ZONE_ENGINE_NAME_LEN - 1] = '\0';
+    }
+    g_zone_count = count;
+    memset(g_counts, 0, sizeof(g_counts));
+    hlk_port_mutex_unlock(g_mutex);
+
+    free(index);
+    ESP_LOGI(TAG, "🗺️  %d zone%s defined", count, count == 1 ? "" : "s");
+    return ESP_OK;
+}
+
+int zone_engine_get_zones(zone_engine_zone_t* zones, int max) {
+    hlk_port_mutex_lock(g_mutex);
+    int count = g_zone_count;
+    if (zones && max > 0) {
+        memcpy(zones, g_zones, (count < max ? count : max) * sizeof(zone_engine_zone_t));
+    }
+    hlk_port_mutex_unlock(g_mutex);
+    return count;
+}
+
+bool zone_engine_evaluate(const hlk_target_t* targets, int32_t count) {
+    uint32_t start = hlk_port_micros();
+
+    hlk_port_mutex_lock(g_mutex);
+    int zone_count = g_zone_count;
+    if (zone_count == 0) {
+        hlk_port_mutex_unlock(g_mutex);
+        return false;
+    }
+    memset(g_next_counts, 0, zone_count * sizeof(uint16_t));
+
+    for (int32_t t = 0; t < count; t++) {
+        int32_t px = HLK_COORD_TO_MM(targets[t].x);
+        int32_t py = HLK_COORD_TO_MM(targets[t].y);
+        int32_t pz = HLK_COORD_TO_MM(targets[t].z);
+        int col = cell_of(px, ZONE_ENGINE_ORIGIN_X_MM, ZONE_ENGINE_GRID_W);
+        int row = cell_of(py, ZONE_ENGINE_ORIGIN_Y_MM, ZONE_ENGINE_GRID_H);
+
+        if (col >= 0 && row >= 0 && col < ZONE_ENGINE_GRID_W && row < ZONE_ENGINE_GRID_H) {
+            int cell = row * ZONE_ENGINE_GRID_W + col;
+            for (int w = 0; w < ZONE_ENGINE_MASK_WORDS; w++) {
+                for (uint32_t bits = g_index.full[cell][w]; bits; bits &= bits - 1) {
+                    int z = w * 32 + __builtin_ctz(bits);
+                    if (height_matches(&g_zones[z], pz)) {
+                        g_next_counts[z]++;
+                        g_stats.index_hits++;
+                    }
+                }
+                for (uint32_t bits = g_index.partial[cell][w]; bits; bits &= bits - 1) {
+                    int z = w * 32 + __builtin_ctz(bits);
+                    if (!height_matches(&g_zones[z], pz)) continue;
+                    g_stats.exact_tests++;
+                    if (polygon_contains(&g_zones[z], px, py)) g_next_counts[z]++;
+                }
+            }
+        } else {
+            // Beyond the index: only zones that reach past the grid can match
+            g_stats.outside_grid++;
+            for (int w = 0; w < ZONE_ENGINE_MASK_WORDS; w++) {
+                for (uint32_t bits = g_index.outside[w]; bits; bits &= bits - 1) {
+                    int z = w * 32 + __builtin_ctz(bits);
+                    const zone_bbox_t* box = &g_index.bbox[z];
+                    if (px < box->min_x || px > box->max_x || py < box->min_y || py > box->max_y) continue;
+                    if (!height_matches(&g_zones[z], pz)) continue;
+                    g_stats.exact_tests++;
+                    if (polygon_contains(&g_zones[z], px, py)) g_next_counts[z]++;
+                }
+            }
+        }
+    }
+
+    bool changed = memcmp(g_counts, g_next_counts, zone_count * sizeof(uint16_t)) != 0;
+    memcpy(g_counts, g_next_counts, zone_count * sizeof(uint16_t));
+
+    uint32_t elapsed = hlk_port_micros() - start;
+    g_stats.frames++;
+    g_stats.targets += count;
+    g_stats.last_us = elapsed;
+    g_stats.total_us += elapsed;
+    if (elapsed > g_stats.max_us) g_stats.max_us = elapsed;
+    hlk_port_mutex_unlock(g_mutex);
+
+    return changed;
+}
+
+int zone_engine_get_counts(uint16_t* counts, int max) {
+    hlk_port_mutex_lock(g_mutex);
+    int count = g_zone_count;
+    if (counts && max > 0) {
+        memcpy(counts, g_counts, (count < max ? count : max) * sizeof(uint16_t));
+    }
+    hlk_port_mutex_unlock(g_mutex);
+    return count;
+}
+
+void zone_engine_get_stats(zone_engine_stats_t* stats) {
+    if (!stats) return;
+
+    hlk_port_mutex_lock(g_mutex);
+    *stats = g_stats;
+    hlk_port_mutex_unlock(g_mutex);
+    stats->memory_bytes = sizeof(g_zones) + sizeof(g_index) + sizeof(g_counts) + sizeof(g_next_counts);
+}
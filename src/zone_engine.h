@@ -0,0 +1,125 @@
+// Zone Engine Module
+// User-defined 2D polygon and 3D prism zones evaluated on-device against every
+// target, with a uniform-grid bitmask index and per-zone person counts
+
+#ifndef ZONE_ENGINE_H
+#define ZONE_ENGINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "hlk_ld6002.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ========== CONFIGURATION ==========
+
+#ifndef ZONE_ENGINE_MAX_ZONES
+#define ZONE_ENGINE_MAX_ZONES 64        // Zone slots (index bitmask width)
+#endif
+
+#ifndef ZONE_ENGINE_MAX_VERTICES
+#define ZONE_ENGINE_MAX_VERTICES 16     // Polygon corners per zone
+#endif
+
+#ifndef ZONE_ENGINE_GRID_W
+#define ZONE_ENGINE_GRID_W 24           // Index cells along X
+#endif
+
+#ifndef ZONE_ENGINE_GRID_H
+#define ZONE_ENGINE_GRID_H 24           // Index cells along Y
+#endif
+
+#ifndef ZONE_ENGINE_CELL_MM
+#define ZONE_ENGINE_CELL_MM 250         // Index cell edge (24 x 250 mm covers the 3 m range both ways)
+#endif
+
+#define ZONE_ENGINE_ORIGIN_X_MM (-(ZONE_ENGINE_GRID_W * ZONE_ENGINE_CELL_MM) / 2)
+#define ZONE_ENGINE_ORIGIN_Y_MM (-(ZONE_ENGINE_GRID_H * ZONE_ENGINE_CELL_MM) / 2)
+#define ZONE_ENGINE_COORD_LIMIT_MM 16000  // Vertex and height range (keeps point-in-polygon math in 32 bits)
+#define ZONE_ENGINE_NAME_LEN 16         // Including terminator
+#define ZONE_ENGINE_MASK_WORDS ((ZONE_ENGINE_MAX_ZONES + 31) / 32)
+
+// ========== DATA STRUCTURES ==========
+
+// Zone definition - polygon corners in the sensor's X/Y plane, millimetres.
+// A prism additionally bounds Z; a plain polygon matches any height.
+typedef struct {
+    char name[ZONE_ENGINE_NAME_LEN];
+    uint8_t vertex_count;                  // 3 to ZONE_ENGINE_MAX_VERTICES
+    bool prism;                            // Apply z_min_mm..z_max_mm
+    int16_t z_min_mm;
+    int16_t z_max_mm;
+    int16_t x_mm[ZONE_ENGINE_MAX_VERTICES];
+    int16_t y_mm[ZONE_ENGINE_MAX_VERTICES];
+} zone_engine_zone_t;
+
+// Evaluation statistics
+typedef struct {
+    uint32_t frames;         // zone_engine_evaluate() calls
+    uint32_t targets;        // Targets evaluated
+    uint32_t index_hits;     // Zone matches decided by the index alone (cell fully inside)
+    uint32_t exact_tests;    // Point-in-polygon tests on boundary cells
+    uint32_t outside_grid;   // Targets outside the index, tested against every zone
+    uint32_t last_us;        // Runtime of the most recent frame
+    uint32_t max_us;         // Worst-case frame runtime
+    uint32_t total_us;       // Sum of frame runtimes (for the average)
+    uint32_t memory_bytes;   // Static storage for zones, index and counts
+} zone_engine_stats_t;
+
+// ========== API FUNCTIONS ==========
+
+/**
+ * Initialize engine (no zones)
+ */
+void zone_engine_init(void);
+
+/**
+ * Replace all zones and rebuild the index
+ *
+ * The index is built in a temporary heap buffer, and the frame evaluation is only
+ * blocked for the final copy. Per-zone counts restart at zero.
+ *
+ * @param zones Zone definitions
+ * @param count Number of zones (0 to ZONE_ENGINE_MAX_ZONES, 0 removes all)
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for a bad definition, ESP_ERR_NO_MEM
+ */
+esp_err_t zone_engine_set_zones(const zone_engine_zone_t* zones, int count);
+
+/**
+ * Copy the current zone definitions
+ * @param zones Output array
+ * @param max Capacity of the output array
+ * @return Number of zones defined (may exceed max)
+ */
+int zone_engine_get_zones(zone_engine_zone_t* zones, int max);
+
+/**
+ * Count the targets inside every zone
+ * @param targets Targets of one frame
+ * @param count Number of targets
+ * @return true if any zone's count changed
+ */
+bool zone_engine_evaluate(const hlk_target_t* targets, int32_t count);
+
+/**
+ * Copy the per-zone person counts of the last frame
+ * @param counts Output array, in zone order
+ * @param max Capacity of the output array
+ * @return Number of zones defined
+ */
+int zone_engine_get_counts(uint16_t* counts, int max);
+
+/**
+ * Get evaluation statistics
+ * @param stats Output statistics
+ */
+void zone_engine_get_stats(zone_engine_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ZONE_ENGINE_H
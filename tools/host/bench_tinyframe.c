@@ -0,0 +1,289 @@
+// TinyFrame parser throughput benchmark
+// Encodes a synthetic stream per frame mix and pushes it through the same
+// path the sensor task uses (host UART port -> hlk_ld6002_process_bulk).
+// Callbacks run the tracker's geometry kernels (distance, movement, zone
+// test) on every decoded coordinate, so building with HLK_FIXED_POINT=1
+// (bench_tinyframe_fixed) compares the integer path against float.
+//
+// Usage: bench_tinyframe [seconds_per_mix]
+
+#include "hlk_ld6002.h"
+#include "hlk_port_host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_STREAM_SIZE (1024 * 1024)  // Bytes of encoded frames per mix
+#define BENCH_TARGETS 3                  // Targets per 0x0A04 frame
+#define BENCH_CLOUD_POINTS 32            // Points per 0x0A08 frame
+#define BENCH_CLOUD_RECORD_SIZE 20       // cluster (int32), x, y, z, speed (float)
+
+typedef struct {
+    uint8_t *buf;
+    size_t len;
+    size_t cap;
+    uint32_t frames;
+    uint16_t next_id;
+} bench_stream_t;
+
+typedef enum {
+    MIX_TARGET,
+    MIX_PRESENCE,
+    MIX_ZONE,
+    MIX_POINT_CLOUD,
+    MIX_MIXED,
+    MIX_COUNT
+} bench_mix_t;
+
+static const char *MIX_NAMES[MIX_COUNT] = {
+    "target", "presence", "zone", "point-cloud", "mixed"
+};
+
+static volatile uint32_t g_sink;
+
+// Zone used for the per-coordinate containment test
+static const hlk_zone_t BENCH_ZONE = {
+    HLK_COORD_FROM_M(-1.0f), HLK_COORD_FROM_M(1.0f),
+    HLK_COORD_FROM_M(0.0f), HLK_COORD_FROM_M(3.0f),
+    HLK_COORD_FROM_M(0.0f), HLK_COORD_FROM_M(2.5f)
+};
+
+// ========== ENCODING ==========
+
+static void put_u32_le(uint8_t *p, uint32_t v) {
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = (v >> 24) & 0xFF;
+}
+
+static void put_f32_le(uint8_t *p, float f) {
+    uint32_t v;
+    memcpy(&v, &f, sizeof(v));
+    put_u32_le(p, v);
+}
+
+static uint8_t cksum(const uint8_t *p, size_t len) {
+    uint8_t c = 0;
+    for (size_t i = 0; i < len; i++) {
+        c ^= p[i];
+    }
+    return ~c;
+}
+
+// Append one TinyFrame; returns false when the stream is full
+static bool stream_add(bench_stream_t *s, uint16_t type, const uint8_t *data, uint16_t len) {
+    size_t frame_len = 8 + len + 1;
+    if (s->len + frame_len > s->cap) {
+        return false;
+    }
+    
+    uint8_t *f = &s->buf[s->len];
+    f[0] = 0x01;
+    f[1] = s->next_id >> 8;
+    f[2] = s->next_id & 0xFF;
+    f[3] = len >> 8;
+    f[4] = len & 0xFF;
+    f[5] = type >> 8;
+    f[6] = type & 0xFF;
+    f[7] = cksum(f, 7);
+    memcpy(&f[8], data, len);
+    f[8 + len] = cksum(data, len);
+    
+    s->next_id++;
+    s->len += frame_len;
+    s->frames++;
+    return true;
+}
+
+static bool add_target_frame(bench_stream_t *s) {
+    uint8_t data[4 + BENCH_TARGETS * HLK_TARGET_RECORD_SIZE];
+    put_u32_le(data, BENCH_TARGETS);
+    for (int i = 0; i < BENCH_TARGETS; i++) {
+        uint8_t *r = &data[4 + i * HLK_TARGET_RECORD_SIZE];
+        put_f32_le(&r[0], 0.5f * i - 0.5f);
+        put_f32_le(&r[4], 1.0f + 0.25f * i);
+        put_f32_le(&r[8], 1.2f);
+        put_u32_le(&r[12], (uint32_t)(i - 1));
+        put_u32_le(&r[16], (uint32_t)i);
+    }
+    return stream_add(s, MSG_IND_HUMAN_DETECTION_3D_TGT_RES, data, sizeof(data));
+}
+
+static bool add_presence_frame(bench_stream_t *s) {
+    uint8_t data[16];
+    put_u32_le(&data[0], 1);
+    put_u32_le(&data[4], 0);
+    put_u32_le(&data[8], 0);
+    put_u32_le(&data[12], 1);
+    return stream_add(s, MSG_IND_HUMAN_DETECTION_3D_RES, data, sizeof(data));
+}
+
+static bool add_zone_frame(bench_stream_t *s) {
+    uint8_t data[HLK_ZONE_COUNT * HLK_ZONE_RECORD_SIZE];
+    for (int i = 0; i < HLK_ZONE_COUNT * 6; i++) {
+        put_f32_le(&data[i * 4], (i & 1) ? 1.5f : -1.5f);
+    }
+    return stream_add(s, MSG_IND_HUMAN_DETECTION_3D_DETECTION_ZONES, data, sizeof(data));
+}
+
+static bool add_point_cloud_frame(bench_stream_t *s) {
+    uint8_t data[4 + BENCH_CLOUD_POINTS * BENCH_CLOUD_RECORD_SIZE];
+    put_u32_le(data, BENCH_CLOUD_POINTS);
+    for (int i = 0; i < BENCH_CLOUD_POINTS; i++) {
+        uint8_t *r = &data[4 + i * BENCH_CLOUD_RECORD_SIZE];
+        put_u32_le(&r[0], (uint32_t)(i / 8));
+        put_f32_le(&r[4], 0.01f * i);
+        put_f32_le(&r[8], 1.0f + 0.02f * i);
+        put_f32_le(&r[12], 0.8f);
+        put_f32_le(&r[16], -0.1f);
+    }
+    return stream_add(s, MSG_IND_3D_CLOUD_RES, data, sizeof(data));
+}
+
+// Fill the stream with one frame mix. The mixed profile approximates the
+// sensor's own output: cloud + targets + presence every cycle, zones rarely.
+static void build_stream(bench_stream_t *s, bench_mix_t mix) {
+    s->len = 0;
+    s->frames = 0;
+    
+    for (uint32_t cycle = 0; ; cycle++) {
+        bool ok;
+        switch (mix) {
+            case MIX_TARGET:      ok = add_target_frame(s); break;
+            case MIX_PRESENCE:    ok = add_presence_frame(s); break;
+            case MIX_ZONE:        ok = add_zone_frame(s); break;
+            case MIX_POINT_CLOUD: ok = add_point_cloud_frame(s); break;
+            default:
+                ok = add_point_cloud_frame(s) && add_target_frame(s) && add_presence_frame(s);
+                if (ok && cycle % 10 == 0) {
+                    ok = add_zone_frame(s);
+                }
+                break;
+        }
+        if (!ok) {
+            break;
+        }
+    }
+}
+
+// ========== CALLBACKS ==========
+
+// Same work per target as target_tracker_update(): distance, movement, zone test
+static void on_target(const hlk_target_t* targets, int32_t count) {
+    static hlk_coord_t last_x, last_y, last_z;
+    for (int32_t i = 0; i < count; i++) {
+        hlk_coord_t distance = hlk_calc_distance_3d(targets[i].x, targets[i].y, targets[i].z);
+        hlk_coord_t movement = hlk_calc_distance_3d(targets[i].x - last_x,
+                                                    targets[i].y - last_y,
+                                                    targets[i].z - last_z);
+        g_sink += (distance > movement) + hlk_zone_contains(&BENCH_ZONE, targets[i].x, targets[i].y, targets[i].z);
+        last_x = targets[i].x;
+        last_y = targets[i].y;
+        last_z = targets[i].z;
+    }
+}
+
+static void on_presence(uint32_t zone0, uint32_t zone1, uint32_t zone2, uint32_t zone3) {
+    g_sink += zone0 + zone1 + zone2 + zone3;
+}
+
+static void on_zones_view(const hlk_zone_view_t* view) {
+    for (int i = 0; i < HLK_ZONE_COUNT; i++) {
+        hlk_zone_t zone;
+        hlk_zone_view_get(view, i, &zone);
+        g_sink += hlk_zone_contains(&zone, 0, 0, 0);
+    }
+}
+
+static void on_point_cloud(const hlk_point_cloud_t* cloud) {
+    for (int32_t i = 0; i < cloud->count; i++) {
+        g_sink += (hlk_calc_distance_3d(cloud->x[i], cloud->y[i], cloud->z[i]) > cloud->speed[i]) +
+                  hlk_zone_contains(&BENCH_ZONE, cloud->x[i], cloud->y[i], cloud->z[i]);
+    }
+}
+
+static void on_config(uint16_t msg_type, const uint8_t* data, uint16_t len) {
+    g_sink += msg_type + len + (len > 0 ? data[0] : 0);
+}
+
+// ========== BENCHMARK ==========
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int run_mix(bench_stream_t *s, bench_mix_t mix, double seconds) {
+    build_stream(s, mix);
+    hlk_ld6002_reset();
+    
+    uint64_t bytes = 0;
+    uint64_t frames = 0;
+    uint32_t passes = 0;
+    double start = now_seconds();
+    double elapsed;
+    
+    do {
+        hlk_process_result_t result;
+        hlk_port_host_set_input(s->buf, s->len);
+        while (hlk_ld6002_process_bulk(0, &result) > 0) {
+            bytes += result.bytes;
+            frames += result.frames;
+        }
+        passes++;
+        elapsed = now_seconds() - start;
+    } while (elapsed < seconds);
+    
+    hlk_parser_stats_t stats;
+    hlk_ld6002_get_parser_stats(&stats);
+    
+    printf("%-12s %8.1f MB/s %10.0f frames/s %8.1f ns/frame %7.0f cycles/frame dispatch  (%u B/frame avg, %u passes)\n",
+           MIX_NAMES[mix], bytes / elapsed / 1e6, frames / elapsed,
+           elapsed * 1e9 / (double)frames, (double)stats.dispatch_cycles / (double)frames,
+           (unsigned)(s->len / s->frames), passes);
+    
+    // Every encoded frame must come out the other side
+    if (frames != (uint64_t)s->frames * passes || stats.rejected_frames != 0) {
+        fprintf(stderr, "%s: expected %llu frames, parsed %llu (%lu rejected)\n",
+                MIX_NAMES[mix], (unsigned long long)s->frames * passes,
+                (unsigned long long)frames, (unsigned long)stats.rejected_frames);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    double seconds = argc > 1 ? atof(argv[1]) : 0.5;
+    
+    static const hlk_callbacks_t callbacks = {
+        .on_presence = on_presence,
+        .on_config = on_config,
+        .on_target = on_target,
+        .on_zones_view = on_zones_view,
+        .on_point_cloud = on_point_cloud,
+    };
+    
+    bench_stream_t stream = {
+        .buf = malloc(BENCH_STREAM_SIZE),
+        .cap = BENCH_STREAM_SIZE,
+    };
+    if (!stream.buf) {
+        return 1;
+    }
+    
+    hlk_ld6002_init();
+    hlk_ld6002_register_callbacks(&callbacks);
+    
+    printf("Coordinates: %s\n", HLK_FIXED_POINT ? "fixed-point (int32 mm)" : "float (m)");
+    
+    int failures = 0;
+    for (int mix = 0; mix < MIX_COUNT; mix++) {
+        failures += run_mix(&stream, (bench_mix_t)mix, seconds);
+    }
+    
+    free(stream.buf);
+    return failures ? 1 : 0;
+}
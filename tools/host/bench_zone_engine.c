@@ -0,0 +1,180 @@
+// Zone engine benchmark
+// Defines N random polygon / prism zones (concave star shapes, 6-16 corners)
+// across the sensor's range and evaluates full target reports against them.
+// Every frame's per-zone counts are checked against a brute-force scan of all
+// zones, so the grid index is verified as well as timed.
+//
+// Built with ZONE_ENGINE_MAX_ZONES=128 so the 64- and 128-zone cases fit.
+//
+// Usage: bench_zone_engine [seconds_per_case]
+
+#include "zone_engine.h"
+#include "hlk_port.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_FRAME_PERIOD_MS 50   // Sensor report interval the cost is compared against
+#define BENCH_FRAME_POOL 256       // Pre-generated frames cycled through per case
+
+static const int ZONE_CASES[] = { 16, 64, 128 };
+static const int TARGET_CASES[] = { 3, HLK_MAX_TARGETS };
+
+static zone_engine_zone_t g_zones[ZONE_ENGINE_MAX_ZONES];
+static hlk_target_t g_frames[BENCH_FRAME_POOL][HLK_MAX_TARGETS];
+
+// ========== GENERATION ==========
+
+static int32_t rand_range(int32_t lo, int32_t hi) {
+    return lo + (int32_t)(rand() % (uint32_t)(hi - lo + 1));
+}
+
+static void make_zones(int count) {
+    for (int z = 0; z < count; z++) {
+        zone_engine_zone_t *zone = &g_zones[z];
+        memset(zone, 0, sizeof(*zone));
+        snprintf(zone->name, sizeof(zone->name), "zone%d", z);
+
+        int32_t cx = rand_range(-3200, 3200);
+        int32_t cy = rand_range(-3200, 3200);
+        int32_t radius = rand_range(200, 900);
+        zone->vertex_count = (uint8_t)rand_range(6, ZONE_ENGINE_MAX_VERTICES);
+        for (int i = 0; i < zone->vertex_count; i++) {
+            // Alternate long/short spokes for a concave outline
+            double angle = 2.0 * M_PI * i / zone->vertex_count;
+            int32_t r = (i & 1) ? radius / 2 + rand_range(0, radius / 4) : radius;
+            zone->x_mm[i] = (int16_t)(cx + (int32_t)lround(r * cos(angle)));
+            zone->y_mm[i] = (int16_t)(cy + (int32_t)lround(r * sin(angle)));
+        }
+
+        zone->prism = (z & 1) != 0;
+        zone->z_min_mm = (int16_t)rand_range(0, 1000);
+        zone->z_max_mm = (int16_t)(zone->z_min_mm + rand_range(300, 1500));
+    }
+}
+
+static void make_frames(void) {
+    for (int f = 0; f < BENCH_FRAME_POOL; f++) {
+        for (int t = 0; t < HLK_MAX_TARGETS; t++) {
+            hlk_target_t *target = &g_frames[f][t];
+            memset(target, 0, sizeof(*target));
+            // Slightly wider than the index so the outside-grid path runs too
+            target->x = HLK_COORD_FROM_MM(rand_range(-3500, 3500));
+            target->y = HLK_COORD_FROM_MM(rand_range(-3500, 3500));
+            target->z = HLK_COORD_FROM_MM(rand_range(0, 2500));
+        }
+    }
+}
+
+// ========== REFERENCE ==========
+
+// Same crossing rule as the engine, applied to every zone with no index
+static bool reference_contains(const zone_engine_zone_t *zone, int32_t px, int32_t py, int32_t pz) {
+    if (zone->prism && (pz < zone->z_min_mm || pz > zone->z_max_mm)) return false;
+    bool inside = false;
+    for (int i = 0, j = zone->vertex_count - 1; i < zone->vertex_count; j = i++) {
+        int64_t xi = zone->x_mm[i], yi = zone->y_mm[i];
+        int64_t xj = zone->x_mm[j], yj = zone->y_mm[j];
+        if ((yi > py) != (yj > py)) {
+            int64_t lhs = (px - xi) * (yj - yi);
+            int64_t rhs = (xj - xi) * (py - yi);
+            if (yj > yi ? lhs < rhs : lhs > rhs) inside = !inside;
+        }
+    }
+    return inside;
+}
+
+static int verify_frame(const hlk_target_t *targets, int count, int zone_count) {
+    uint16_t counts[ZONE_ENGINE_MAX_ZONES];
+    zone_engine_get_counts(counts, ZONE_ENGINE_MAX_ZONES);
+
+    for (int z = 0; z < zone_count; z++) {
+        uint16_t expected = 0;
+        for (int t = 0; t < count; t++) {
+            expected += reference_contains(&g_zones[z], HLK_COORD_TO_MM(targets[t].x),
+                                           HLK_COORD_TO_MM(targets[t].y), HLK_COORD_TO_MM(targets[t].z));
+        }
+        if (counts[z] != expected) {
+            fprintf(stderr, "zone %d: engine counted %u, reference %u\n", z, counts[z], expected);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// ========== BENCHMARK ==========
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int run_case(int zone_count, int target_count, double seconds) {
+    if (zone_engine_set_zones(g_zones, zone_count) != ESP_OK) {
+        fprintf(stderr, "%d zones rejected\n", zone_count);
+        return 1;
+    }
+
+    // Correctness pass over the whole frame pool
+    for (int f = 0; f < BENCH_FRAME_POOL; f++) {
+        zone_engine_evaluate(g_frames[f], target_count);
+        if (verify_frame(g_frames[f], target_count, zone_count)) return 1;
+    }
+
+    zone_engine_stats_t before;
+    zone_engine_get_stats(&before);
+
+    uint64_t frames = 0;
+    uint64_t cycles = 0;
+    double start = now_seconds();
+    double elapsed;
+    do {
+        for (int f = 0; f < BENCH_FRAME_POOL; f++) {
+            uint32_t c0 = hlk_port_cycles();
+            zone_engine_evaluate(g_frames[f], target_count);
+            cycles += hlk_port_cycles() - c0;
+        }
+        frames += BENCH_FRAME_POOL;
+        elapsed = now_seconds() - start;
+    } while (elapsed < seconds);
+
+    zone_engine_stats_t after;
+    zone_engine_get_stats(&after);
+    uint32_t targets = after.targets - before.targets;
+    double ns_per_frame = elapsed * 1e9 / (double)frames;
+
+    printf("%4d zones %3d targets %9.0f ns/frame %7.1f ns/target %8.0f cycles/frame  "
+           "%5.2f exact tests/target  %.4f%% of a %d ms frame\n",
+           zone_count, target_count, ns_per_frame, ns_per_frame / target_count,
+           (double)cycles / (double)frames,
+           (double)(after.exact_tests - before.exact_tests) / (targets ? targets : 1),
+           ns_per_frame / (BENCH_FRAME_PERIOD_MS * 1e4), BENCH_FRAME_PERIOD_MS);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    double seconds = argc > 1 ? atof(argv[1]) : 0.5;
+
+    srand(1);
+    zone_engine_init();
+    make_zones(ZONE_ENGINE_MAX_ZONES);
+    make_frames();
+
+    zone_engine_stats_t stats;
+    zone_engine_get_stats(&stats);
+    printf("Coordinates: %s, index %dx%d cells of %d mm, %lu bytes\n",
+           HLK_FIXED_POINT ? "fixed-point (int32 mm)" : "float (m)",
+           ZONE_ENGINE_GRID_W, ZONE_ENGINE_GRID_H, ZONE_ENGINE_CELL_MM,
+           (unsigned long)stats.memory_bytes);
+
+    int failures = 0;
+    for (size_t z = 0; z < sizeof(ZONE_CASES) / sizeof(ZONE_CASES[0]); z++) {
+        for (size_t t = 0; t < sizeof(TARGET_CASES) / sizeof(TARGET_CASES[0]); t++) {
+            failures += run_case(ZONE_CASES[z], TARGET_CASES[t], seconds);
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,176 @@
+// TinyFrame parser fuzz target
+// Built as a libFuzzer target with -DHLK_HOST_LIBFUZZER=ON, otherwise as a
+// replay/AFL driver that reads each file argument (or stdin) as one input.
+//
+// Input layout: byte 0 selects how the rest is delivered to the parser -
+// bit 7 set routes it through hlk_ld6002_process_bulk() and the host UART
+// port, otherwise it is fed directly in chunks of (byte0 & 0x7F) + 1 bytes.
+
+#include "hlk_ld6002.h"
+#include "hlk_port_host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Every decoded field is folded in here so the compiler cannot drop the reads
+static volatile uint32_t g_sink;
+
+static uint32_t coord_bits(hlk_coord_t value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static void on_target(const hlk_target_t* targets, int32_t count) {
+    for (int32_t i = 0; i < count; i++) {
+        g_sink ^= coord_bits(targets[i].x) ^ coord_bits(targets[i].y) ^ coord_bits(targets[i].z);
+        g_sink ^= (uint32_t)targets[i].velocity ^ (uint32_t)targets[i].cluster_id;
+        g_sink ^= coord_bits(hlk_calc_distance_3d(targets[i].x, targets[i].y, targets[i].z));
+    }
+}
+
+static void on_target_view(const hlk_target_view_t* view) {
+    for (int32_t i = 0; i < view->count; i++) {
+        g_sink ^= coord_bits(hlk_target_view_x(view, i));
+        g_sink ^= coord_bits(hlk_target_view_y(view, i));
+        g_sink ^= coord_bits(hlk_target_view_z(view, i));
+        g_sink ^= (uint32_t)hlk_target_view_velocity(view, i);
+        g_sink ^= (uint32_t)hlk_target_view_cluster_id(view, i);
+    }
+}
+
+static void on_presence(uint32_t zone0, uint32_t zone1, uint32_t zone2, uint32_t zone3) {
+    g_sink ^= zone0 ^ zone1 ^ zone2 ^ zone3;
+}
+
+static void on_zones(const hlk_zone_t* zones, bool is_interference) {
+    for (int i = 0; i < HLK_ZONE_COUNT; i++) {
+        g_sink ^= coord_bits(zones[i].x_min) ^ coord_bits(zones[i].z_max);
+    }
+    g_sink ^= is_interference;
+}
+
+static void on_zones_view(const hlk_zone_view_t* view) {
+    hlk_zone_t zone;
+    for (int i = 0; i < HLK_ZONE_COUNT; i++) {
+        hlk_zone_view_get(view, i, &zone);
+        g_sink ^= coord_bits(zone.y_min) ^ coord_bits(zone.y_max);
+    }
+}
+
+static void on_point_cloud(const hlk_point_cloud_t* cloud) {
+    for (int32_t i = 0; i < cloud->count; i++) {
+        g_sink ^= (uint32_t)cloud->cluster[i] ^ coord_bits(cloud->x[i]) ^ coord_bits(cloud->y[i]);
+        g_sink ^= coord_bits(cloud->z[i]) ^ coord_bits(cloud->speed[i]);
+    }
+}
+
+static void on_config(uint16_t msg_type, const uint8_t* data, uint16_t len) {
+    g_sink ^= msg_type;
+    for (uint16_t i = 0; i < len; i++) {
+        g_sink += data[i];
+    }
+}
+
+static const hlk_callbacks_t g_fuzz_callbacks = {
+    .on_target = on_target,
+    .on_presence = on_presence,
+    .on_zones = on_zones,
+    .on_config = on_config,
+    .on_target_view = on_target_view,
+    .on_zones_view = on_zones_view,
+    .on_point_cloud = on_point_cloud,
+};
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    static bool initialized = false;
+    if (!initialized) {
+        hlk_ld6002_init();
+        hlk_ld6002_register_callbacks(&g_fuzz_callbacks);
+        initialized = true;
+    }
+    
+    // Each input starts from a clean parser so crashes reproduce from one file
+    hlk_ld6002_reset();
+    if (size < 1) {
+        return 0;
+    }
+    
+    uint8_t mode = data[0];
+    data++;
+    size--;
+    
+    if (mode & 0x80) {
+        hlk_port_host_set_input(data, size);
+        while (hlk_ld6002_process_bulk(0, NULL) > 0) {
+        }
+    } else {
+        size_t chunk = (size_t)(mode & 0x7F) + 1;
+        while (size > 0) {
+            size_t n = size < chunk ? size : chunk;
+            hlk_ld6002_feed(data, n);
+            data += n;
+            size -= n;
+        }
+    }
+    
+    return 0;
+}
+
+#ifndef HLK_LIBFUZZER
+
+static int run_stream(FILE *f, const char *name) {
+    size_t cap = 4096;
+    size_t len = 0;
+    uint8_t *buf = malloc(cap);
+    if (!buf) {
+        return 1;
+    }
+    
+    size_t n;
+    while ((n = fread(&buf[len], 1, cap - len, f)) > 0) {
+        len += n;
+        if (len == cap) {
+            uint8_t *grown = realloc(buf, cap * 2);
+            if (!grown) {
+                free(buf);
+                return 1;
+            }
+            buf = grown;
+            cap *= 2;
+        }
+    }
+    
+    LLVMFuzzerTestOneInput(buf, len);
+    
+    hlk_parser_stats_t stats;
+    hlk_ld6002_get_parser_stats(&stats);
+    printf("%s: %zu bytes, %lu frames, %lu rejected, %lu resyncs\n", name, len,
+           (unsigned long)stats.frames, (unsigned long)stats.rejected_frames,
+           (unsigned long)stats.resyncs);
+    
+    free(buf);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        return run_stream(stdin, "<stdin>");
+    }
+    
+    for (int i = 1; i < argc; i++) {
+        FILE *f = fopen(argv[i], "rb");
+        if (!f) {
+            perror(argv[i]);
+            return 1;
+        }
+        int rc = run_stream(f, argv[i]);
+        fclose(f);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+    return 0;
+}
+
+#endif // HLK_LIBFUZZER
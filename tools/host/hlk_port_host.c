@@ -0,0 +1,151 @@
+// HLK-LD6002 Platform Port - Host Implementation
+
+#include "hlk_port_host.h"
+#include "esp_log.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define HOST_TX_CAPTURE_SIZE 4096
+
+esp_log_level_t hlk_host_log_level = ESP_LOG_NONE;
+
+static struct {
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+    uint32_t pending_events;
+    bool overflow;
+} g_rx = {0};
+
+static uint8_t g_tx[HOST_TX_CAPTURE_SIZE];
+static size_t g_tx_len = 0;
+
+void hlk_host_log(esp_log_level_t level, const char *tag, const char *fmt, ...) {
+    static const char levels[] = "-EWIDV";
+    va_list args;
+    
+    fprintf(stderr, "%c (%s) ", levels[level], tag);
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+// ========== TEST CONTROL ==========
+
+void hlk_port_host_set_input(const uint8_t *data, size_t len) {
+    g_rx.data = data;
+    g_rx.len = len;
+    g_rx.pos = 0;
+    g_rx.pending_events = len > 0 ? 1 : 0;
+}
+
+void hlk_port_host_inject_overflow(void) {
+    g_rx.overflow = true;
+}
+
+const uint8_t* hlk_port_host_tx(size_t *len) {
+    *len = g_tx_len;
+    return g_tx;
+}
+
+void hlk_port_host_clear_tx(void) {
+    g_tx_len = 0;
+}
+
+// ========== PORT IMPLEMENTATION ==========
+
+esp_err_t hlk_port_uart_init(void) {
+    memset(&g_rx, 0, sizeof(g_rx));
+    g_tx_len = 0;
+    return ESP_OK;
+}
+
+hlk_port_event_t hlk_port_uart_wait(uint32_t timeout_ms) {
+    (void)timeout_ms;  // Never blocks - input is either there or it is not
+    
+    if (g_rx.overflow) {
+        g_rx.overflow = false;
+        g_rx.pos = g_rx.len;
+        g_rx.pending_events = 0;
+        return HLK_PORT_EVENT_OVERFLOW;
+    }
+    if (g_rx.pending_events > 0) {
+        g_rx.pending_events--;
+        return HLK_PORT_EVENT_DATA;
+    }
+    return HLK_PORT_EVENT_NONE;
+}
+
+size_t hlk_port_uart_buffered(void) {
+    return g_rx.len - g_rx.pos;
+}
+
+int hlk_port_uart_read(uint8_t *buf, size_t len) {
+    size_t available = g_rx.len - g_rx.pos;
+    if (len > available) {
+        len = available;
+    }
+    if (len == 0) {
+        return 0;
+    }
+    memcpy(buf, &g_rx.data[g_rx.pos], len);
+    g_rx.pos += len;
+    return (int)len;
+}
+
+int hlk_port_uart_write(const uint8_t *buf, size_t len) {
+    size_t space = sizeof(g_tx) - g_tx_len;
+    size_t n = len < space ? len : space;
+    memcpy(&g_tx[g_tx_len], buf, n);
+    g_tx_len += n;
+    return (int)len;
+}
+
+uint32_t hlk_port_millis(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+uint32_t hlk_port_micros(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+
+uint32_t hlk_port_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    // No portable cycle counter - nanoseconds stand in
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ull + ts.tv_nsec);
+#endif
+}
+
+hlk_port_mutex_t hlk_port_mutex_create(void) {
+    pthread_mutex_t *mutex = malloc(sizeof(*mutex));
+    if (mutex && pthread_mutex_init(mutex, NULL) != 0) {
+        free(mutex);
+        mutex = NULL;
+    }
+    return mutex;
+}
+
+void hlk_port_mutex_lock(hlk_port_mutex_t mutex) {
+    if (mutex) pthread_mutex_lock((pthread_mutex_t *)mutex);
+}
+
+void hlk_port_mutex_unlock(hlk_port_mutex_t mutex) {
+    if (mutex) pthread_mutex_unlock((pthread_mutex_t *)mutex);
+}
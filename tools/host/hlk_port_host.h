@@ -0,0 +1,45 @@
+// HLK-LD6002 Platform Port - Host Implementation
+// In-memory UART: received bytes come from a caller-supplied buffer,
+// transmitted bytes are captured for inspection
+
+#ifndef HLK_PORT_HOST_H
+#define HLK_PORT_HOST_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "hlk_port.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Set the bytes the next hlk_port_uart_read() calls will return
+ * Queues a single RX data event. The buffer is not copied.
+ * @param data Received byte stream
+ * @param len Number of bytes
+ */
+void hlk_port_host_set_input(const uint8_t *data, size_t len);
+
+/**
+ * Make the next hlk_port_uart_wait() report an RX overflow and drop pending input
+ */
+void hlk_port_host_inject_overflow(void);
+
+/**
+ * Get bytes written through hlk_port_uart_write() since the last clear
+ * @param len Number of captured bytes (output)
+ * @return Captured bytes
+ */
+const uint8_t* hlk_port_host_tx(size_t *len);
+
+/**
+ * Clear the transmit capture buffer
+ */
+void hlk_port_host_clear_tx(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HLK_PORT_HOST_H
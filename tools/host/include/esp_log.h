@@ -0,0 +1,36 @@
+// Host stand-in for ESP-IDF esp_log.h
+// Messages at or below hlk_host_log_level are printed to stderr (default: none)
+
+#ifndef HOST_ESP_LOG_H
+#define HOST_ESP_LOG_H
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+extern esp_log_level_t hlk_host_log_level;
+
+void hlk_host_log(esp_log_level_t level, const char *tag, const char *fmt, ...);
+
+#define HOST_LOG(level, tag, fmt, ...) do {                         \
+        if (hlk_host_log_level >= (level)) {                        \
+            hlk_host_log((level), (tag), (fmt), ##__VA_ARGS__);     \
+        }                                                           \
+    } while (0)
+
+#define ESP_LOGE(tag, fmt, ...) HOST_LOG(ESP_LOG_ERROR, tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) HOST_LOG(ESP_LOG_WARN, tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) HOST_LOG(ESP_LOG_INFO, tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) HOST_LOG(ESP_LOG_DEBUG, tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) HOST_LOG(ESP_LOG_VERBOSE, tag, fmt, ##__VA_ARGS__)
+
+#define ESP_LOG_BUFFER_HEX_LEVEL(tag, buffer, len, level) do {    \
+        (void)(tag); (void)(buffer); (void)(len); (void)(level);    \
+    } while (0)
+
+#endif // HOST_ESP_LOG_H
@@ -0,0 +1,147 @@
+// Command pipeline test harness
+// Feeds radar answers through the parser (on_frame -> cmd_pipeline_on_frame)
+// and checks how commands complete: an 8-byte ACK directly followed by its
+// report, a set answered by its ACK alone, and a report that overtakes its
+// ACK so the late ACK must not complete the next command.
+//
+// Usage: test_cmd_pipeline
+
+#include "cmd_pipeline.h"
+#include "hlk_port_host.h"
+#include <stdio.h>
+#include <string.h>
+
+static int g_failures = 0;
+
+// ========== HELPERS ==========
+
+static uint8_t cksum(const uint8_t *p, size_t len) {
+    uint8_t c = 0;
+    for (size_t i = 0; i < len; i++) {
+        c ^= p[i];
+    }
+    return ~c;
+}
+
+// Append one radar frame; LEN 0 frames end at HEAD_CKSUM
+static size_t put_frame(uint8_t *out, uint16_t type, const uint8_t *data, uint16_t len) {
+    out[0] = 0x01;
+    out[1] = 0x80;  // Peer bit: radar → host
+    out[2] = 0x00;
+    out[3] = len >> 8;
+    out[4] = len & 0xFF;
+    out[5] = type >> 8;
+    out[6] = type & 0xFF;
+    out[7] = cksum(out, 7);
+    if (len == 0) {
+        return 8;
+    }
+    memcpy(&out[8], data, len);
+    out[8 + len] = cksum(data, len);
+    return 8 + len + 1;
+}
+
+static size_t put_ack(uint8_t *out) {
+    return put_frame(out, MSG_CFG_HUMAN_DETECTION_3D, NULL, 0);
+}
+
+static size_t put_report(uint8_t *out, uint16_t type, uint8_t value) {
+    uint8_t data[4] = { value, 0, 0, 0 };
+    return put_frame(out, type, data, sizeof(data));
+}
+
+static void reset(void) {
+    hlk_ld6002_reset();
+    cmd_pipeline_init();
+    hlk_port_host_clear_tx();
+}
+
+static void expect(const char *scenario, uint32_t frames, uint32_t completed, uint32_t stale_acks) {
+    hlk_parser_stats_t parser;
+    cmd_pipeline_stats_t pipe;
+    hlk_ld6002_get_parser_stats(&parser);
+    cmd_pipeline_get_stats(&pipe);
+    if (parser.frames != frames || pipe.completed != completed || pipe.stale_acks != stale_acks ||
+        pipe.retries != 0 || pipe.failed != 0) {
+        printf("FAIL: %s - %lu frames, %lu completed, %lu stale ACKs, %lu retries, %lu failed "
+               "(expected %lu, %lu, %lu, 0, 0)\n", scenario,
+               (unsigned long)parser.frames, (unsigned long)pipe.completed, (unsigned long)pipe.stale_acks,
+               (unsigned long)pipe.retries, (unsigned long)pipe.failed,
+               (unsigned long)frames, (unsigned long)completed, (unsigned long)stale_acks);
+        g_failures++;
+    } else {
+        printf("ok:   %s\n", scenario);
+    }
+}
+
+// ========== SCENARIOS ==========
+
+static void test_ack_then_report(void) {
+    uint8_t rx[64];
+    size_t len = 0;
+
+    reset();
+    cmd_pipeline_submit(CMD_GET_SENSITIVITY, CMD_PIPELINE_DEFAULT_TIMEOUT_MS, 0);
+    cmd_pipeline_poll();
+
+    // The report follows the 8-byte ACK with no gap
+    len += put_ack(&rx[len]);
+    len += put_report(&rx[len], MSG_IND_HUMAN_DETECTION_3D_DETECT_SENSITIVITY, 2);
+    hlk_ld6002_feed(rx, len);
+    cmd_pipeline_poll();
+
+    expect("GET answered by ACK + report", 2, 1, 0);
+    if (!cmd_pipeline_idle()) {
+        printf("FAIL: pipeline not idle after the report\n");
+        g_failures++;
+    }
+}
+
+static void test_set_acked(void) {
+    uint8_t rx[16];
+
+    reset();
+    cmd_pipeline_submit(CMD_SET_SENSITIVITY_HIGH, CMD_PIPELINE_DEFAULT_TIMEOUT_MS, 0);
+    cmd_pipeline_poll();
+    hlk_ld6002_feed(rx, put_ack(rx));
+    cmd_pipeline_poll();
+
+    expect("SET answered by its ACK", 1, 1, 0);
+}
+
+static void test_report_before_ack(void) {
+    uint8_t rx[64];
+    size_t len = 0;
+
+    reset();
+    cmd_pipeline_submit(CMD_GET_TRIGGER_SPEED, CMD_PIPELINE_DEFAULT_TIMEOUT_MS, 0);
+    cmd_pipeline_submit(CMD_SET_SENSITIVITY_LOW, CMD_PIPELINE_DEFAULT_TIMEOUT_MS, 0);
+    cmd_pipeline_poll();
+
+    // The GET's report overtakes its ACK; that ACK must not complete the SET
+    len += put_report(&rx[len], MSG_IND_HUMAN_DETECTION_3D_DETECT_TRIGGER, 1);
+    len += put_ack(&rx[len]);
+    hlk_ld6002_feed(rx, len);
+    cmd_pipeline_poll();
+    expect("late ACK of a completed GET is dropped", 2, 1, 1);
+
+    hlk_ld6002_feed(rx, put_ack(rx));
+    cmd_pipeline_poll();
+    expect("SET completes on its own ACK", 3, 2, 1);
+}
+
+int main(void) {
+    static const hlk_callbacks_t callbacks = {
+        .on_frame = cmd_pipeline_on_frame,
+    };
+
+    hlk_ld6002_init();
+    hlk_ld6002_register_callbacks(&callbacks);
+
+    test_ack_then_report();
+    test_set_acked();
+    test_report_before_ack();
+
+    printf("%s (%d failure%s)\n", g_failures ? "FAILED" : "PASSED", g_failures, g_failures == 1 ? "" : "s");
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,232 @@
+// Tripwire test harness
+// Walks synthetic tracks across a set of lines and checks the in/out counters
+// after each scenario: clean crossings both ways, misses past a line end,
+// walking along and touching a line, jitter on the line, several tracks at
+// once, ID-swap jumps and untracked targets.
+//
+// Usage: test_tripwire
+
+#include "tripwire.h"
+#include <stdio.h>
+#include <string.h>
+
+#define STEP_MM 100   // Walking speed per frame in the synthetic paths
+
+static int g_failures = 0;
+
+// ========== HELPERS ==========
+
+static hlk_target_t make_target(uint16_t track_id, int32_t x_mm, int32_t y_mm) {
+    hlk_target_t target;
+    memset(&target, 0, sizeof(target));
+    target.track_id = track_id;
+    target.x = HLK_COORD_FROM_MM(x_mm);
+    target.y = HLK_COORD_FROM_MM(y_mm);
+    target.z = HLK_COORD_FROM_MM(1200);
+    return target;
+}
+
+// One track walking in a straight line, one frame per STEP_MM
+static int walk(uint16_t track_id, int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    int32_t dx = x1 - x0, dy = y1 - y0;
+    int32_t len = (dx < 0 ? -dx : dx) > (dy < 0 ? -dy : dy) ? (dx < 0 ? -dx : dx) : (dy < 0 ? -dy : dy);
+    int steps = len / STEP_MM > 0 ? len / STEP_MM : 1;
+    int crossings = 0;
+    for (int i = 0; i <= steps; i++) {
+        hlk_target_t target = make_target(track_id, x0 + dx * i / steps, y0 + dy * i / steps);
+        crossings += tripwire_update(&target, 1, NULL, 0);
+    }
+    return crossings;
+}
+
+static void empty_frame(void) {
+    tripwire_update(NULL, 0, NULL, 0);
+}
+
+static void set_door(void) {
+    // Door line along X at y = 1000, A→B pointing -X: walking towards the
+    // sensor (decreasing y) goes right→left of A→B, i.e. "in"
+    tripwire_line_t lines[2];
+    memset(lines, 0, sizeof(lines));
+    strcpy(lines[0].name, "door");
+    lines[0].ax_mm = 500;
+    lines[0].ay_mm = 1000;
+    lines[0].bx_mm = -500;
+    lines[0].by_mm = 1000;
+    // Diagonal line elsewhere: left of A→B is the x > y half
+    strcpy(lines[1].name, "hall");
+    lines[1].ax_mm = 2500;
+    lines[1].ay_mm = 2500;
+    lines[1].bx_mm = 1500;
+    lines[1].by_mm = 1500;
+    if (tripwire_set_lines(lines, 2) != ESP_OK) {
+        printf("FAIL: lines rejected\n");
+        g_failures++;
+    }
+    empty_frame();
+}
+
+static void expect(const char *scenario, int line, uint32_t in, uint32_t out) {
+    tripwire_counts_t counts[TRIPWIRE_MAX_LINES];
+    tripwire_get_lines(NULL, counts, TRIPWIRE_MAX_LINES);
+    if (counts[line].in != in || counts[line].out != out) {
+        printf("FAIL: %s: line %d in/out %lu/%lu, expected %lu/%lu\n", scenario, line,
+               (unsigned long)counts[line].in, (unsigned long)counts[line].out,
+               (unsigned long)in, (unsigned long)out);
+        g_failures++;
+    } else {
+        printf("ok:   %s\n", scenario);
+    }
+}
+
+// ========== SCENARIOS ==========
+
+static void test_basic_crossings(void) {
+    set_door();
+    walk(1, 0, 2000, 0, 0);
+    expect("walk in through the door", 0, 1, 0);
+    empty_frame();
+    walk(2, 100, 0, -100, 2000);
+    expect("walk out through the door", 0, 1, 1);
+    expect("other line untouched", 1, 0, 0);
+
+    empty_frame();
+    walk(3, 1500, 2500, 2500, 1500);
+    expect("diagonal line crossed in", 1, 1, 0);
+}
+
+static void test_misses(void) {
+    set_door();
+    walk(1, 700, 2000, 700, 0);
+    expect("pass beyond the line end", 0, 0, 0);
+    empty_frame();
+    walk(2, -2000, 1000, 2000, 1000);
+    expect("walk along the line", 0, 0, 0);
+    empty_frame();
+    walk(3, 0, 2000, 0, 1000);
+    walk(3, 0, 1000, 0, 2000);
+    expect("touch the line and turn back", 0, 0, 0);
+}
+
+static void test_endpoint(void) {
+    set_door();
+    walk(1, 500, 2000, 500, 0);
+    expect("cross exactly through endpoint A", 0, 1, 0);
+    empty_frame();
+    walk(2, -2000, 1000, -600, 1000);
+    walk(2, -600, 1000, -600, 0);
+    expect("step off the line's extension beyond B", 0, 1, 0);
+}
+
+static void test_jitter(void) {
+    set_door();
+    // Standing in the doorway, position wobbling 30 mm around the line
+    static const int32_t wobble[] = { 1020, 990, 1005, 980, 1000, 1030, 970, 990 };
+    int crossings = 0;
+    for (int i = 0; i < 8; i++) {
+        hlk_target_t target = make_target(1, 0, wobble[i]);
+        crossings += tripwire_update(&target, 1, NULL, 0);
+    }
+    // Each real side change counts, and ins and outs alternate
+    tripwire_counts_t counts[TRIPWIRE_MAX_LINES];
+    tripwire_get_lines(NULL, counts, TRIPWIRE_MAX_LINES);
+    int32_t net = (int32_t)counts[0].in - (int32_t)counts[0].out;
+    if ((uint32_t)crossings != counts[0].in + counts[0].out || net != 1) {
+        printf("FAIL: jitter: %d crossings, in/out %lu/%lu (net should be 1: ends inside)\n",
+               crossings, (unsigned long)counts[0].in, (unsigned long)counts[0].out);
+        g_failures++;
+    } else {
+        printf("ok:   jitter around the line nets one entry\n");
+    }
+}
+
+static void test_multiple_tracks(void) {
+    set_door();
+    // Three people walk in side by side while one walks out
+    hlk_target_t frame[4];
+    tripwire_event_t events[8];
+    int reported = 0;
+    for (int i = 0; i <= 20; i++) {
+        int32_t y = 2000 - i * STEP_MM;
+        frame[0] = make_target(10, -300, y);
+        frame[1] = make_target(11, 0, y);
+        frame[2] = make_target(12, 300, y);
+        frame[3] = make_target(13, 200, 2000 - y);
+        int n = tripwire_update(frame, 4, events, 8);
+        for (int e = 0; e < n; e++) {
+            if (events[e].line != 0 || strcmp(events[e].name, "door") != 0 ||
+                (events[e].in != (events[e].track_id != 13))) {
+                printf("FAIL: multiple tracks: track %u reported %s on line %u\n",
+                       events[e].track_id, events[e].in ? "in" : "out", events[e].line);
+                g_failures++;
+            }
+        }
+        reported += n;
+    }
+    expect("three in, one out at once", 0, 3, 1);
+    if (reported != 4) {
+        printf("FAIL: multiple tracks: %d events reported\n", reported);
+        g_failures++;
+    }
+}
+
+static void test_jumps_and_untracked(void) {
+    set_door();
+    // Track ID handed to someone on the other side: a 2 m teleport
+    hlk_target_t target = make_target(1, 0, 2000);
+    tripwire_update(&target, 1, NULL, 0);
+    target = make_target(1, 0, 0);
+    tripwire_update(&target, 1, NULL, 0);
+    expect("track ID jump across the line ignored", 0, 0, 0);
+
+    empty_frame();
+    walk(0, 0, 2000, 0, 0);
+    expect("untracked targets never count", 0, 0, 0);
+
+    // Track lost for a frame: no stale position, so no crossing
+    empty_frame();
+    target = make_target(2, 0, 1100);
+    tripwire_update(&target, 1, NULL, 0);
+    empty_frame();
+    target = make_target(2, 0, 900);
+    tripwire_update(&target, 1, NULL, 0);
+    expect("track missing for a frame starts afresh", 0, 0, 0);
+
+    tripwire_stats_t stats;
+    tripwire_get_stats(&stats);
+    if (stats.jumps_ignored == 0 || stats.untracked == 0) {
+        printf("FAIL: stats: %lu jumps, %lu untracked\n",
+               (unsigned long)stats.jumps_ignored, (unsigned long)stats.untracked);
+        g_failures++;
+    }
+}
+
+static void test_validation(void) {
+    tripwire_line_t line;
+    memset(&line, 0, sizeof(line));
+    line.ax_mm = line.bx_mm = 100;
+    line.ay_mm = line.by_mm = 200;
+    if (tripwire_set_lines(&line, 1) != ESP_ERR_INVALID_ARG ||
+        tripwire_set_lines(&line, TRIPWIRE_MAX_LINES + 1) != ESP_ERR_INVALID_ARG) {
+        printf("FAIL: degenerate line or too many lines accepted\n");
+        g_failures++;
+    } else {
+        printf("ok:   invalid definitions rejected\n");
+    }
+}
+
+int main(void) {
+    tripwire_init();
+    printf("Coordinates: %s\n", HLK_FIXED_POINT ? "fixed-point (int32 mm)" : "float (m)");
+
+    test_basic_crossings();
+    test_misses();
+    test_endpoint();
+    test_jitter();
+    test_multiple_tracks();
+    test_jumps_and_untracked();
+    test_validation();
+
+    printf("%s (%d failure%s)\n", g_failures ? "FAILED" : "PASSED", g_failures, g_failures == 1 ? "" : "s");
+    return g_failures ? 1 : 0;
+}